@@ -0,0 +1,136 @@
+#include "ftfp.h"
+#include "internal.h"
+
+// Contains the elementwise (_array) versions of the core arithmetic.
+
+/* Each loop body is one of the inline helpers from internal.h, which are
+ * straight-line and branch-free, so the compiler can vectorize across elements
+ * (the Makefile builds this file with -O3 for that). result may alias the
+ * inputs exactly, but shouldn't otherwise overlap them.
+ *
+ * Where there's a hand-written kernel in array_avx2.c or array_avx512.c, we
+ * use the widest one the CPU can run. */
+
+void fix_cmp_array(int8_t* result, const fixed* op1, const fixed* op2, size_t n) {
+  FIX_USE_AVX2(fix_cmp_array_avx2(result, op1, op2, n));
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_cmp_inline(op1[i], op2[i]);
+  }
+}
+
+void fix_neg_array(fixed* result, const fixed* op1, size_t n) {
+  FIX_USE_AVX2(fix_neg_array_avx2(result, op1, n));
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_neg_inline(op1[i]);
+  }
+}
+
+void fix_abs_array(fixed* result, const fixed* op1, size_t n) {
+  FIX_USE_AVX2(fix_abs_array_avx2(result, op1, n));
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_abs_inline(op1[i]);
+  }
+}
+
+void fix_add_array(fixed* result, const fixed* op1, const fixed* op2, size_t n) {
+  FIX_USE_AVX2(fix_add_array_avx2(result, op1, op2, n));
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_add_inline(op1[i], op2[i]);
+  }
+}
+
+void fix_sub_array(fixed* result, const fixed* op1, const fixed* op2, size_t n) {
+  FIX_USE_AVX2(fix_sub_array_avx2(result, op1, op2, n));
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_add_inline(op1[i], fix_neg_inline(op2[i]));
+  }
+}
+
+void fix_mul_array(fixed* result, const fixed* op1, const fixed* op2, size_t n) {
+  FIX_USE_IFMA(fix_mul_array_ifma(result, op1, op2, n));
+  FIX_USE_AVX2(fix_mul_array_avx2(result, op1, op2, n));
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_mul_inline(op1[i], op2[i]);
+  }
+}
+
+/* fix_div's 64 rounds of long division would be the inner loop, and that
+ * doesn't vectorize, so we run them on a block of elements at once, with the
+ * elements innermost. */
+#define FIX_ARRAY_BLOCK 32
+
+FIX_INLINE void fix_div_block(fixed* result, const fixed* op1, const fixed* op2, size_t n) {
+  fixed x[FIX_ARRAY_BLOCK];
+  fixed y[FIX_ARRAY_BLOCK];
+  uint64_t acc[FIX_ARRAY_BLOCK];
+  uint64_t base[FIX_ARRAY_BLOCK];
+  uint64_t q[FIX_ARRAY_BLOCK];
+  int64_t shiftamount[FIX_ARRAY_BLOCK];
+
+  for(size_t j = 0; j < FIX_ARRAY_BLOCK; j++) {
+    x[j] = op1[j < n ? j : 0];
+    y[j] = op2[j < n ? j : 0];
+    q[j] = 0;
+    fix_div_64_start(x[j], y[j], &acc[j], &base[j], &shiftamount[j]);
+  }
+
+  for(int i = 63; i >= 0; i--) {
+    for(size_t j = 0; j < FIX_ARRAY_BLOCK; j++) {
+      fix_div_64_round(&acc[j], &base[j], &q[j]);
+    }
+  }
+
+  for(size_t j = 0; j < FIX_ARRAY_BLOCK; j++) {
+    uint64_t isinf;
+    q[j] = fix_div_64_finish(x[j], y[j], q[j], shiftamount[j], &isinf);
+    q[j] = fix_div_special(x[j], y[j], q[j], isinf);
+  }
+
+  for(size_t j = 0; j < n; j++) {
+    result[j] = q[j];
+  }
+}
+
+void fix_div_array(fixed* result, const fixed* op1, const fixed* op2, size_t n) {
+  for(size_t i = 0; i < n; i += FIX_ARRAY_BLOCK) {
+    size_t b = n - i < FIX_ARRAY_BLOCK ? n - i : FIX_ARRAY_BLOCK;
+    fix_div_block(result + i, op1 + i, op2 + i, b);
+  }
+}
+
+/* The same, with op2 the same for every element. */
+
+void fix_add_scalar_array(fixed* result, const fixed* op1, fixed op2, size_t n) {
+  FIX_USE_AVX2(fix_add_scalar_array_avx2(result, op1, op2, n));
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_add_inline(op1[i], op2);
+  }
+}
+
+void fix_sub_scalar_array(fixed* result, const fixed* op1, fixed op2, size_t n) {
+  fixed negop2 = fix_neg_inline(op2);
+  FIX_USE_AVX2(fix_add_scalar_array_avx2(result, op1, negop2, n));
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_add_inline(op1[i], negop2);
+  }
+}
+
+void fix_mul_scalar_array(fixed* result, const fixed* op1, fixed op2, size_t n) {
+  FIX_USE_IFMA(fix_mul_scalar_array_ifma(result, op1, op2, n));
+  FIX_USE_AVX2(fix_mul_scalar_array_avx2(result, op1, op2, n));
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_mul_inline(op1[i], op2);
+  }
+}
+
+void fix_div_scalar_array(fixed* result, const fixed* op1, fixed op2, size_t n) {
+  fixed k[FIX_ARRAY_BLOCK];
+  for(size_t j = 0; j < FIX_ARRAY_BLOCK; j++) {
+    k[j] = op2;
+  }
+
+  for(size_t i = 0; i < n; i += FIX_ARRAY_BLOCK) {
+    size_t b = n - i < FIX_ARRAY_BLOCK ? n - i : FIX_ARRAY_BLOCK;
+    fix_div_block(result + i, op1 + i, k, b);
+  }
+}
@@ -0,0 +1,482 @@
+#include "ftfp.h"
+#include "internal.h"
+
+// Contains the AVX2 kernels for the _array functions in array.c, and for the
+// stages of fix_exp_array and the log arrays in power.c.
+
+#if FIX_X86_SIMD
+
+#include <immintrin.h>
+
+/* These follow the scalar code in internal.h line for line, 4 elements at a
+ * time. Flags are whole-lane masks (all ones or all zeros) instead of 0 or 1,
+ * so MASK_UNLESS becomes an and, and !x an andnot. Like the scalar code, none
+ * of it branches on, or indexes memory with, the data. Elements left over
+ * after the last group of 4 go through the scalar code. */
+
+FIX_INLINE FIX_AVX2 __m256i fix_avx2_set(uint64_t x) {
+  return _mm256_set1_epi64x((int64_t) x);
+}
+
+FIX_INLINE FIX_AVX2 __m256i fix_avx2_load(const fixed* p) {
+  return _mm256_loadu_si256((const __m256i*) p);
+}
+
+FIX_INLINE FIX_AVX2 void fix_avx2_store(fixed* p, __m256i x) {
+  _mm256_storeu_si256((__m256i*) p, x);
+}
+
+// (f & FIX_FLAGS_MASK) == flag
+FIX_INLINE FIX_AVX2 __m256i fix_avx2_is_flag(__m256i f, fixed flag) {
+  return _mm256_cmpeq_epi64(_mm256_and_si256(f, fix_avx2_set(FIX_FLAGS_MASK)),
+      fix_avx2_set(flag));
+}
+
+// FIX_IS_NEG, as a mask.
+FIX_INLINE FIX_AVX2 __m256i fix_avx2_is_neg(__m256i f) {
+  return _mm256_cmpgt_epi64(_mm256_setzero_si256(), f);
+}
+
+// a > b, unsigned.
+FIX_INLINE FIX_AVX2 __m256i fix_avx2_gt_unsigned(__m256i a, __m256i b) {
+  __m256i top = fix_avx2_set(FIX_TOP_BIT_MASK);
+  return _mm256_cmpgt_epi64(_mm256_xor_si256(a, top), _mm256_xor_si256(b, top));
+}
+
+// ~a & b
+FIX_INLINE FIX_AVX2 __m256i fix_avx2_andnot(__m256i a, __m256i b) {
+  return _mm256_andnot_si256(a, b);
+}
+
+FIX_INLINE FIX_AVX2 __m256i fix_avx2_or(__m256i a, __m256i b) {
+  return _mm256_or_si256(a, b);
+}
+
+FIX_INLINE FIX_AVX2 __m256i fix_avx2_and(__m256i a, __m256i b) {
+  return _mm256_and_si256(a, b);
+}
+
+/* FIX_IF_NAN(isnan) | FIX_IF_INF_POS(isinfpos) | FIX_IF_INF_NEG(isinfneg) |
+ * FIX_DATA_BITS(data). The caller has already masked the infinities with
+ * !isnan. */
+FIX_INLINE FIX_AVX2 __m256i fix_avx2_combine(__m256i isnan, __m256i isinfpos,
+    __m256i isinfneg, __m256i data) {
+  return fix_avx2_or(
+      fix_avx2_or(fix_avx2_and(isnan, fix_avx2_set(FIX_NAN)),
+                  fix_avx2_and(isinfpos, fix_avx2_set(FIX_INF_POS))),
+      fix_avx2_or(fix_avx2_and(isinfneg, fix_avx2_set(FIX_INF_NEG)),
+                  fix_avx2_and(data, fix_avx2_set(FIX_DATA_BIT_MASK))));
+}
+
+FIX_INLINE FIX_AVX2 __m256i fix_avx2_cmp(__m256i op1, __m256i op2) {
+  __m256i nans = fix_avx2_or(fix_avx2_is_flag(op1, FIX_NAN), fix_avx2_is_flag(op2, FIX_NAN));
+
+  __m256i neg1 = fix_avx2_is_neg(op1);
+  __m256i neg2 = fix_avx2_is_neg(op2);
+
+  __m256i infpos1 = fix_avx2_is_flag(op1, FIX_INF_POS);
+  __m256i infpos2 = fix_avx2_is_flag(op2, FIX_INF_POS);
+  __m256i infneg1 = fix_avx2_is_flag(op1, FIX_INF_NEG);
+  __m256i infneg2 = fix_avx2_is_flag(op2, FIX_INF_NEG);
+
+  __m256i gt = fix_avx2_or(fix_avx2_andnot(infpos2, infpos1), fix_avx2_andnot(infneg1, infneg2));
+  __m256i lt = fix_avx2_or(fix_avx2_andnot(infpos1, infpos2), fix_avx2_andnot(infneg2, infneg1));
+
+  // pos1 & !pos2 is !neg1 & neg2.
+  gt = fix_avx2_or(gt, fix_avx2_andnot(lt, fix_avx2_andnot(neg1, neg2)));
+  lt = fix_avx2_or(lt, fix_avx2_andnot(gt, fix_avx2_andnot(neg2, neg1)));
+
+  __m256i cmp_gt = fix_avx2_gt_unsigned(op1, op2);
+  __m256i cmp_lt = fix_avx2_gt_unsigned(op2, op1);
+
+  __m256i one = fix_avx2_set(1);
+  __m256i minus_one = fix_avx2_set(~((uint64_t) 0));
+
+  __m256i ordered = fix_avx2_or(
+      fix_avx2_or(fix_avx2_and(gt, one), fix_avx2_and(lt, minus_one)),
+      fix_avx2_andnot(fix_avx2_or(gt, lt),
+        fix_avx2_or(fix_avx2_and(cmp_gt, one), fix_avx2_and(cmp_lt, minus_one))));
+
+  return fix_avx2_or(fix_avx2_and(nans, one), fix_avx2_andnot(nans, ordered));
+}
+
+FIX_INLINE FIX_AVX2 __m256i fix_avx2_neg(__m256i op1) {
+  __m256i isinfpos = fix_avx2_or(fix_avx2_is_flag(op1, FIX_INF_NEG),
+      _mm256_cmpeq_epi64(op1, fix_avx2_set(FIX_MIN)));
+  __m256i isinfneg = fix_avx2_is_flag(op1, FIX_INF_POS);
+  __m256i isnan = fix_avx2_is_flag(op1, FIX_NAN);
+
+  // 2s comp negate the data bits
+  __m256i tempresult = _mm256_add_epi64(fix_avx2_andnot(op1, fix_avx2_set(~((uint64_t) 0))),
+      fix_avx2_set(4));
+
+  return fix_avx2_combine(isnan, fix_avx2_andnot(isnan, isinfpos),
+      fix_avx2_andnot(isnan, isinfneg), tempresult);
+}
+
+FIX_INLINE FIX_AVX2 __m256i fix_avx2_abs(__m256i op1) {
+  __m256i isinf = fix_avx2_or(fix_avx2_is_flag(op1, FIX_INF_POS), fix_avx2_is_flag(op1, FIX_INF_NEG));
+  __m256i isnan = fix_avx2_is_flag(op1, FIX_NAN);
+  __m256i neg = fix_avx2_is_neg(op1);
+
+  __m256i negated = fix_avx2_and(
+      _mm256_add_epi64(fix_avx2_andnot(op1, fix_avx2_set(~((uint64_t) 0))), fix_avx2_set(4)),
+      fix_avx2_set(FIX_DATA_BIT_MASK));
+  __m256i tempresult = fix_avx2_or(fix_avx2_andnot(neg, op1), fix_avx2_and(neg, negated));
+
+  /* check for FIX_MIN */
+  __m256i ismin = fix_avx2_and(fix_avx2_andnot(isinf, neg), _mm256_cmpeq_epi64(op1, tempresult));
+
+  return fix_avx2_combine(isnan, fix_avx2_andnot(isnan, fix_avx2_or(isinf, ismin)),
+      _mm256_setzero_si256(), tempresult);
+}
+
+FIX_INLINE FIX_AVX2 __m256i fix_avx2_add(__m256i op1, __m256i op2) {
+  __m256i isnan = fix_avx2_or(fix_avx2_is_flag(op1, FIX_NAN), fix_avx2_is_flag(op2, FIX_NAN));
+  __m256i isinfpos = fix_avx2_or(fix_avx2_is_flag(op1, FIX_INF_POS), fix_avx2_is_flag(op2, FIX_INF_POS));
+  __m256i isinfneg = fix_avx2_or(fix_avx2_is_flag(op1, FIX_INF_NEG), fix_avx2_is_flag(op2, FIX_INF_NEG));
+
+  __m256i tempresult = _mm256_add_epi64(op1, op2);
+
+  __m256i neg1 = fix_avx2_is_neg(op1);
+  __m256i neg2 = fix_avx2_is_neg(op2);
+  __m256i negresult = fix_avx2_is_neg(tempresult);
+
+  // Two positives that add up to a negative, or two negatives to a positive.
+  isinfpos = fix_avx2_or(isinfpos, fix_avx2_andnot(fix_avx2_or(neg1, neg2), negresult));
+  isinfneg = fix_avx2_or(isinfneg, fix_avx2_andnot(negresult, fix_avx2_and(neg1, neg2)));
+
+  // Force infpos to win in cases where it is unclear
+  isinfneg = fix_avx2_andnot(isinfpos, isinfneg);
+
+  return fix_avx2_combine(isnan, fix_avx2_andnot(isnan, isinfpos),
+      fix_avx2_andnot(isnan, isinfneg), tempresult);
+}
+
+/* x * y as an unsigned 128-bit product, from 32x32 partial products, the same
+ * way UNSAFE_UNSIGNED_MUL_64_64_128 does it. */
+FIX_INLINE FIX_AVX2 void fix_avx2_umul_64_64_128(__m256i x, __m256i y,
+    __m256i* resultlow, __m256i* resulthigh) {
+  __m256i lowmask = fix_avx2_set(0xffffffff);
+
+  __m256i xhigh = _mm256_srli_epi64(x, 32);
+  __m256i yhigh = _mm256_srli_epi64(y, 32);
+
+  // _mm256_mul_epu32 only looks at the low 32 bits of each lane.
+  __m256i z0 = _mm256_mul_epu32(x, y);
+  __m256i z1 = _mm256_mul_epu32(x, yhigh);
+  __m256i z2 = _mm256_mul_epu32(xhigh, y);
+  __m256i z3 = _mm256_mul_epu32(xhigh, yhigh);
+
+  *resultlow = _mm256_add_epi64(z0,
+      _mm256_add_epi64(_mm256_slli_epi64(z1, 32), _mm256_slli_epi64(z2, 32)));
+  __m256i carry = _mm256_srli_epi64(_mm256_add_epi64(_mm256_srli_epi64(z0, 32),
+        _mm256_add_epi64(fix_avx2_and(z1, lowmask), fix_avx2_and(z2, lowmask))), 32);
+  *resulthigh = _mm256_add_epi64(_mm256_add_epi64(carry, z3),
+      _mm256_add_epi64(_mm256_srli_epi64(z1, 32), _mm256_srli_epi64(z2, 32)));
+}
+
+/* x * y as a signed 128-bit product, as UNSAFE_MUL_64_64_128 does it: multiply
+ * the magnitudes, then fix up the sign. */
+FIX_INLINE FIX_AVX2 void fix_avx2_mul_64_64_128(__m256i op1, __m256i op2,
+    __m256i* resultlow, __m256i* resulthigh) {
+  __m256i zero = _mm256_setzero_si256();
+
+  __m256i absx = _mm256_blendv_epi8(op1, _mm256_sub_epi64(zero, op1), fix_avx2_is_neg(op1));
+  __m256i absy = _mm256_blendv_epi8(op2, _mm256_sub_epi64(zero, op2), fix_avx2_is_neg(op2));
+
+  __m256i low;
+  __m256i high;
+  fix_avx2_umul_64_64_128(absx, absy, &low, &high);
+
+  __m256i negresult = fix_avx2_is_neg(_mm256_xor_si256(op1, op2));
+  __m256i neglow = _mm256_sub_epi64(zero, low);
+  // ~high + (low == 0); the compare is all ones, so subtract it.
+  __m256i neghigh = _mm256_sub_epi64(_mm256_xor_si256(high, fix_avx2_set(~((uint64_t) 0))),
+      _mm256_cmpeq_epi64(low, zero));
+
+  *resultlow = _mm256_blendv_epi8(low, neglow, negresult);
+  *resulthigh = _mm256_blendv_epi8(high, neghigh, negresult);
+}
+
+// ROUND_TO_EVEN_64, for a shift known at compile time.
+#define FIX_AVX2_ROUND_TO_EVEN(value, n_shift_bits) \
+  ({ \
+    __m256i one = fix_avx2_set(1); \
+    __m256i shifted = _mm256_srli_epi64(value, n_shift_bits); \
+    __m256i lowbit = fix_avx2_and(shifted, one); \
+    __m256i highroundbit = fix_avx2_and(_mm256_srli_epi64(value, (n_shift_bits) - 1), one); \
+    __m256i restroundbits = fix_avx2_and(value, \
+        fix_avx2_set((1ull << ((n_shift_bits) - 1)) - 1)); \
+    __m256i restnonzero = fix_avx2_andnot( \
+        _mm256_cmpeq_epi64(restroundbits, _mm256_setzero_si256()), one); \
+    _mm256_add_epi64(shifted, fix_avx2_and(highroundbit, fix_avx2_or(lowbit, restnonzero))); \
+  })
+
+/* MUL_64_TOP. Its ROUND_TO_EVEN_ADDITION gets the round bit unshifted, so the
+ * (highroundbit & restroundbit) half is always zero, and it only rounds up when
+ * the round bit and the low bit are both set. This does the same. */
+FIX_INLINE FIX_AVX2 __m256i fix_avx2_mul_top(__m256i op1, __m256i op2) {
+  __m256i low;
+  __m256i high;
+  fix_avx2_umul_64_64_128(op1, op2, &low, &high);
+
+  __m256i highroundbit = _mm256_srli_epi64(low, 63);
+  return _mm256_add_epi64(high, fix_avx2_and(highroundbit, high));
+}
+
+/* FIX_MUL_INTERN, which is MUL_64_N with FIX_INTERN_FRAC_BITS extra bits. Lanes
+ * that overflow are set in *overflow. */
+FIX_INLINE FIX_AVX2 __m256i fix_avx2_mul_intern(__m256i op1, __m256i op2, __m256i* overflow) {
+  __m256i zero = _mm256_setzero_si256();
+  __m256i tmplow;
+  __m256i tmphigh;
+  fix_avx2_mul_64_64_128(op1, op2, &tmplow, &tmphigh);
+  __m256i tmp = _mm256_add_epi64(FIX_AVX2_ROUND_TO_EVEN(tmplow, FIX_INTERN_FRAC_BITS),
+      _mm256_slli_epi64(tmphigh, 64 - FIX_INTERN_FRAC_BITS));
+
+  // inf only if overflow, and not a sign thing
+  __m256i signconst = fix_avx2_set((~1ull) & (~((1ull << (FIX_INTERN_FRAC_BITS - 1)) - 1)));
+  __m256i signbits = fix_avx2_and(tmphigh, signconst);
+  *overflow = fix_avx2_or(*overflow, fix_avx2_andnot(
+      fix_avx2_or(_mm256_cmpeq_epi64(signbits, signconst), _mm256_cmpeq_epi64(signbits, zero)),
+      fix_avx2_set(~((uint64_t) 0))));
+  return tmp;
+}
+
+FIX_INLINE FIX_AVX2 __m256i fix_avx2_mul(__m256i op1, __m256i op2) {
+  __m256i isinfop1 = fix_avx2_or(fix_avx2_is_flag(op1, FIX_INF_NEG), fix_avx2_is_flag(op1, FIX_INF_POS));
+  __m256i isinfop2 = fix_avx2_or(fix_avx2_is_flag(op2, FIX_INF_NEG), fix_avx2_is_flag(op2, FIX_INF_POS));
+  __m256i isnegop1 = fix_avx2_or(fix_avx2_is_flag(op1, FIX_INF_NEG),
+      fix_avx2_andnot(isinfop1, fix_avx2_is_neg(op1)));
+  __m256i isnegop2 = fix_avx2_or(fix_avx2_is_flag(op2, FIX_INF_NEG),
+      fix_avx2_andnot(isinfop2, fix_avx2_is_neg(op2)));
+
+  __m256i isnan = fix_avx2_or(fix_avx2_is_flag(op1, FIX_NAN), fix_avx2_is_flag(op2, FIX_NAN));
+
+  __m256i zero = _mm256_setzero_si256();
+  __m256i iszero = fix_avx2_or(_mm256_cmpeq_epi64(op1, zero), _mm256_cmpeq_epi64(op2, zero));
+
+  // FIX_MUL_64
+  __m256i tmplow;
+  __m256i tmphigh;
+  fix_avx2_mul_64_64_128(op1, op2, &tmplow, &tmphigh);
+  __m256i tmp = _mm256_add_epi64(FIX_AVX2_ROUND_TO_EVEN(tmplow, FIX_POINT_BITS),
+      _mm256_slli_epi64(tmphigh, 64 - FIX_POINT_BITS));
+
+  // inf only if overflow, and not a sign thing
+  __m256i mulconst = fix_avx2_set(FIX_MUL_CONST);
+  __m256i signbits = fix_avx2_and(tmphigh, mulconst);
+  __m256i overflow = fix_avx2_andnot(
+      fix_avx2_or(_mm256_cmpeq_epi64(signbits, mulconst), _mm256_cmpeq_epi64(signbits, zero)),
+      fix_avx2_set(~((uint64_t) 0)));
+
+  tmp = _mm256_slli_epi64(FIX_AVX2_ROUND_TO_EVEN(tmp, FIX_FLAG_BITS), FIX_FLAG_BITS);
+
+  __m256i isinf = fix_avx2_andnot(fix_avx2_or(iszero, isnan),
+      fix_avx2_or(fix_avx2_or(isinfop1, isinfop2), overflow));
+
+  __m256i negresult = _mm256_xor_si256(isnegop1, isnegop2);
+  __m256i isinfpos = fix_avx2_andnot(negresult, isinf);
+  __m256i isinfneg = fix_avx2_and(negresult, isinf);
+
+  return fix_avx2_combine(isnan, isinfpos, isinfneg, tmp);
+}
+
+/* The results are -1, 0 or 1, so packing each lane down to its low byte (with
+ * signed saturation) keeps them. */
+FIX_AVX2 void fix_cmp_array_avx2(int8_t* result, const fixed* op1, const fixed* op2, size_t n) {
+  size_t i = 0;
+  for(; i + 4 <= n; i += 4) {
+    __m256i r = fix_avx2_cmp(fix_avx2_load(op1 + i), fix_avx2_load(op2 + i));
+    __m256i low = _mm256_permutevar8x32_epi32(r, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+    __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(low), _mm256_castsi256_si128(low));
+    packed = _mm_packs_epi16(packed, packed);
+    int32_t bytes = _mm_cvtsi128_si32(packed);
+    memcpy(result + i, &bytes, 4);
+  }
+  for(; i < n; i++) {
+    result[i] = fix_cmp_inline(op1[i], op2[i]);
+  }
+}
+
+FIX_AVX2 void fix_neg_array_avx2(fixed* result, const fixed* op1, size_t n) {
+  size_t i = 0;
+  for(; i + 4 <= n; i += 4) {
+    fix_avx2_store(result + i, fix_avx2_neg(fix_avx2_load(op1 + i)));
+  }
+  for(; i < n; i++) {
+    result[i] = fix_neg_inline(op1[i]);
+  }
+}
+
+FIX_AVX2 void fix_abs_array_avx2(fixed* result, const fixed* op1, size_t n) {
+  size_t i = 0;
+  for(; i + 4 <= n; i += 4) {
+    fix_avx2_store(result + i, fix_avx2_abs(fix_avx2_load(op1 + i)));
+  }
+  for(; i < n; i++) {
+    result[i] = fix_abs_inline(op1[i]);
+  }
+}
+
+FIX_AVX2 void fix_add_array_avx2(fixed* result, const fixed* op1, const fixed* op2, size_t n) {
+  size_t i = 0;
+  for(; i + 4 <= n; i += 4) {
+    fix_avx2_store(result + i, fix_avx2_add(fix_avx2_load(op1 + i), fix_avx2_load(op2 + i)));
+  }
+  for(; i < n; i++) {
+    result[i] = fix_add_inline(op1[i], op2[i]);
+  }
+}
+
+FIX_AVX2 void fix_sub_array_avx2(fixed* result, const fixed* op1, const fixed* op2, size_t n) {
+  size_t i = 0;
+  for(; i + 4 <= n; i += 4) {
+    __m256i negop2 = fix_avx2_neg(fix_avx2_load(op2 + i));
+    fix_avx2_store(result + i, fix_avx2_add(fix_avx2_load(op1 + i), negop2));
+  }
+  for(; i < n; i++) {
+    result[i] = fix_add_inline(op1[i], fix_neg_inline(op2[i]));
+  }
+}
+
+FIX_AVX2 void fix_mul_array_avx2(fixed* result, const fixed* op1, const fixed* op2, size_t n) {
+  size_t i = 0;
+  for(; i + 4 <= n; i += 4) {
+    fix_avx2_store(result + i, fix_avx2_mul(fix_avx2_load(op1 + i), fix_avx2_load(op2 + i)));
+  }
+  for(; i < n; i++) {
+    result[i] = fix_mul_inline(op1[i], op2[i]);
+  }
+}
+
+FIX_AVX2 void fix_add_scalar_array_avx2(fixed* result, const fixed* op1, fixed op2, size_t n) {
+  __m256i k = fix_avx2_set(op2);
+  size_t i = 0;
+  for(; i + 4 <= n; i += 4) {
+    fix_avx2_store(result + i, fix_avx2_add(fix_avx2_load(op1 + i), k));
+  }
+  for(; i < n; i++) {
+    result[i] = fix_add_inline(op1[i], op2);
+  }
+}
+
+FIX_AVX2 void fix_mul_scalar_array_avx2(fixed* result, const fixed* op1, fixed op2, size_t n) {
+  __m256i k = fix_avx2_set(op2);
+  size_t i = 0;
+  for(; i + 4 <= n; i += 4) {
+    fix_avx2_store(result + i, fix_avx2_mul(fix_avx2_load(op1 + i), k));
+  }
+  for(; i < n; i++) {
+    result[i] = fix_mul_inline(op1[i], op2);
+  }
+}
+
+FIX_AVX2 void fix_intern_poly_array_avx2(fix_internal* result, uint64_t* overflow,
+    const fix_internal* m, const fix_internal* coefs, int degree, size_t n) {
+  /* Each step waits on the last, so two groups of 4 go side by side to keep
+   * the multipliers busy. */
+  size_t i = 0;
+  for(; i + 8 <= n; i += 8) {
+    __m256i x0 = fix_avx2_load(m + i);
+    __m256i x1 = fix_avx2_load(m + i + 4);
+    __m256i ovf0 = _mm256_setzero_si256();
+    __m256i ovf1 = _mm256_setzero_si256();
+
+    __m256i c = fix_avx2_set(coefs[degree]);
+    __m256i tmp0 = fix_avx2_mul_intern(x0, c, &ovf0);
+    __m256i tmp1 = fix_avx2_mul_intern(x1, c, &ovf1);
+    for(int k = degree - 1; k >= 1; k--) {
+      c = fix_avx2_set(coefs[k]);
+      tmp0 = fix_avx2_mul_intern(x0, _mm256_add_epi64(tmp0, c), &ovf0);
+      tmp1 = fix_avx2_mul_intern(x1, _mm256_add_epi64(tmp1, c), &ovf1);
+    }
+
+    fix_avx2_store(result + i, tmp0);
+    fix_avx2_store(result + i + 4, tmp1);
+    fix_avx2_store(overflow + i, fix_avx2_and(ovf0, fix_avx2_set(1)));
+    fix_avx2_store(overflow + i + 4, fix_avx2_and(ovf1, fix_avx2_set(1)));
+  }
+  for(; i < n; i++) {
+    uint8_t ovf = 0;
+    result[i] = fix_intern_poly(m[i], coefs, degree, &ovf);
+    overflow[i] = ovf;
+  }
+}
+
+FIX_AVX2 void fix_exp_series_array_avx2(fix_internal* e_x, uint64_t* overflow,
+    const fix_internal* x, const fix_internal* inv, int terms, size_t n) {
+  // Two groups of 4 at a time, as in fix_intern_poly_array_avx2.
+  size_t i = 0;
+  for(; i + 8 <= n; i += 8) {
+    __m256i x0 = fix_avx2_load(x + i);
+    __m256i x1 = fix_avx2_load(x + i + 4);
+    __m256i ovf0 = _mm256_setzero_si256();
+    __m256i ovf1 = _mm256_setzero_si256();
+
+    __m256i e0 = fix_avx2_set(1ull << FIX_INTERN_FRAC_BITS);
+    __m256i e1 = e0;
+    __m256i term0 = e0;
+    __m256i term1 = e0;
+    for(int t = 1; t < terms; t++) {
+      __m256i c = fix_avx2_set(inv[t]);
+      term0 = fix_avx2_mul_intern(term0, x0, &ovf0);
+      term1 = fix_avx2_mul_intern(term1, x1, &ovf1);
+      term0 = fix_avx2_mul_intern(term0, c, &ovf0);
+      term1 = fix_avx2_mul_intern(term1, c, &ovf1);
+
+      e0 = _mm256_add_epi64(e0, term0);
+      e1 = _mm256_add_epi64(e1, term1);
+    }
+
+    fix_avx2_store(e_x + i, e0);
+    fix_avx2_store(e_x + i + 4, e1);
+    fix_avx2_store(overflow + i, fix_avx2_and(ovf0, fix_avx2_set(1)));
+    fix_avx2_store(overflow + i + 4, fix_avx2_and(ovf1, fix_avx2_set(1)));
+  }
+  for(; i < n; i++) {
+    uint8_t ovf = 0;
+    e_x[i] = fix_exp_series(x[i], inv, terms, &ovf);
+    overflow[i] = ovf;
+  }
+}
+
+FIX_AVX2 void fix_exp_square_array_avx2(uint64_t* rshift, int64_t* rint_bits,
+    const uint64_t* squarings, int loops, size_t n) {
+  __m256i zero = _mm256_setzero_si256();
+  __m256i one = fix_avx2_set(1);
+  __m256i ones = fix_avx2_set(~((uint64_t) 0));
+
+  size_t i = 0;
+  for(; i + 4 <= n; i += 4) {
+    __m256i r = fix_avx2_load(rshift + i);
+    __m256i bits = fix_avx2_load((const fixed*) rint_bits + i);
+    __m256i sq = fix_avx2_load(squarings + i);
+
+    for(int l = 0; l < loops; l++) {
+      __m256i r2 = fix_avx2_mul_top(r, r);
+
+      // squarings never gets anywhere near the top bit, so a signed compare is
+      // fine.
+      __m256i active = _mm256_cmpgt_epi64(sq, zero);
+      // !FIX_TOP_BIT(r2), as a mask; adding it subtracts the 1.
+      __m256i notop = fix_avx2_andnot(fix_avx2_is_neg(r2), ones);
+
+      __m256i shifted = _mm256_blendv_epi8(r2, _mm256_slli_epi64(r2, 1), notop);
+      r = _mm256_blendv_epi8(r, shifted, active);
+
+      bits = _mm256_add_epi64(bits, fix_avx2_and(active, _mm256_add_epi64(bits, notop)));
+
+      sq = fix_avx2_and(active, _mm256_sub_epi64(sq, one));
+    }
+
+    fix_avx2_store(rshift + i, r);
+    fix_avx2_store((fixed*) rint_bits + i, bits);
+  }
+  for(; i < n; i++) {
+    fix_exp_square(&rshift[i], &rint_bits[i], squarings[i], loops);
+  }
+}
+
+#endif
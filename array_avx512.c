@@ -0,0 +1,150 @@
+#include "ftfp.h"
+#include "internal.h"
+
+// Contains the AVX-512 kernels for the _array functions in array.c.
+
+#if FIX_X86_SIMD
+
+#include <immintrin.h>
+
+#define FIX_IFMA __attribute__((target("avx512f,avx512ifma")))
+
+/* Like array_avx2.c, but 8 elements at a time, and the flags are __mmask8s
+ * with a bit per element, so the usual &, | and ~ work on them directly. */
+
+FIX_INLINE FIX_IFMA __m512i fix_ifma_set(uint64_t x) {
+  return _mm512_set1_epi64((int64_t) x);
+}
+
+// (f & FIX_FLAGS_MASK) == flag
+FIX_INLINE FIX_IFMA __mmask8 fix_ifma_is_flag(__m512i f, fixed flag) {
+  return _mm512_cmpeq_epi64_mask(_mm512_and_si512(f, fix_ifma_set(FIX_FLAGS_MASK)),
+      fix_ifma_set(flag));
+}
+
+// FIX_IS_NEG
+FIX_INLINE FIX_IFMA __mmask8 fix_ifma_is_neg(__m512i f) {
+  return _mm512_cmplt_epi64_mask(f, _mm512_setzero_si512());
+}
+
+/* x * y as a signed 128-bit product. The multiply-adds take 52-bit operands,
+ * so the magnitudes are split into a 52-bit low limb and a 12-bit high limb,
+ * and the four products summed at bits 0, 52 and 104. None of the partial
+ * sums can reach 2^64. */
+FIX_INLINE FIX_IFMA void fix_ifma_mul_64_64_128(__m512i op1, __m512i op2,
+    __m512i* resultlow, __m512i* resulthigh) {
+  __m512i zero = _mm512_setzero_si512();
+  __m512i mask52 = fix_ifma_set((1ull << 52) - 1);
+
+  // FIX_MIN is its own absolute value, as with ~x + 1.
+  __m512i absx = _mm512_abs_epi64(op1);
+  __m512i absy = _mm512_abs_epi64(op2);
+
+  __m512i x0 = _mm512_and_si512(absx, mask52);
+  __m512i x1 = _mm512_srli_epi64(absx, 52);
+  __m512i y0 = _mm512_and_si512(absy, mask52);
+  __m512i y1 = _mm512_srli_epi64(absy, 52);
+
+  __m512i c0 = _mm512_madd52lo_epu64(zero, x0, y0);
+
+  __m512i c1 = _mm512_madd52hi_epu64(zero, x0, y0);
+  c1 = _mm512_madd52lo_epu64(c1, x0, y1);
+  c1 = _mm512_madd52lo_epu64(c1, x1, y0);
+
+  // x1 * y1 is below 2^24, so it has no high half.
+  __m512i c2 = _mm512_madd52hi_epu64(zero, x0, y1);
+  c2 = _mm512_madd52hi_epu64(c2, x1, y0);
+  c2 = _mm512_madd52lo_epu64(c2, x1, y1);
+
+  c2 = _mm512_add_epi64(c2, _mm512_srli_epi64(c1, 52));
+  c1 = _mm512_and_si512(c1, mask52);
+
+  __m512i low = _mm512_or_si512(c0, _mm512_slli_epi64(c1, 52));
+  __m512i high = _mm512_add_epi64(_mm512_srli_epi64(c1, 12), _mm512_slli_epi64(c2, 40));
+
+  __mmask8 negresult = fix_ifma_is_neg(_mm512_xor_si512(op1, op2));
+  __mmask8 lowzero = _mm512_cmpeq_epi64_mask(low, zero);
+  __m512i neglow = _mm512_sub_epi64(zero, low);
+  // ~high + (low == 0)
+  __m512i neghigh = _mm512_xor_si512(high, fix_ifma_set(~((uint64_t) 0)));
+  neghigh = _mm512_mask_add_epi64(neghigh, lowzero, neghigh, fix_ifma_set(1));
+
+  *resultlow = _mm512_mask_blend_epi64(negresult, low, neglow);
+  *resulthigh = _mm512_mask_blend_epi64(negresult, high, neghigh);
+}
+
+// ROUND_TO_EVEN_64, for a shift known at compile time.
+#define FIX_IFMA_ROUND_TO_EVEN(value, n_shift_bits) \
+  ({ \
+    __m512i one = fix_ifma_set(1); \
+    __m512i shifted = _mm512_srli_epi64(value, n_shift_bits); \
+    __m512i lowbit = _mm512_and_si512(shifted, one); \
+    __m512i highroundbit = _mm512_and_si512(_mm512_srli_epi64(value, (n_shift_bits) - 1), one); \
+    __mmask8 restnonzero = _mm512_test_epi64_mask(value, \
+        fix_ifma_set((1ull << ((n_shift_bits) - 1)) - 1)); \
+    __m512i round = _mm512_mask_or_epi64(lowbit, restnonzero, lowbit, one); \
+    _mm512_add_epi64(shifted, _mm512_and_si512(highroundbit, round)); \
+  })
+
+FIX_INLINE FIX_IFMA __m512i fix_ifma_mul(__m512i op1, __m512i op2) {
+  __mmask8 isinfop1 = fix_ifma_is_flag(op1, FIX_INF_NEG) | fix_ifma_is_flag(op1, FIX_INF_POS);
+  __mmask8 isinfop2 = fix_ifma_is_flag(op2, FIX_INF_NEG) | fix_ifma_is_flag(op2, FIX_INF_POS);
+  __mmask8 isnegop1 = fix_ifma_is_flag(op1, FIX_INF_NEG) | (fix_ifma_is_neg(op1) & ~isinfop1);
+  __mmask8 isnegop2 = fix_ifma_is_flag(op2, FIX_INF_NEG) | (fix_ifma_is_neg(op2) & ~isinfop2);
+
+  __mmask8 isnan = fix_ifma_is_flag(op1, FIX_NAN) | fix_ifma_is_flag(op2, FIX_NAN);
+
+  __m512i zero = _mm512_setzero_si512();
+  __mmask8 iszero = _mm512_cmpeq_epi64_mask(op1, zero) | _mm512_cmpeq_epi64_mask(op2, zero);
+
+  // FIX_MUL_64
+  __m512i tmplow;
+  __m512i tmphigh;
+  fix_ifma_mul_64_64_128(op1, op2, &tmplow, &tmphigh);
+  __m512i tmp = _mm512_add_epi64(FIX_IFMA_ROUND_TO_EVEN(tmplow, FIX_POINT_BITS),
+      _mm512_slli_epi64(tmphigh, 64 - FIX_POINT_BITS));
+
+  // inf only if overflow, and not a sign thing
+  __m512i mulconst = fix_ifma_set(FIX_MUL_CONST);
+  __m512i signbits = _mm512_and_si512(tmphigh, mulconst);
+  __mmask8 overflow = ~(_mm512_cmpeq_epi64_mask(signbits, mulconst) |
+      _mm512_cmpeq_epi64_mask(signbits, zero));
+
+  tmp = _mm512_slli_epi64(FIX_IFMA_ROUND_TO_EVEN(tmp, FIX_FLAG_BITS), FIX_FLAG_BITS);
+
+  __mmask8 isinf = ~(iszero | isnan) & (isinfop1 | isinfop2 | overflow);
+
+  __mmask8 negresult = isnegop1 ^ isnegop2;
+  __mmask8 isinfpos = isinf & ~negresult;
+  __mmask8 isinfneg = isinf & negresult;
+
+  __m512i result = _mm512_and_si512(tmp, fix_ifma_set(FIX_DATA_BIT_MASK));
+  result = _mm512_mask_or_epi64(result, isnan, result, fix_ifma_set(FIX_NAN));
+  result = _mm512_mask_or_epi64(result, isinfpos, result, fix_ifma_set(FIX_INF_POS));
+  result = _mm512_mask_or_epi64(result, isinfneg, result, fix_ifma_set(FIX_INF_NEG));
+  return result;
+}
+
+FIX_IFMA void fix_mul_array_ifma(fixed* result, const fixed* op1, const fixed* op2, size_t n) {
+  size_t i = 0;
+  for(; i + 8 <= n; i += 8) {
+    __m512i r = fix_ifma_mul(_mm512_loadu_si512(op1 + i), _mm512_loadu_si512(op2 + i));
+    _mm512_storeu_si512(result + i, r);
+  }
+  for(; i < n; i++) {
+    result[i] = fix_mul_inline(op1[i], op2[i]);
+  }
+}
+
+FIX_IFMA void fix_mul_scalar_array_ifma(fixed* result, const fixed* op1, fixed op2, size_t n) {
+  __m512i k = fix_ifma_set(op2);
+  size_t i = 0;
+  for(; i + 8 <= n; i += 8) {
+    _mm512_storeu_si512(result + i, fix_ifma_mul(_mm512_loadu_si512(op1 + i), k));
+  }
+  for(; i < n; i++) {
+    result[i] = fix_mul_inline(op1[i], op2);
+  }
+}
+
+#endif
@@ -6,90 +6,415 @@
 
 // Contains the cordic trig functions for libftfp.
 
-fixed fix_sin(fixed op1) {
-  uint8_t isinfpos = FIX_IS_INF_POS(op1);
-  uint8_t isinfneg = FIX_IS_INF_NEG(op1);
-  uint8_t isnan = FIX_IS_NAN(op1);
-
-  fix_internal Z = fix_circle_frac(op1);
-  fix_internal C = CORDIC_P;
-  fix_internal S = 0;
+/* The functions below work on a circle fraction: the angle in quarter turns,
+ * in [0,4), as a fix_internal. fix_sin and friends get one from
+ * fix_circle_frac; the _turns and pi versions can read it straight off of
+ * their argument. */
 
-  // The circle fraction is in [0,4).
-  // Move it to [-1, 1], where cordic will work for sin
-  fix_internal top_bits_differ = ((Z >>  FIX_INTERN_FRAC_BITS   ) & 0x1) ^
-                                 ((Z >> (FIX_INTERN_FRAC_BITS+1)) & 0x1);
-  Z = MASK_UNLESS( top_bits_differ, (((fix_internal) 2)<<(FIX_INTERN_FRAC_BITS)) - Z) |
-      MASK_UNLESS(!top_bits_differ, SIGN_EXTEND(Z, FIX_INTERN_FRAC_BITS+2));
+/* x is in turns, so the circle fraction is just the fractional part of x,
+ * times 4. That's exact: the flag bits are all we could shift off. */
+FIX_INLINE fix_internal fix_turns_circle_frac(fixed op1) {
+  fixed frac = op1 & ((((fixed) 1) << FIX_POINT_BITS) - 1);
+#if FIX_POINT_BITS <= FIX_INTERN_FRAC_BITS + 2
+  return frac << (FIX_INTERN_FRAC_BITS + 2 - FIX_POINT_BITS);
+#else
+  return frac >> (FIX_POINT_BITS - FIX_INTERN_FRAC_BITS - 2);
+#endif
+}
 
-  cordic(&Z, &C, &S);
+/* x is in half turns, so the circle fraction is x mod 2, times 2. */
+FIX_INLINE fix_internal fix_halfturns_circle_frac(fixed op1) {
+#if FIX_POINT_BITS + 1 < 64
+  fixed frac = op1 & ((((fixed) 1) << (FIX_POINT_BITS + 1)) - 1);
+#else
+  fixed frac = op1;
+#endif
+#if FIX_POINT_BITS <= FIX_INTERN_FRAC_BITS + 1
+  return frac << (FIX_INTERN_FRAC_BITS + 1 - FIX_POINT_BITS);
+#else
+  return frac >> (FIX_POINT_BITS - FIX_INTERN_FRAC_BITS - 1);
+#endif
+}
 
-  return FIX_IF_NAN(isnan | isinfpos | isinfneg) |
-    FIX_INTERN_TO_FIXED(S);
+/* Converts a cordic result, which is in [-1, 1] with CORDIC_FRAC_BITS fraction
+ * bits, to a fixed. With only one int bit, 1 doesn't fit, so saturate instead of
+ * wrapping around. */
+FIX_INLINE fixed fix_cordic_to_fixed(fix_internal x) {
+  fix_internal rounded = cordic_shift(x, CORDIC_FRAC_BITS - FIX_FRAC_BITS);
+#if FIX_INT_BITS == 1
+  uint8_t big   = (fixed_signed) rounded >=   (fixed_signed) (((fix_internal) 1) << FIX_FRAC_BITS);
+  uint8_t small = (fixed_signed) rounded <  -((fixed_signed) (((fix_internal) 1) << FIX_FRAC_BITS));
+  return MASK_UNLESS(big, FIX_MAX) | MASK_UNLESS(small, FIX_MIN) |
+    MASK_UNLESS(!(big | small), FIX_DATA_BITS(rounded << FIX_FLAG_BITS));
+#else
+  return FIX_DATA_BITS(rounded << FIX_FLAG_BITS);
+#endif
 }
 
-fixed fix_cos(fixed op1) {
-  uint8_t isinfpos = FIX_IS_INF_POS(op1);
-  uint8_t isinfneg = FIX_IS_INF_NEG(op1);
-  uint8_t isnan = FIX_IS_NAN(op1);
+/* 1 if the circle fraction, in [0,4), is in Q2 or Q3. */
+FIX_INLINE fix_internal fix_circle_frac_q23(fix_internal Z) {
+  return ((Z >>  FIX_INTERN_FRAC_BITS   ) & 0x1) ^
+         ((Z >> (FIX_INTERN_FRAC_BITS+1)) & 0x1);
+}
 
-  fix_internal circle_frac = fix_circle_frac(op1);
+/* The circle fraction is in [0,4). Move it to [-1, 1], where cordic will work
+ * for sin. */
+FIX_INLINE fix_internal fix_sin_reduce(fix_internal Z) {
+  fix_internal top_bits_differ = fix_circle_frac_q23(Z);
+  return MASK_UNLESS( top_bits_differ, (((fix_internal) 2)<<(FIX_INTERN_FRAC_BITS)) - Z) |
+         MASK_UNLESS(!top_bits_differ, SIGN_EXTEND(Z, FIX_INTERN_FRAC_BITS+2));
+}
 
+/* The same for cos, which is sin of a quarter turn minus the angle. */
+FIX_INLINE fix_internal fix_cos_reduce(fix_internal circle_frac) {
   /* flip up into Q1 and Q2 */
-  uint8_t Q3or4 = !!((((fix_internal) 2) << FIX_INTERN_FRAC_BITS) & circle_frac);
+  fix_internal Q3or4 = ((((fix_internal) 2) << FIX_INTERN_FRAC_BITS) & circle_frac) != 0;
   circle_frac = MASK_UNLESS( Q3or4, (((fix_internal) 4)<< FIX_INTERN_FRAC_BITS) - circle_frac) |
                 MASK_UNLESS(!Q3or4, circle_frac);
 
   /* Switch from cos on an angle in Q1 or Q2 to sin in Q4 or Q1.
    * This necessitates flipping the angle from [0,2] to [1, -1].
    */
-  circle_frac = (((fix_internal) 1) << (FIX_INTERN_FRAC_BITS)) - circle_frac;
+  return (((fix_internal) 1) << (FIX_INTERN_FRAC_BITS)) - circle_frac;
+}
 
-  fix_internal Z = circle_frac;
-  fix_internal C = CORDIC_P;
-  fix_internal S = 0;
+/* fix_sin_reduce is a reflection in Q2 and Q3, which flips the sign of cos. */
+FIX_INLINE fix_internal fix_sincos_cos(fix_internal circle_frac, fix_internal C) {
+  fix_internal top_bits_differ = fix_circle_frac_q23(circle_frac);
+  return MASK_UNLESS( top_bits_differ, (~C) + 1) |
+         MASK_UNLESS(!top_bits_differ, C);
+}
 
-  cordic(&Z, &C, &S);
+FIX_INLINE fixed fix_sin_frac(fix_internal Z) {
+  fix_internal C;
+  fix_internal S;
 
-  return FIX_IF_NAN(isnan | isinfpos | isinfneg) |
-    FIX_INTERN_TO_FIXED(S);
+  cordic(fix_sin_reduce(Z), &C, &S);
+
+  return fix_cordic_to_fixed(S);
 }
 
-fixed fix_tan(fixed op1) {
-  // We will return NaN if you pass in infinity, but we might return infinity
-  // anyway...
-  uint8_t isinfpos = 0;
-  uint8_t isinfneg = 0;
-  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_INF_POS(op1) | FIX_IS_INF_NEG(op1);
+FIX_INLINE fixed fix_cos_frac(fix_internal circle_frac) {
+  fix_internal C;
+  fix_internal S;
+
+  cordic(fix_cos_reduce(circle_frac), &C, &S);
+
+  return fix_cordic_to_fixed(S);
+}
+
+/* Computes both sin and cos with a single cordic. */
+FIX_INLINE void fix_sincos_frac(fix_internal Z, fixed* sinx, fixed* cosx) {
+  fix_internal C;
+  fix_internal S;
 
+  cordic(fix_sin_reduce(Z), &C, &S);
+
+  *sinx = fix_cordic_to_fixed(S);
+  *cosx = fix_cordic_to_fixed(fix_sincos_cos(Z, C));
+}
+
+FIX_INLINE fixed fix_tan_frac(fix_internal circle_frac, uint8_t* isinfpos, uint8_t* isinfneg) {
   /* The circle fraction is in [0,4). The cordic algorithm can handle [-1, 1],
    * and tan has rotational symmetry at z = 1.
    *
    * If we're in Q2 or 3, subtract 2 from the circle frac.
    */
 
-  fix_internal circle_frac = fix_circle_frac(op1);
-
   fix_internal top_bits_differ = ((circle_frac >>  FIX_INTERN_FRAC_BITS   ) & 0x1) ^
                                  ((circle_frac >> (FIX_INTERN_FRAC_BITS+1)) & 0x1);
   fix_internal Z = MASK_UNLESS( top_bits_differ, circle_frac -
                                      (((fix_internal) 1) << (FIX_INTERN_FRAC_BITS+1))) |
                    MASK_UNLESS(!top_bits_differ, SIGN_EXTEND(circle_frac, FIX_INTERN_FRAC_BITS+2));
 
-  fix_internal C = CORDIC_P;
-  fix_internal S = 0;
+  fix_internal C;
+  fix_internal S;
 
-  cordic(&Z, &C, &S);
+  cordic(Z, &C, &S);
 
   uint8_t isinf = 0;
-  fix_internal result = fix_div_var(S, C, &isinf);
+  fix_internal result = fix_div_recip(S, C, &isinf);
+
+  *isinfpos |= !!(isinf | (C==0)) & !FIX_IS_NEG(S);
+  *isinfneg |= !!(isinf | (C==0)) &  FIX_IS_NEG(S);
+
+  return FIX_DATA_BITS(ROUND_TO_EVEN_SIGNED(result, FIX_FLAG_BITS) << FIX_FLAG_BITS);
+}
+
+/* The _turns and pi versions of tan can land exactly on a pole. Cordic won't
+ * quite get cos to zero there, so check for it directly: a quarter turn is
+ * +Inf, and three quarters (i.e., minus one quarter) is -Inf. */
+FIX_INLINE fixed fix_tan_frac_exact(fix_internal circle_frac, uint8_t isnan) {
+  uint8_t isinfpos = 0;
+  uint8_t isinfneg = 0;
+
+  fixed result = fix_tan_frac(circle_frac, &isinfpos, &isinfneg);
+
+  uint8_t pole_pos = circle_frac == (((fix_internal) 1) << FIX_INTERN_FRAC_BITS);
+  uint8_t pole_neg = circle_frac == (((fix_internal) 3) << FIX_INTERN_FRAC_BITS);
 
-  isinfpos |= !!(isinf | (C==0)) & !FIX_IS_NEG(S);
-  isinfneg |= !!(isinf | (C==0)) &  FIX_IS_NEG(S);
+  isinfpos = (isinfpos & !pole_neg) | pole_pos;
+  isinfneg = (isinfneg & !pole_pos) | pole_neg;
 
   return FIX_IF_NAN(isnan) |
     FIX_IF_INF_POS(isinfpos & (!isnan)) |
     FIX_IF_INF_NEG(isinfneg & (!isnan)) |
-    FIX_DATA_BITS(ROUND_TO_EVEN_SIGNED(result, FIX_FLAG_BITS) << FIX_FLAG_BITS);
+    MASK_UNLESS(!(isinfpos | isinfneg), result);
+}
+
+fixed fix_sin(fixed op1) {
+  uint8_t isinfpos = FIX_IS_INF_POS(op1);
+  uint8_t isinfneg = FIX_IS_INF_NEG(op1);
+  uint8_t isnan = FIX_IS_NAN(op1);
+
+  return FIX_IF_NAN(isnan | isinfpos | isinfneg) |
+    fix_sin_frac(fix_circle_frac(op1));
+}
+
+fixed fix_cos(fixed op1) {
+  uint8_t isinfpos = FIX_IS_INF_POS(op1);
+  uint8_t isinfneg = FIX_IS_INF_NEG(op1);
+  uint8_t isnan = FIX_IS_NAN(op1);
+
+  return FIX_IF_NAN(isnan | isinfpos | isinfneg) |
+    fix_cos_frac(fix_circle_frac(op1));
+}
+
+fixed fix_tan(fixed op1) {
+  // We will return NaN if you pass in infinity, but we might return infinity
+  // anyway...
+  uint8_t isinfpos = 0;
+  uint8_t isinfneg = 0;
+  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_INF_POS(op1) | FIX_IS_INF_NEG(op1);
+
+  fixed result = fix_tan_frac(fix_circle_frac(op1), &isinfpos, &isinfneg);
+
+  return FIX_IF_NAN(isnan) |
+    FIX_IF_INF_POS(isinfpos & (!isnan)) |
+    FIX_IF_INF_NEG(isinfneg & (!isnan)) |
+    result;
+}
+
+void fix_sincos(fixed op1, fixed* sinx, fixed* cosx) {
+  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_INF_POS(op1) | FIX_IS_INF_NEG(op1);
+
+  fixed s, c;
+  fix_sincos_frac(fix_circle_frac(op1), &s, &c);
+
+  *sinx = FIX_IF_NAN(isnan) | MASK_UNLESS(!isnan, s);
+  *cosx = FIX_IF_NAN(isnan) | MASK_UNLESS(!isnan, c);
 }
 
+fixed fix_sin_turns(fixed op1) {
+  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_INF_POS(op1) | FIX_IS_INF_NEG(op1);
+
+  return FIX_IF_NAN(isnan) | fix_sin_frac(fix_turns_circle_frac(op1));
+}
+
+fixed fix_cos_turns(fixed op1) {
+  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_INF_POS(op1) | FIX_IS_INF_NEG(op1);
+
+  return FIX_IF_NAN(isnan) | fix_cos_frac(fix_turns_circle_frac(op1));
+}
+
+fixed fix_tan_turns(fixed op1) {
+  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_INF_POS(op1) | FIX_IS_INF_NEG(op1);
+
+  return fix_tan_frac_exact(fix_turns_circle_frac(op1), isnan);
+}
+
+void fix_sincos_turns(fixed op1, fixed* sinx, fixed* cosx) {
+  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_INF_POS(op1) | FIX_IS_INF_NEG(op1);
+
+  fixed s, c;
+  fix_sincos_frac(fix_turns_circle_frac(op1), &s, &c);
+
+  *sinx = FIX_IF_NAN(isnan) | MASK_UNLESS(!isnan, s);
+  *cosx = FIX_IF_NAN(isnan) | MASK_UNLESS(!isnan, c);
+}
+
+fixed fix_sinpi(fixed op1) {
+  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_INF_POS(op1) | FIX_IS_INF_NEG(op1);
+
+  return FIX_IF_NAN(isnan) | fix_sin_frac(fix_halfturns_circle_frac(op1));
+}
+
+fixed fix_cospi(fixed op1) {
+  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_INF_POS(op1) | FIX_IS_INF_NEG(op1);
+
+  return FIX_IF_NAN(isnan) | fix_cos_frac(fix_halfturns_circle_frac(op1));
+}
+
+fixed fix_tanpi(fixed op1) {
+  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_INF_POS(op1) | FIX_IS_INF_NEG(op1);
+
+  return fix_tan_frac_exact(fix_halfturns_circle_frac(op1), isnan);
+}
+
+void fix_sincospi(fixed op1, fixed* sinx, fixed* cosx) {
+  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_INF_POS(op1) | FIX_IS_INF_NEG(op1);
+
+  fixed s, c;
+  fix_sincos_frac(fix_halfturns_circle_frac(op1), &s, &c);
+
+  *sinx = FIX_IF_NAN(isnan) | MASK_UNLESS(!isnan, s);
+  *cosx = FIX_IF_NAN(isnan) | MASK_UNLESS(!isnan, c);
+}
+
+/* The _array versions of sin, cos and sincos run each step on a block of
+ * CORDIC_BLOCK elements at once, with the elements innermost, so the compiler
+ * vectorizes across them (the Makefile adds -ftree-vectorize for this file).
+ * The same code is compiled again for AVX2, and used if the CPU has it. The
+ * function and units are the same for the whole call, so branching on them
+ * doesn't depend on the data. */
+#define FIX_TRIG_SIN    0
+#define FIX_TRIG_COS    1
+#define FIX_TRIG_SINCOS 2
+
+#define FIX_TRIG_RADIANS   0
+#define FIX_TRIG_TURNS     1
+#define FIX_TRIG_HALFTURNS 2
+
+FIX_INLINE void fix_trig_block(fixed* out1, fixed* out2, const fixed* op1, size_t n,
+    int function, int units) {
+  fixed x[CORDIC_BLOCK];
+  fix_internal frac[CORDIC_BLOCK];
+  fix_internal Z[CORDIC_BLOCK];
+  fix_internal C[CORDIC_BLOCK];
+  fix_internal S[CORDIC_BLOCK];
+
+  for(size_t j = 0; j < CORDIC_BLOCK; j++) {
+    x[j] = op1[j < n ? j : 0];
+  }
+
+  if(units == FIX_TRIG_RADIANS) {
+    uint64_t acc[CORDIC_BLOCK];
+    uint64_t q[CORDIC_BLOCK];
+    int64_t shiftamount[CORDIC_BLOCK];
+
+    for(size_t j = 0; j < CORDIC_BLOCK; j++) {
+      fix_circle_frac_start(x[j], &acc[j], &shiftamount[j]);
+      q[j] = 0;
+    }
+
+    // Every element divides by the same thing, so there's one base.
+    uint64_t base = FIX_CIRCLE_FRAC_BASE;
+    for(int i = 63; i >= 0; i--) {
+      for(size_t j = 0; j < CORDIC_BLOCK; j++) {
+        uint64_t b = base;
+        fix_div_64_round(&acc[j], &b, &q[j]);
+      }
+      base = base >> 1;
+    }
+
+    for(size_t j = 0; j < CORDIC_BLOCK; j++) {
+      frac[j] = fix_circle_frac_finish(x[j], q[j], shiftamount[j]);
+    }
+  } else if(units == FIX_TRIG_TURNS) {
+    for(size_t j = 0; j < CORDIC_BLOCK; j++) {
+      frac[j] = fix_turns_circle_frac(x[j]);
+    }
+  } else {
+    for(size_t j = 0; j < CORDIC_BLOCK; j++) {
+      frac[j] = fix_halfturns_circle_frac(x[j]);
+    }
+  }
+
+  if(function == FIX_TRIG_COS) {
+    for(size_t j = 0; j < CORDIC_BLOCK; j++) {
+      Z[j] = fix_cos_reduce(frac[j]);
+    }
+  } else {
+    for(size_t j = 0; j < CORDIC_BLOCK; j++) {
+      Z[j] = fix_sin_reduce(frac[j]);
+    }
+  }
+
+  cordic_block(Z, C, S);
+
+  if(function == FIX_TRIG_SINCOS) {
+    for(size_t j = 0; j < n; j++) {
+      fixed isnan = FIX_IS_NAN(x[j]) | FIX_IS_INF_POS(x[j]) | FIX_IS_INF_NEG(x[j]);
+      fixed s = fix_cordic_to_fixed(S[j]);
+      fixed c = fix_cordic_to_fixed(fix_sincos_cos(frac[j], C[j]));
+      out1[j] = FIX_IF_NAN(isnan) | MASK_UNLESS(!isnan, s);
+      out2[j] = FIX_IF_NAN(isnan) | MASK_UNLESS(!isnan, c);
+    }
+  } else {
+    for(size_t j = 0; j < n; j++) {
+      fixed isnan = FIX_IS_NAN(x[j]) | FIX_IS_INF_POS(x[j]) | FIX_IS_INF_NEG(x[j]);
+      out1[j] = FIX_IF_NAN(isnan) | fix_cordic_to_fixed(S[j]);
+    }
+  }
+}
+
+/* out2 is only written for FIX_TRIG_SINCOS. */
+FIX_INLINE void fix_trig_blocks(fixed* out1, fixed* out2, const fixed* op1, size_t n,
+    int function, int units) {
+  for(size_t i = 0; i < n; i += CORDIC_BLOCK) {
+    size_t b = n - i < CORDIC_BLOCK ? n - i : CORDIC_BLOCK;
+    fix_trig_block(out1 + i, out2 + i, op1 + i, b, function, units);
+  }
+}
+
+#if FIX_X86_SIMD
+/* flatten inlines everything this calls, so all of it is compiled for AVX2. */
+static FIX_AVX2 __attribute__((flatten)) void fix_trig_blocks_avx2(fixed* out1, fixed* out2, const fixed* op1,
+    size_t n, int function, int units) {
+  fix_trig_blocks(out1, out2, op1, n, function, units);
+}
+#endif
+
+static void fix_trig_array(fixed* out1, fixed* out2, const fixed* op1, size_t n,
+    int function, int units) {
+  FIX_USE_AVX2(fix_trig_blocks_avx2(out1, out2, op1, n, function, units));
+  fix_trig_blocks(out1, out2, op1, n, function, units);
+}
+
+void fix_sin_array(fixed* result, const fixed* op1, size_t n) {
+  fix_trig_array(result, result, op1, n, FIX_TRIG_SIN, FIX_TRIG_RADIANS);
+}
+
+void fix_cos_array(fixed* result, const fixed* op1, size_t n) {
+  fix_trig_array(result, result, op1, n, FIX_TRIG_COS, FIX_TRIG_RADIANS);
+}
+
+void fix_sincos_array(fixed* sinx, fixed* cosx, const fixed* op1, size_t n) {
+  fix_trig_array(sinx, cosx, op1, n, FIX_TRIG_SINCOS, FIX_TRIG_RADIANS);
+}
+
+void fix_sin_turns_array(fixed* result, const fixed* op1, size_t n) {
+  fix_trig_array(result, result, op1, n, FIX_TRIG_SIN, FIX_TRIG_TURNS);
+}
+
+void fix_cos_turns_array(fixed* result, const fixed* op1, size_t n) {
+  fix_trig_array(result, result, op1, n, FIX_TRIG_COS, FIX_TRIG_TURNS);
+}
+
+void fix_tan_turns_array(fixed* result, const fixed* op1, size_t n) {
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_tan_turns(op1[i]);
+  }
+}
+
+void fix_sincos_turns_array(fixed* sinx, fixed* cosx, const fixed* op1, size_t n) {
+  fix_trig_array(sinx, cosx, op1, n, FIX_TRIG_SINCOS, FIX_TRIG_TURNS);
+}
+
+void fix_sinpi_array(fixed* result, const fixed* op1, size_t n) {
+  fix_trig_array(result, result, op1, n, FIX_TRIG_SIN, FIX_TRIG_HALFTURNS);
+}
+
+void fix_cospi_array(fixed* result, const fixed* op1, size_t n) {
+  fix_trig_array(result, result, op1, n, FIX_TRIG_COS, FIX_TRIG_HALFTURNS);
+}
+
+void fix_tanpi_array(fixed* result, const fixed* op1, size_t n) {
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_tanpi(op1[i]);
+  }
+}
+
+void fix_sincospi_array(fixed* sinx, fixed* cosx, const fixed* op1, size_t n) {
+  fix_trig_array(sinx, cosx, op1, n, FIX_TRIG_SINCOS, FIX_TRIG_HALFTURNS);
+}
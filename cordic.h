@@ -5,7 +5,87 @@
 #include "internal.h"
 #include "lut.h"
 
-FIX_INLINE void cordic(fix_internal* Zext, fix_internal* Cext, fix_internal* Sext) {
+/* Computes x * 2^-m, rounded to even, for m >= 1. This is exactly what
+ * FIX_MUL_INTERN(2^-m, x) gives, without the multiply. The rounding is
+ * ROUND_TO_EVEN_ADDITION's, without the casts to bool, so cordic_block
+ * vectorizes. */
+FIX_INLINE fix_internal cordic_shift(fix_internal x, int m) {
+  fix_internal lowbit       = (x >> m) & 0x1;
+  fix_internal highroundbit = (x >> (m-1)) & 0x1;
+  fix_internal restroundbit = x & ((((fix_internal) 1) << (m-1)) - 1);
+  return SIGN_EX_SHIFT_RIGHT(x, m) +
+    (highroundbit & (lowbit | (restroundbit != 0)));
+}
+
+/* Rather than multiplying by D, which is 1 if Z is positive or -1 if Z is
+ * negative, keep neg: all ones if Z is negative and zero otherwise. Then
+ * D * x is (x ^ neg) - neg. */
+#define CORDIC_NEG(Z) SIGN_EX_SHIFT_RIGHT(Z, (FIX_INTERN_FRAC_BITS + FIX_INTERN_INT_BITS -1))
+
+/* Sets up C, S and neg for the first of the iterations in cordic_step, and
+ * takes what it has done off of Z. Z comes in as a fix_internal, and has
+ * CORDIC_FRAC_BITS fraction bits from here on. */
+FIX_INLINE void cordic_start(fix_internal* Z, fix_internal* C, fix_internal* S,
+    fix_internal* neg) {
+  *Z = *Z << (CORDIC_FRAC_BITS - FIX_INTERN_FRAC_BITS);
+
+  CORDIC_LUT;
+
+  fix_internal C_;
+  fix_internal S_;
+
+  *C = CORDIC_P;
+  *S = 0;
+  *neg = CORDIC_NEG(*Z);
+
+  /* The multiplies by 2^-m are just shifts. For m = 0, there's not even that. */
+  *Z = *Z - ((cordic_lut[0] ^ *neg) - *neg);
+
+  C_ = *C - ((*S ^ *neg) - *neg);
+  S_ = *S + ((*C ^ *neg) - *neg);
+
+  *C = C_;
+  *S = S_;
+  *neg = CORDIC_NEG(*Z);
+}
+
+/* One iteration: rotates by angle = atan(2^-m), in whichever direction brings
+ * Z towards 0. */
+FIX_INLINE void cordic_step(fix_internal* Z, fix_internal* C, fix_internal* S,
+    fix_internal* neg, fix_internal angle, int m) {
+  /* generate the m+1th values of Z, C, S, and D */
+  *Z = *Z - ((angle ^ *neg) - *neg);
+
+  fix_internal C_ = *C - ((cordic_shift(*S, m) ^ *neg) - *neg);
+  fix_internal S_ = *S + ((cordic_shift(*C, m) ^ *neg) - *neg);
+
+  *C = C_;
+  *S = S_;
+  *neg = CORDIC_NEG(*Z);
+}
+
+/* After the iterations, what's left of Z is under 2^-(CORDIC_N-1), and so is
+ * theta, the angle it stands for in radians. Rather than keep halving it, turn
+ * C and S through it in one go: C - theta * S and S + theta * C are the
+ * rotation by atan(theta), which is within theta^3 / 3 of theta, times
+ * sqrt(1 + theta^2). The generator picks CORDIC_N so that the gain is under a
+ * quarter of an epsilon. */
+FIX_INLINE void cordic_finish(fix_internal Z, fix_internal* C, fix_internal* S) {
+  uint8_t overflow = 0;
+  fix_internal theta = MUL_64_N(Z, CORDIC_HALF_PI, overflow, CORDIC_FRAC_BITS);
+
+  fix_internal C_ = *C - MUL_64_N(*S, theta, overflow, CORDIC_FRAC_BITS);
+  fix_internal S_ = *S + MUL_64_N(*C, theta, overflow, CORDIC_FRAC_BITS);
+
+  *C = C_;
+  *S = S_;
+}
+
+/* Computes C = cos(Z) and S = sin(Z), where Z is a circle fraction in [-1, 1].
+ * C and S have CORDIC_FRAC_BITS fraction bits, two more than a fix_internal, and
+ * so does Z while it runs, so that the roundings in each iteration (and in each
+ * of cordic_lut's angles) don't add up to much. */
+FIX_INLINE void cordic(fix_internal Z, fix_internal* Cext, fix_internal* Sext) {
   /* See http://math.exeter.edu/rparris/peanut/cordic.pdf for the best
    * explanation of CORDIC I've found.
    */
@@ -18,39 +98,43 @@ FIX_INLINE void cordic(fix_internal* Zext, fix_internal* Cext, fix_internal* Sex
    */
   CORDIC_LUT;
 
-  fix_internal Z = *Zext;
-  fix_internal C = *Cext;
-  fix_internal S = *Sext;
+  fix_internal C;
+  fix_internal S;
+  fix_internal neg;
 
-  fix_internal C_ = 0;
-  fix_internal S_ = 0;
-  fix_internal pow2 = 0;
+  cordic_start(&Z, &C, &S, &neg);
 
-  /* D should be 1 if Z is positive, or -1 if Z is negative. */
-  fix_internal D = SIGN_EX_SHIFT_RIGHT(Z, (FIX_INTERN_FRAC_BITS + FIX_INTERN_INT_BITS -1)) | 1;
+  for(int m = 1; m < CORDIC_N; m++) {
+    cordic_step(&Z, &C, &S, &neg, cordic_lut[m], m);
+  }
+  cordic_finish(Z, &C, &S);
 
-  uint8_t overflow = 0;
+  *Cext = C;
+  *Sext = S;
+}
 
-  for(int m = 0; m < CORDIC_N; m++) {
-    pow2 = ((fix_internal) 2) << (FIX_INTERN_FRAC_BITS - 1 - m);
+/* cordic, on CORDIC_BLOCK circle fractions at once. Each iteration runs across
+ * the whole block, so the compiler can vectorize it. Z is clobbered. */
+#define CORDIC_BLOCK 32
 
-    /* generate the m+1th values of Z, C, S, and D */
-    Z = Z - D * cordic_lut[m];
+FIX_INLINE void cordic_block(fix_internal* Z, fix_internal* C, fix_internal* S) {
+  CORDIC_LUT;
 
-    C_ = C - D*FIX_MUL_INTERN(pow2, S, overflow);
-    S_ = S + D*FIX_MUL_INTERN(pow2, C, overflow);
+  fix_internal neg[CORDIC_BLOCK];
 
-    C = C_;
-    S = S_;
-    D = SIGN_EX_SHIFT_RIGHT(Z, (FIX_INTERN_FRAC_BITS + FIX_INTERN_INT_BITS -1)) | 1;
+  for(size_t j = 0; j < CORDIC_BLOCK; j++) {
+    cordic_start(&Z[j], &C[j], &S[j], &neg[j]);
   }
 
-  *Zext = Z;
-  *Cext = C;
-  *Sext = S;
-
-  return;
+  for(int m = 1; m < CORDIC_N; m++) {
+    for(size_t j = 0; j < CORDIC_BLOCK; j++) {
+      cordic_step(&Z[j], &C[j], &S[j], &neg[j], cordic_lut[m], m);
+    }
+  }
 
+  for(size_t j = 0; j < CORDIC_BLOCK; j++) {
+    cordic_finish(Z[j], &C[j], &S[j]);
+  }
 }
 
 #endif
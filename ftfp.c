@@ -1,5 +1,6 @@
 #include "ftfp.h"
 #include "internal.h"
+#include "lut.h"
 #include <math.h>
 
 #include <stdint.h>
@@ -27,31 +28,7 @@ int8_t fix_ne(fixed op1, fixed op2) {
 }
 
 int8_t fix_cmp(fixed op1, fixed op2) {
-  uint32_t nans = !!(FIX_IS_NAN(op1) | FIX_IS_NAN(op2));
-
-  uint32_t pos1 = !FIX_IS_NEG(op1);
-  uint32_t pos2 = !FIX_IS_NEG(op2);
-
-  uint32_t gt = (  FIX_IS_INF_POS(op1)  & (!FIX_IS_INF_POS(op2))) |
-                ((!FIX_IS_INF_NEG(op1)) &   FIX_IS_INF_NEG(op2));
-  uint32_t lt = ((!FIX_IS_INF_POS(op1)) &   FIX_IS_INF_POS(op2)) |
-                  (FIX_IS_INF_NEG(op1)  & (!FIX_IS_INF_NEG(op2)));
-
-  gt |= (!lt) & (pos1 & (!pos2));
-  lt |= (!gt) & ((!pos1) & pos2);
-
-  uint32_t cmp_gt = ((fixed) (op1) > (fixed) (op2));
-  uint32_t cmp_lt = ((fixed) (op1) < (fixed) (op2));
-
-  int8_t result =
-    MASK_UNLESS( nans, 1 ) |
-    MASK_UNLESS( !nans,
-        MASK_UNLESS( gt, 1) |
-        MASK_UNLESS( lt, -1) |
-        MASK_UNLESS(!(gt|lt),
-          MASK_UNLESS(cmp_gt, 1) |
-          MASK_UNLESS(cmp_lt, -1)));
-  return result;
+  return fix_cmp_inline(op1, op2);
 }
 
 uint8_t fix_le(fixed op1, fixed op2) {
@@ -84,38 +61,11 @@ uint8_t fix_gt(fixed op1, fixed op2) {
 
 
 fixed fix_neg(fixed op1){
-  // Flip our infs
-  // NaN is still NaN
-  // Because we're two's complement, FIX_MIN has no inverse. Make it positive
-  // infinity...
-  uint8_t isinfpos = FIX_IS_INF_NEG(op1) | (op1 == FIX_MIN);
-  uint8_t isinfneg = FIX_IS_INF_POS(op1);
-  uint8_t isnan = FIX_IS_NAN(op1);
-
-  // 2s comp negate the data bits
-  fixed tempresult = FIX_DATA_BITS(((~op1) + 4));
-
-  // Combine
-  return FIX_IF_NAN(isnan) |
-    FIX_IF_INF_POS(isinfpos & (!isnan)) |
-    FIX_IF_INF_NEG(isinfneg & (!isnan)) |
-    FIX_DATA_BITS(tempresult);
+  return fix_neg_inline(op1);
 }
 
 fixed fix_abs(fixed op1){
-  uint8_t isinfpos = FIX_IS_INF_POS(op1);
-  uint8_t isinfneg = FIX_IS_INF_NEG(op1);
-  uint8_t isnan = FIX_IS_NAN(op1);
-
-  fixed tempresult = MASK_UNLESS(FIX_TOP_BIT(~op1),                  op1       ) |
-                     MASK_UNLESS(FIX_TOP_BIT( op1), FIX_DATA_BITS(((~op1) + 4)));
-
-  /* check for FIX_MIN */
-  isinfpos |= (!(isinfpos | isinfneg)) & (!!FIX_TOP_BIT(op1)) & (op1 == tempresult);
-
-  return FIX_IF_NAN(isnan) |
-    FIX_IF_INF_POS((isinfpos | isinfneg) & (!isnan)) |
-    FIX_DATA_BITS(tempresult);
+  return fix_abs_inline(op1);
 }
 
 fixed fix_sub(fixed op1, fixed op2) {
@@ -144,87 +94,236 @@ fixed fix_sub(fixed op1, fixed op2) {
  *  Nan    Inf      NaN
  */
 fixed fix_div(fixed op1, fixed op2) {
-  uint8_t isinf = 0;
+  return fix_div_inline(op1, op2);
+}
+
 
-  fixed tempresult = fix_div_64(op1, op2, &isinf);
+fixed fix_mul(fixed op1, fixed op2) {
+  return fix_mul_inline(op1, op2);
+}
 
-  uint8_t divbyzero = op2 == FIX_ZERO;
+/* op1 * k, computed exactly with one 64x64 -> 128 multiply instead of
+ * converting k first. Special cases follow fix_mul: Inf * 0 is 0. */
+fixed fix_mul_i64(fixed op1, int64_t k) {
+  uint8_t isinfop1 = FIX_IS_INF_POS(op1) | FIX_IS_INF_NEG(op1);
+  uint8_t isnan = FIX_IS_NAN(op1);
+  uint8_t kneg = ((uint64_t) k) >> 63;
+  uint8_t isnegop1 = FIX_IS_INF_NEG(op1) | (FIX_IS_NEG(op1) & !isinfop1);
+  uint8_t neg = isnegop1 ^ kneg;
 
-  uint8_t isinfop1 = (FIX_IS_INF_NEG(op1) | FIX_IS_INF_POS(op1));
-  uint8_t isinfop2 = (FIX_IS_INF_NEG(op2) | FIX_IS_INF_POS(op2));
+  fixed data = FIX_DATA_BITS(op1);
+  uint64_t a = FIX_ABS_64(data);
+  uint64_t ku = (uint64_t) k;
+  uint64_t absk = MASK_UNLESS_64( kneg, (~ku) + 1) |
+                  MASK_UNLESS_64(!kneg, ku);
 
+  uint64_t hi;
+  uint64_t lo;
+  UNSAFE_UNSIGNED_MUL_64_64_128(a, absk, lo, hi);
+
+  // The product fits if it's at most FIX_MAX, or FIX_MIN's magnitude if negative.
+  uint64_t limit = MASK_UNLESS_64( neg, ((uint64_t) 1) << 63) |
+                   MASK_UNLESS_64(!neg, (uint64_t) FIX_DATA_BITS(FIX_MAX));
+  uint8_t overflow = (hi != 0) | (lo > limit);
+
+  uint8_t isinf = (!isnan) & (k != 0) & (isinfop1 | overflow);
+
+  fixed result = MASK_UNLESS( neg, (~lo) + 1) |
+                 MASK_UNLESS(!neg, lo);
+
+  return FIX_IF_NAN(isnan) |
+    FIX_IF_INF_POS(isinf & !neg) |
+    FIX_IF_INF_NEG(isinf & neg) |
+    MASK_UNLESS(!(isnan | isinf), FIX_DATA_BITS(result));
+}
+
+/* Computes a / k rounded to even, for a < 2^62 and k >= 1. r is
+ * uint64_recip(k << (63 - logk)), where logk is floor(log2(k)), so a / k is a *
+ * r / 2^(63 + logk); that fits in 64 bits, and is within a couple of units. We
+ * fix those up with the exact remainder, like fix_div_recip. */
+FIX_INLINE uint64_t fix_udiv_round(uint64_t a, uint64_t k, uint64_t r, uint8_t logk) {
+  uint64_t hi;
+  uint64_t lo;
+  UNSAFE_UNSIGNED_MUL_64_64_128(a, r, lo, hi);
+  uint64_t q = ((hi << 1) | (lo >> 63)) >> logk;
+
+  // remainder = a - q * k
+  UNSAFE_UNSIGNED_MUL_64_64_128(q, k, lo, hi);
+  uint64_t remlow  = a - lo;
+  uint64_t remhigh = 0 - hi - (a < lo);
+
+  for(int i = 0; i < 2; i++) {
+    uint8_t remneg = remhigh >> 63;
+    uint8_t big = (!remneg) & ((remhigh != 0) | (remlow >= k));
+
+    uint64_t addlow  = MASK_UNLESS_64(remneg, k) | MASK_UNLESS_64(big, (~k) + 1);
+    uint64_t addhigh = MASK_UNLESS_64(big, ~((uint64_t) 0));
+
+    remlow += addlow;
+    remhigh += addhigh + (remlow < addlow);
+    q = q + big - remneg;
+  }
+
+  // The remainder is in [0, k) now, and k < 2^64, so doubling it is safe if
+  // we keep the carry.
+  uint64_t tworem = remlow << 1;
+  uint8_t carry = remlow >> 63;
+  q += carry | (tworem > k) | ((tworem == k) & (q & 1));
+
+  return q;
+}
+
+/* op1 / k, rounded to even. Rather than fix_div's 64 rounds of long division,
+ * this multiplies by a reciprocal of k (see fix_udiv_round). Special cases
+ * follow fix_div:
+ * 0 / 0 is NaN, anything else over 0 is Inf with op1's sign. */
+fixed fix_div_i64(fixed op1, int64_t k) {
+  uint8_t isinfop1 = FIX_IS_INF_POS(op1) | FIX_IS_INF_NEG(op1);
+  uint8_t kneg = ((uint64_t) k) >> 63;
+  uint8_t kzero = k == 0;
   uint8_t isnegop1 = FIX_IS_INF_NEG(op1) | (FIX_IS_NEG(op1) & !isinfop1);
-  uint8_t isnegop2 = FIX_IS_INF_NEG(op2) | (FIX_IS_NEG(op2) & !isinfop2);
+  uint8_t neg = isnegop1 ^ kneg;
+
+  uint8_t isnan = FIX_IS_NAN(op1) | ((op1 == FIX_ZERO) & kzero);
 
-  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_NAN(op2) | ((op1 == FIX_ZERO) & (op2 == FIX_ZERO));
+  fixed data = FIX_DATA_BITS(op1);
+  uint64_t a = FIX_ABS_64(data) >> FIX_FLAG_BITS;
+  uint64_t ku = (uint64_t) k;
+  uint64_t absk = MASK_UNLESS_64( kneg, (~ku) + 1) |
+                  MASK_UNLESS_64(!kneg, ku);
+  absk |= kzero;
 
-  isinf = (isinf | isinfop1) & (!isnan);
-  uint8_t isinfpos = (isinf & !(isnegop1 ^ isnegop2)) | (divbyzero & !isnegop1);
-  uint8_t isinfneg = (isinf & (isnegop1 ^ isnegop2)) | (divbyzero & isnegop1);
+  uint8_t logk = uint64_log2(absk);
+  uint64_t q = fix_udiv_round(a, absk, uint64_recip(absk << (63 - logk)), logk);
 
-  uint8_t iszero = (!(isinfop1)) & isinfop2;
+  // Only FIX_MIN / -1 can overflow.
+  uint8_t overflow = (!neg) & (q >= (((uint64_t) 1) << (FIX_BITS - FIX_FLAG_BITS - 1)));
+
+  uint8_t isinf = (!isnan) & (kzero | isinfop1 | overflow);
+  uint8_t isinfneg = MASK_UNLESS(kzero, isnegop1) | MASK_UNLESS(!kzero, neg);
+
+  uint64_t result = q << FIX_FLAG_BITS;
+  result = MASK_UNLESS_64( neg, (~result) + 1) |
+           MASK_UNLESS_64(!neg, result);
 
   return FIX_IF_NAN(isnan) |
-    FIX_IF_INF_POS(isinfpos & (!isnan) & (!iszero)) |
-    FIX_IF_INF_NEG(isinfneg & (!isnan) & (!iszero)) |
-    MASK_UNLESS(!iszero, FIX_DATA_BITS(tempresult));
+    FIX_IF_INF_POS(isinf & !isinfneg) |
+    FIX_IF_INF_NEG(isinf & isinfneg) |
+    MASK_UNLESS(!(isnan | isinf), FIX_DATA_BITS(result));
 }
 
+void fix_mul_i64_array(fixed* result, const fixed* op1, const int64_t* k, size_t n) {
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_mul_i64(op1[i], k[i]);
+  }
+}
 
-fixed fix_mul(fixed op1, fixed op2) {
+void fix_div_i64_array(fixed* result, const fixed* op1, const int64_t* k, size_t n) {
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_div_i64(op1[i], k[i]);
+  }
+}
 
-  uint8_t isinfop1 = (FIX_IS_INF_NEG(op1) | FIX_IS_INF_POS(op1));
-  uint8_t isinfop2 = (FIX_IS_INF_NEG(op2) | FIX_IS_INF_POS(op2));
-  uint8_t isnegop1 = FIX_IS_INF_NEG(op1) | (FIX_IS_NEG(op1) & !isinfop1);
-  uint8_t isnegop2 = FIX_IS_INF_NEG(op2) | (FIX_IS_NEG(op2) & !isinfop2);
 
-  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_NAN(op2);
-  uint8_t isinf = 0;
+fixed fix_add(fixed op1, fixed op2) {
+  return fix_add_inline(op1, op2);
+}
 
-  uint8_t iszero = (op1 == FIX_ZERO) | (op2 == FIX_ZERO);
+fixed fix_floor(fixed op1) {
+  uint8_t isinfpos = FIX_IS_INF_POS(op1);
+  uint8_t isinfneg = FIX_IS_INF_NEG(op1);
+  uint8_t isnan = FIX_IS_NAN(op1);
 
-  fixed tmp = ROUND_TO_EVEN(FIX_MUL_64(op1, op2, isinf), FIX_FLAG_BITS) << FIX_FLAG_BITS;
+  fixed tempresult = op1 & ~((1ull << (FIX_POINT_BITS))-1);
 
-  isinf = (!iszero) & (isinfop1 | isinfop2 | isinf) & (!isnan);
+  return FIX_IF_NAN(isnan) |
+    FIX_IF_INF_POS(isinfpos & (!isnan)) |
+    FIX_IF_INF_NEG(isinfneg & (!isnan)) |
+    FIX_DATA_BITS(tempresult);
+}
+
+fixed fix_ceil(fixed op1) {
+  uint8_t isinfpos = FIX_IS_INF_POS(op1);
+  uint8_t isinfneg = FIX_IS_INF_NEG(op1);
+  uint8_t isnan = FIX_IS_NAN(op1);
+  uint8_t ispos = !FIX_IS_NEG(op1);
 
-  uint8_t isinfpos = isinf & !(isnegop1 ^ isnegop2);
-  uint8_t isinfneg = isinf & (isnegop1 ^ isnegop2);
+  fixed frac_mask = (((fixed) 1) << (FIX_POINT_BITS))-1;
+
+  fixed tempresult = (op1 & ~frac_mask) +
+    MASK_UNLESS(!!(op1 & frac_mask),  (((fixed) 1) << (FIX_POINT_BITS)));
+
+  // If we used to be positive and we wrapped around, switch to INF_POS.
+  isinfpos |= ((tempresult == FIX_MIN) & ispos);
 
   return FIX_IF_NAN(isnan) |
     FIX_IF_INF_POS(isinfpos & (!isnan)) |
     FIX_IF_INF_NEG(isinfneg & (!isnan)) |
-    FIX_DATA_BITS(tmp);
+    FIX_DATA_BITS(tempresult);
 }
 
+/* Rounds op1 to a multiple of 2^s (in raw units), ties to even. s is in
+ * [FIX_FLAG_BITS, 64]; at 64, everything rounds to 0.
+ *
+ * Everything here is kept 64 bits wide (no uint8_t flags), so that the _array
+ * loops below vectorize. */
+FIX_INLINE fixed fix_round_shift(fixed op1, uint64_t s) {
+  uint8_t all = s > 63;
+  s = MASK_UNLESS(!all, s) | MASK_UNLESS(all, 63);
+  fixed keep = MASK_UNLESS(!all, ~((fixed) 0));
 
-fixed fix_add(fixed op1, fixed op2) {
-  uint8_t isnan;
-  uint8_t isinfpos;
-  uint8_t isinfneg;
+  fixed isinfpos = FIX_IS_INF_POS(op1);
+  fixed isinfneg = FIX_IS_INF_NEG(op1);
+  fixed isnan = FIX_IS_NAN(op1);
+  fixed isinf = isinfpos | isinfneg;
+
+  fixed data = FIX_DATA_BITS(op1);
+  fixed unit = ((fixed) 1) << s;
+
+  fixed lowbit = (data >> s) & 0x1;
+  fixed highroundbit = (data >> (s - 1)) & 0x1;
+  fixed restroundbits = data & ((unit >> 1) - 1);
+  fixed roundup = highroundbit & (lowbit | (restroundbits != 0));
 
-  fixed tempresult;
+  fixed tempresult = ((data & ~(unit - 1)) + (roundup << s)) & keep;
 
-  isnan = FIX_IS_NAN(op1) | FIX_IS_NAN(op2);
-  isinfpos = FIX_IS_INF_POS(op1) | FIX_IS_INF_POS(op2);
-  isinfneg = FIX_IS_INF_NEG(op1) | FIX_IS_INF_NEG(op2);
+  /* If we used to be positive and we wrapped around, switch to INF_POS. The
+   * specials can carry data bits, so only do that for real numbers. */
+  isinfpos |= (((~data) & tempresult) >> (FIX_BITS - 1)) & !(isnan | isinf);
 
-  tempresult = op1 + op2;
+  fixed excep = isnan | isinfpos | isinfneg;
 
-  // check if we're overflowing: adding two positive numbers that results in a
-  // 'negative' number:
-  //   if both inputs are positive (top bit == 0) and the result is 'negative'
-  //   (top bit nonzero)
-  isinfpos |= ((FIX_TOP_BIT(op1) | FIX_TOP_BIT(op2)) == 0x0)
-    & (FIX_TOP_BIT(tempresult) != 0x0);
+  return FIX_IF_NAN(isnan) |
+    FIX_IF_INF_POS(isinfpos & (!isnan)) |
+    FIX_IF_INF_NEG(isinfneg & (!isnan)) |
+    MASK_UNLESS(!excep, tempresult);
+}
+
+FIX_INLINE uint64_t fix_round_to_bits_shift(int32_t frac_bits) {
+  int64_t s = ((int64_t) FIX_POINT_BITS) - frac_bits;
+  uint8_t low = s < FIX_FLAG_BITS;
+  uint8_t high = s > 64;
 
-  // check if there's negative infinity overflow
-  isinfneg |= ((FIX_TOP_BIT(op1) & FIX_TOP_BIT(op2)) == FIX_TOP_BIT_MASK)
-    & (FIX_TOP_BIT(tempresult) == 0x0);
+  return MASK_UNLESS(low, FIX_FLAG_BITS) |
+         MASK_UNLESS(high, 64) |
+         MASK_UNLESS(!(low | high), (uint64_t) s);
+}
+
+fixed fix_round(fixed op1) {
+  return fix_round_shift(op1, FIX_POINT_BITS);
+}
+
+FIX_INLINE fixed fix_round_toward_zero(fixed op1) {
+  uint8_t isinfpos = FIX_IS_INF_POS(op1);
+  uint8_t isinfneg = FIX_IS_INF_NEG(op1);
+  uint8_t isnan = FIX_IS_NAN(op1);
+  uint8_t isneg = FIX_IS_NEG(op1);
 
-  // Force infpos to win in cases where it is unclear
-  isinfneg &= !isinfpos;
+  fixed frac_mask = (((fixed) 1) << (FIX_POINT_BITS))-1;
 
-  // do some horrible bit-ops to make result into what we want
+  // Negative numbers round up; that can't overflow.
+  fixed tempresult = (op1 & ~frac_mask) +
+    MASK_UNLESS(isneg & !!(op1 & frac_mask), (((fixed) 1) << (FIX_POINT_BITS)));
 
   return FIX_IF_NAN(isnan) |
     FIX_IF_INF_POS(isinfpos & (!isnan)) |
@@ -232,37 +331,311 @@ fixed fix_add(fixed op1, fixed op2) {
     FIX_DATA_BITS(tempresult);
 }
 
-fixed fix_floor(fixed op1) {
+fixed fix_trunc(fixed op1) {
+  return fix_round_toward_zero(op1);
+}
+
+fixed fix_round_to_bits(fixed op1, int32_t frac_bits) {
+  return fix_round_shift(op1, fix_round_to_bits_shift(frac_bits));
+}
+
+/* Rounds op1 to the nearest multiple of 10^-digits, ties to even, then to the
+ * nearest fixed.
+ *
+ * With v = |op1| / FIX_EPSILON and F = FIX_FRAC_BITS, op1 * 10^digits is
+ * v * 5^digits / 2^(F - digits). Rounding that to an integer n moves it by
+ * e / 2^(F - digits) for some |e| <= 2^(F - digits - 1), so n / 10^digits is
+ * exactly v + e / 5^digits epsilons. We only need the low F - digits + 1 bits
+ * of v * 5^digits to find e, so 5^digits mod 2^64 will do; and we only divide
+ * by 5^digits while it fits in 64 bits, since past that e / 5^digits rounds to
+ * 0 anyway. */
+fixed fix_round_decimal(fixed op1, int32_t digits) {
+  static const POW5_LUT;
+  static const POW5_RECIP_LUT;
+  static const POW5_LOG_LUT;
+
+  uint8_t isinfpos = FIX_IS_INF_POS(op1);
+  uint8_t isinfneg = FIX_IS_INF_NEG(op1);
+  uint8_t isnan = FIX_IS_NAN(op1) | (digits < 0);
+  uint8_t neg = FIX_IS_NEG(op1);
+
+  // Every fixed is already a multiple of 10^-F.
+  uint8_t exact = digits >= FIX_FRAC_BITS;
+  uint32_t d = MASK_UNLESS_32(!(exact | isnan), digits);
+  uint32_t dd = MASK_UNLESS_32(d < POW5_EXACT, d) | MASK_UNLESS_32(d >= POW5_EXACT, POW5_EXACT - 1);
+
+  fixed data = FIX_DATA_BITS(op1);
+  uint64_t v = FIX_ABS_64(data) >> FIX_FLAG_BITS;
+
+  uint64_t s = FIX_FRAC_BITS - d;
+  uint64_t unit = ((uint64_t) 1) << s;
+  uint64_t p = v * pow5_lut[d];
+  uint64_t r = p & (unit - 1);
+
+  uint8_t lowbit = (p >> s) & 0x1;
+  uint8_t highroundbit = (r >> (s - 1)) & 0x1;
+  uint64_t restroundbits = r & ((unit >> 1) - 1);
+  uint8_t up = ROUND_TO_EVEN_ADDITION(lowbit, highroundbit, restroundbits);
+
+  uint64_t e = MASK_UNLESS_64(up, unit - r) | MASK_UNLESS_64(!up, r);
+  uint64_t corr = fix_udiv_round(e, pow5_lut[dd], pow5_recip_lut[dd], pow5_log_lut[dd]);
+
+  uint64_t m = MASK_UNLESS_64( up, v + corr) |
+               MASK_UNLESS_64(!up, v - corr);
+  m = MASK_UNLESS_64(!exact, m) | MASK_UNLESS_64(exact, v);
+
+  // Rounding up can take us past FIX_MAX, or FIX_MIN's magnitude if negative.
+  uint64_t limit = (((uint64_t) 1) << (FIX_BITS - FIX_FLAG_BITS - 1)) - !neg;
+  uint8_t overflow = m > limit;
+  isinfpos |= overflow & !neg;
+  isinfneg |= overflow & neg;
+
+  uint64_t result = m << FIX_FLAG_BITS;
+  result = MASK_UNLESS_64( neg, (~result) + 1) |
+           MASK_UNLESS_64(!neg, result);
+
+  return FIX_IF_NAN(isnan) |
+    FIX_IF_INF_POS(isinfpos & (!isnan)) |
+    FIX_IF_INF_NEG(isinfneg & (!isnan)) |
+    MASK_UNLESS(!(isinfpos | isinfneg | isnan), FIX_DATA_BITS(result));
+}
+
+/* These call the inline helpers directly, so the loops have no calls in them
+ * and the compiler is free to vectorize. */
+void fix_round_array(fixed* result, const fixed* op1, size_t n) {
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_round_shift(op1[i], FIX_POINT_BITS);
+  }
+}
+
+void fix_trunc_array(fixed* result, const fixed* op1, size_t n) {
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_round_toward_zero(op1[i]);
+  }
+}
+
+void fix_round_to_bits_array(fixed* result, const fixed* op1, int32_t frac_bits, size_t n) {
+  uint64_t s = fix_round_to_bits_shift(frac_bits);
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_round_shift(op1[i], s);
+  }
+}
+
+void fix_round_decimal_array(fixed* result, const fixed* op1, int32_t digits, size_t n) {
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_round_decimal(op1[i], digits);
+  }
+}
+
+/* Computes |x| mod |y| exactly, as unflagged data bits, and sets *odd if the
+ * truncated quotient is odd.
+ *
+ * x and y share a scale, so this is just an integer remainder of their data
+ * bits. The quotient can have as many bits as the data does (FIX_MAX /
+ * FIX_EPSILON), so the restoring loop always runs over all of them. */
+FIX_INLINE fixed fix_mod_data(fixed x, fixed y, uint8_t* odd) {
+  fixed xd = FIX_DATA_BITS(x);
+  fixed yd = FIX_DATA_BITS(y);
+
+  // FIX_MIN's magnitude doesn't fit in a fixed, but it does fit in a uint64_t.
+  uint64_t a = FIX_ABS_64(xd) >> FIX_FLAG_BITS;
+  uint64_t b = FIX_ABS_64(yd) >> FIX_FLAG_BITS;
+
+  uint64_t r = 0;
+  uint8_t bit = 0;
+  for(int i = FIX_BITS - FIX_FLAG_BITS - 1; i >= 0; i--) {
+    r = (r << 1) | ((a >> i) & 1);
+    bit = r >= b;
+    r -= MASK_UNLESS(bit, b);
+  }
+
+  *odd = bit;
+  return r << FIX_FLAG_BITS;
+}
+
+/* fmod and remainder follow C:
+ *
+ *    x       y        result
+ *  ---------------------------
+ *   NaN      -         NaN
+ *    -      NaN        NaN
+ *  +-Inf     -         NaN
+ *    -       0         NaN
+ *    N     +-Inf        N
+ *
+ * fmod's result has x's sign and is smaller than y in magnitude. remainder
+ * rounds the quotient to the nearest integer, ties to even, so its result is
+ * at most half of y in magnitude. Both are exact. */
+fixed fix_fmod(fixed x, fixed y) {
+  uint8_t isinfy = FIX_IS_INF_POS(y) | FIX_IS_INF_NEG(y);
+  uint8_t isnan = FIX_IS_NAN(x) | FIX_IS_NAN(y) |
+    FIX_IS_INF_POS(x) | FIX_IS_INF_NEG(x) | (y == FIX_ZERO);
+
+  uint8_t odd;
+  fixed r = fix_mod_data(x, y, &odd);
+
+  uint8_t neg = FIX_IS_NEG(x);
+  fixed result = MASK_UNLESS( neg, (~r) + 1) |
+                 MASK_UNLESS(!neg, r);
+  result = MASK_UNLESS( isinfy, x) |
+           MASK_UNLESS(!isinfy, result);
+
+  return FIX_IF_NAN(isnan) | MASK_UNLESS(!isnan, FIX_DATA_BITS(result));
+}
+
+fixed fix_remainder(fixed x, fixed y) {
+  uint8_t isinfy = FIX_IS_INF_POS(y) | FIX_IS_INF_NEG(y);
+  uint8_t isnan = FIX_IS_NAN(x) | FIX_IS_NAN(y) |
+    FIX_IS_INF_POS(x) | FIX_IS_INF_NEG(x) | (y == FIX_ZERO);
+
+  uint8_t odd;
+  fixed r = fix_mod_data(x, y, &odd);
+
+  /* r < |y| <= 2^63, so the doubled remainder and the quotient's rounding
+   * both fit. Rounding up makes the remainder negative. */
+  fixed yd = FIX_DATA_BITS(y);
+  uint64_t b = FIX_ABS_64(yd);
+  uint64_t tworem = ((uint64_t) r) << 1;
+  uint8_t up = (tworem > b) | ((tworem == b) & odd);
+  r -= MASK_UNLESS(up, b);
+
+  uint8_t neg = FIX_IS_NEG(x);
+  fixed result = MASK_UNLESS( neg, (~r) + 1) |
+                 MASK_UNLESS(!neg, r);
+  result = MASK_UNLESS( isinfy, x) |
+           MASK_UNLESS(!isinfy, result);
+
+  return FIX_IF_NAN(isnan) | MASK_UNLESS(!isnan, FIX_DATA_BITS(result));
+}
+
+/* Divides a magnitude (with clear flag bits) by 2^s, rounding to even at
+ * FIX_EPSILON. s can be anything up to 63; past that, everything rounds to 0
+ * anyway. */
+FIX_INLINE uint64_t fix_shift_right_round(uint64_t a, uint64_t s) {
+  uint64_t u = a >> FIX_FLAG_BITS;
+  uint64_t shifted = ROUND_TO_EVEN_64(u, s | (s == 0));
+
+  return (MASK_UNLESS(s == 0, u) | MASK_UNLESS(s != 0, shifted)) << FIX_FLAG_BITS;
+}
+
+fixed fix_ldexp(fixed op1, int32_t exp) {
   uint8_t isinfpos = FIX_IS_INF_POS(op1);
   uint8_t isinfneg = FIX_IS_INF_NEG(op1);
   uint8_t isnan = FIX_IS_NAN(op1);
+  uint8_t neg = FIX_IS_NEG(op1);
 
-  fixed tempresult = op1 & ~((1ull << (FIX_POINT_BITS))-1);
+  fixed data = FIX_DATA_BITS(op1);
+  uint64_t a = FIX_ABS_64(data);
+
+  uint8_t left = exp >= 0;
+  uint64_t s = MASK_UNLESS( left, (uint64_t) exp) |
+               MASK_UNLESS(!left, -((int64_t) exp));
+  uint8_t big = s > 63;
+  s = MASK_UNLESS(!big, s) | MASK_UNLESS(big, 63);
+
+  /* Going left, we overflow if bits fall off the top, or if the result is
+   * past FIX_MAX (or FIX_MIN's magnitude, if we're negative). */
+  uint64_t up = a << s;
+  uint64_t limit = MASK_UNLESS( neg, ((uint64_t) 1) << 63) |
+                   MASK_UNLESS(!neg, (uint64_t) FIX_DATA_BITS(FIX_MAX));
+  uint8_t overflow = left & (a != 0) & (big | ((up >> s) != a) | (up > limit));
+
+  uint64_t down = fix_shift_right_round(a, s);
+
+  uint64_t result = MASK_UNLESS( left, up) |
+                    MASK_UNLESS(!left, down);
+  result = MASK_UNLESS( neg, (~result) + 1) |
+           MASK_UNLESS(!neg, result);
+
+  isinfpos |= overflow & !neg;
+  isinfneg |= overflow & neg;
 
   return FIX_IF_NAN(isnan) |
     FIX_IF_INF_POS(isinfpos & (!isnan)) |
     FIX_IF_INF_NEG(isinfneg & (!isnan)) |
-    FIX_DATA_BITS(tempresult);
+    MASK_UNLESS(!(isinfpos | isinfneg), FIX_DATA_BITS(result));
 }
 
-fixed fix_ceil(fixed op1) {
+fixed fix_frexp(fixed op1, int32_t* exp) {
   uint8_t isinfpos = FIX_IS_INF_POS(op1);
   uint8_t isinfneg = FIX_IS_INF_NEG(op1);
   uint8_t isnan = FIX_IS_NAN(op1);
-  uint8_t ispos = !FIX_IS_NEG(op1);
+  uint8_t neg = FIX_IS_NEG(op1);
 
-  fixed frac_mask = (((fixed) 1) << (FIX_POINT_BITS))-1;
+  fixed data = FIX_DATA_BITS(op1);
+  uint64_t a = FIX_ABS_64(data);
+  uint8_t iszero = a == 0;
 
-  fixed tempresult = (op1 & ~frac_mask) +
-    MASK_UNLESS(!!(op1 & frac_mask),  (((fixed) 1) << (FIX_POINT_BITS)));
+  // |op1| is in [2^(e-1), 2^e), so the mantissa is |op1| / 2^e.
+  int32_t e = ((int32_t) uint64_log2(a)) + 1 - FIX_POINT_BITS;
+  uint8_t down = e >= 0;
+  uint64_t s = MASK_UNLESS( down, (uint64_t) e) |
+               MASK_UNLESS(!down, (uint64_t) -e);
 
-  // If we used to be positive and we wrapped around, switch to INF_POS.
-  isinfpos |= ((tempresult == FIX_MIN) & ispos);
+  /* Dropping bits can round the mantissa up to 1, which we renormalize to
+   * 1/2. That can't overflow: FIX_POINT_BITS < 64. */
+  uint64_t m = MASK_UNLESS( down, fix_shift_right_round(a, s)) |
+               MASK_UNLESS(!down, a << s);
+  uint8_t carry = m >> FIX_POINT_BITS;
+  m >>= carry;
+  e += carry;
+
+  m = MASK_UNLESS( neg, (~m) + 1) |
+      MASK_UNLESS(!neg, m);
+
+  *exp = MASK_UNLESS(!(iszero | isnan | isinfpos | isinfneg), e);
 
   return FIX_IF_NAN(isnan) |
     FIX_IF_INF_POS(isinfpos & (!isnan)) |
     FIX_IF_INF_NEG(isinfneg & (!isnan)) |
-    FIX_DATA_BITS(tempresult);
+    MASK_UNLESS(!iszero, FIX_DATA_BITS(m));
+}
+
+int32_t fix_ilogb(fixed op1) {
+  uint8_t isinf = FIX_IS_INF_POS(op1) | FIX_IS_INF_NEG(op1);
+  uint8_t isnan = FIX_IS_NAN(op1);
+
+  fixed data = FIX_DATA_BITS(op1);
+  uint64_t a = FIX_ABS_64(data);
+  uint8_t iszero = (a == 0) & !(isinf | isnan);
+
+  int32_t e = ((int32_t) uint64_log2(a)) - FIX_POINT_BITS;
+
+  return MASK_UNLESS_32(isnan, FIX_ILOGBNAN) |
+         MASK_UNLESS_32(isinf & !isnan, INT32_MAX) |
+         MASK_UNLESS_32(iszero, FIX_ILOGB0) |
+         MASK_UNLESS_32(!(isnan | isinf | iszero), e);
+}
+
+/* Splits op1 into its integer part, stored in *intpart, and its fractional
+ * part, which is returned. Both have op1's sign, so they round toward zero;
+ * that's where this differs from fix_floor. Infinities have no fractional
+ * part. */
+fixed fix_modf(fixed op1, fixed* intpart) {
+  uint8_t isinfpos = FIX_IS_INF_POS(op1);
+  uint8_t isinfneg = FIX_IS_INF_NEG(op1);
+  uint8_t isnan = FIX_IS_NAN(op1);
+  uint8_t neg = FIX_IS_NEG(op1);
+
+  fixed frac_mask = (((fixed) 1) << (FIX_POINT_BITS))-1;
+
+  fixed data = FIX_DATA_BITS(op1);
+  uint64_t a = FIX_ABS_64(data);
+  fixed whole = a & ~frac_mask;
+  fixed frac = a & frac_mask;
+
+  // FIX_MIN is its own integer part, and negating it gives it back.
+  whole = MASK_UNLESS( neg, (~whole) + 1) |
+          MASK_UNLESS(!neg, whole);
+  frac = MASK_UNLESS( neg, (~frac) + 1) |
+         MASK_UNLESS(!neg, frac);
+
+  *intpart = FIX_IF_NAN(isnan) |
+    FIX_IF_INF_POS(isinfpos & (!isnan)) |
+    FIX_IF_INF_NEG(isinfneg & (!isnan)) |
+    FIX_DATA_BITS(whole);
+
+  return FIX_IF_NAN(isnan) | FIX_DATA_BITS(frac);
 }
 
 //fixed fix_sin_fast(fixed op1) {
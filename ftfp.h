@@ -49,6 +49,9 @@ int8_t fix_ne(fixed op1, fixed op2);
  */
 int8_t fix_cmp(fixed op1, fixed op2);
 
+/* result[i] = fix_cmp(op1[i], op2[i]). */
+void fix_cmp_array(int8_t* result, const fixed* op1, const fixed* op2, size_t n);
+
 uint8_t fix_le(fixed op1, fixed op2);
 uint8_t fix_ge(fixed op1, fixed op2);
 
@@ -63,15 +66,111 @@ fixed fix_sub(fixed op1, fixed op2);
 fixed fix_mul(fixed op1, fixed op2);
 fixed fix_div(fixed op1, fixed op2);
 
+/* Elementwise versions: result[i] = f(op1[i]), f(op1[i], op2[i]), or, for the
+ * _scalar_array forms, f(op1[i], op2). result may alias op1 or op2. These give
+ * exactly what the scalar functions do, but the loops vectorize, and there's
+ * no call per element. On x86 CPUs with AVX2, neg, abs, add, sub and mul (and
+ * cmp, above) run hand-written AVX2 kernels, picked at runtime, and mul uses
+ * AVX-512 IFMA where the CPU has it. */
+void fix_neg_array(fixed* result, const fixed* op1, size_t n);
+void fix_abs_array(fixed* result, const fixed* op1, size_t n);
+
+void fix_add_array(fixed* result, const fixed* op1, const fixed* op2, size_t n);
+void fix_sub_array(fixed* result, const fixed* op1, const fixed* op2, size_t n);
+void fix_mul_array(fixed* result, const fixed* op1, const fixed* op2, size_t n);
+void fix_div_array(fixed* result, const fixed* op1, const fixed* op2, size_t n);
+
+void fix_add_scalar_array(fixed* result, const fixed* op1, fixed op2, size_t n);
+void fix_sub_scalar_array(fixed* result, const fixed* op1, fixed op2, size_t n);
+void fix_mul_scalar_array(fixed* result, const fixed* op1, fixed op2, size_t n);
+void fix_div_scalar_array(fixed* result, const fixed* op1, fixed op2, size_t n);
+
+/* Multiply or divide by an integer without converting it to a fixed first, so
+ * k may be larger than FIX_INT_MAX as long as the result fits. fix_mul_i64 is
+ * exact; fix_div_i64 rounds to even. Special cases are those of fix_mul and
+ * fix_div. */
+fixed fix_mul_i64(fixed op1, int64_t k);
+fixed fix_div_i64(fixed op1, int64_t k);
+
+/* Elementwise: result[i] = f(op1[i], k[i]). result may alias op1. */
+void fix_mul_i64_array(fixed* result, const fixed* op1, const int64_t* k, size_t n);
+void fix_div_i64_array(fixed* result, const fixed* op1, const int64_t* k, size_t n);
+
 fixed fix_floor(fixed op1);
 fixed fix_ceil(fixed op1);
 
+/* Round to the nearest integer with ties to even (fix_round), toward zero
+ * (fix_trunc), or to the nearest multiple of 2^-frac_bits with ties to even
+ * (fix_round_to_bits). frac_bits may be negative, to round to a multiple of a
+ * power of two above 1, and is clamped to FIX_FRAC_BITS above. Rounding up
+ * past FIX_MAX gives Inf. */
+fixed fix_round(fixed op1);
+fixed fix_trunc(fixed op1);
+fixed fix_round_to_bits(fixed op1, int32_t frac_bits);
+
+void fix_round_array(fixed* result, const fixed* op1, size_t n);
+void fix_trunc_array(fixed* result, const fixed* op1, size_t n);
+void fix_round_to_bits_array(fixed* result, const fixed* op1, int32_t frac_bits, size_t n);
+
+/* Rounds to the nearest multiple of 10^-digits, ties to even, and then to the
+ * nearest fixed. The tie is decided on op1's exact value, so this agrees with
+ * printing op1 exactly and rounding the decimal string. digits may be any
+ * non-negative number (past FIX_FRAC_BITS, op1 is returned as is); negative
+ * digits give NaN. Constant time in op1. */
+fixed fix_round_decimal(fixed op1, int32_t digits);
+
+void fix_round_decimal_array(fixed* result, const fixed* op1, int32_t digits, size_t n);
+
+/* The remainder of x / y, with the quotient truncated (fmod) or rounded to
+ * nearest, ties to even (remainder), and the split of a number into integer
+ * and fractional parts. All exact, with C's special cases. */
+fixed fix_fmod(fixed x, fixed y);
+fixed fix_remainder(fixed x, fixed y);
+fixed fix_modf(fixed op1, fixed* intpart);
+
+/* Scaling by powers of two, without a multiply or divide.
+ *
+ * fix_ldexp computes op1 * 2^exp. Results that don't fit become +-Inf, and
+ * bits shifted off the bottom round to even.
+ *
+ * fix_frexp returns a mantissa m with 1/2 <= |m| < 1 and stores exp so that
+ * op1 = m * 2^exp. If m can't hold all of op1's bits, it's rounded to even.
+ * Zero, infinities and NaN come back unchanged, with *exp set to 0.
+ *
+ * fix_ilogb returns floor(log2(|op1|)). Zero gives FIX_ILOGB0, NaN gives
+ * FIX_ILOGBNAN, and infinities give INT32_MAX. */
+#define FIX_ILOGB0   INT32_MIN
+#define FIX_ILOGBNAN INT32_MAX
+
+fixed fix_ldexp(fixed op1, int32_t exp);
+fixed fix_frexp(fixed op1, int32_t* exp);
+int32_t fix_ilogb(fixed op1);
+
 fixed fix_exp(fixed op1);
 fixed fix_ln(fixed op1);
 fixed fix_log2(fixed op1);
 fixed fix_log10(fixed op1);
 
+/* Compute e^x - 1 and ln(1 + x) without losing the low bits of x when x is
+ * near zero. */
+fixed fix_expm1(fixed op1);
+fixed fix_log1p(fixed op1);
+
+/* Elementwise versions: result[i] = f(op1[i]) for i in [0, n). result may alias
+ * op1. */
+void fix_exp_array(fixed* result, const fixed* op1, size_t n);
+void fix_ln_array(fixed* result, const fixed* op1, size_t n);
+void fix_log2_array(fixed* result, const fixed* op1, size_t n);
+void fix_log10_array(fixed* result, const fixed* op1, size_t n);
+void fix_expm1_array(fixed* result, const fixed* op1, size_t n);
+void fix_log1p_array(fixed* result, const fixed* op1, size_t n);
+
 fixed fix_sqrt(fixed op1);
+fixed fix_cbrt(fixed op1);
+
+/* Computes sqrt(x^2 + y^2). The intermediate squares never overflow, so this
+ * only returns Inf if the result itself doesn't fit. */
+fixed fix_hypot(fixed x, fixed y);
 
 /* Computes x^y.
  *
@@ -86,6 +185,68 @@ fixed fix_sin(fixed op1);
 fixed fix_cos(fixed op1);
 fixed fix_tan(fixed op1);
 
+/* Computes sin and cos of the same angle with a single cordic. */
+void fix_sincos(fixed op1, fixed* sinx, fixed* cosx);
+
+/* Elementwise sin, cos and sincos. These run the cordic on blocks of elements
+ * at once, with AVX2 where the CPU has it, and match the scalar functions bit
+ * for bit. */
+void fix_sin_array(fixed* result, const fixed* op1, size_t n);
+void fix_cos_array(fixed* result, const fixed* op1, size_t n);
+void fix_sincos_array(fixed* sinx, fixed* cosx, const fixed* op1, size_t n);
+
+/* Trig on angles measured in turns (1 is a full circle), or in multiples of pi
+ * (fix_sinpi(x) is sin(pi * x)). These skip the reduction by pi/2 entirely,
+ * and are exact at quarter turns; tan is +/- Inf there. */
+fixed fix_sin_turns(fixed op1);
+fixed fix_cos_turns(fixed op1);
+fixed fix_tan_turns(fixed op1);
+void  fix_sincos_turns(fixed op1, fixed* sinx, fixed* cosx);
+
+fixed fix_sinpi(fixed op1);
+fixed fix_cospi(fixed op1);
+fixed fix_tanpi(fixed op1);
+void  fix_sincospi(fixed op1, fixed* sinx, fixed* cosx);
+
+void fix_sin_turns_array(fixed* result, const fixed* op1, size_t n);
+void fix_cos_turns_array(fixed* result, const fixed* op1, size_t n);
+void fix_tan_turns_array(fixed* result, const fixed* op1, size_t n);
+void fix_sincos_turns_array(fixed* sinx, fixed* cosx, const fixed* op1, size_t n);
+
+void fix_sinpi_array(fixed* result, const fixed* op1, size_t n);
+void fix_cospi_array(fixed* result, const fixed* op1, size_t n);
+void fix_tanpi_array(fixed* result, const fixed* op1, size_t n);
+void fix_sincospi_array(fixed* sinx, fixed* cosx, const fixed* op1, size_t n);
+
+/* The error function, its complement, and the standard normal CDF. These are
+ * accurate to about 2^-58. erfc(-x) and erf(x) are close to 2 and 1 for large
+ * x, and saturate to FIX_MAX in builds that can't hold that. */
+fixed fix_erf(fixed op1);
+fixed fix_erfc(fixed op1);
+fixed fix_norm_cdf(fixed op1);
+
+void fix_erf_array(fixed* result, const fixed* op1, size_t n);
+void fix_erfc_array(fixed* result, const fixed* op1, size_t n);
+void fix_norm_cdf_array(fixed* result, const fixed* op1, size_t n);
+
+/* The standard normal quantile (inverse CDF), using Wichura's AS241 rational
+ * approximations. Accurate to about 2^-49, limited by fix_ln's polynomial in
+ * the tails. Returns -Inf at 0, +Inf at 1, and NaN outside [0, 1]. Builds with
+ * 4 or fewer integer bits return +-Inf when the result doesn't fit. */
+fixed fix_norm_ppf(fixed op1);
+
+void fix_norm_ppf_array(fixed* result, const fixed* op1, size_t n);
+
+/* The log of the gamma function, and the log of the beta function, lbeta(a, b)
+ * = lgamma(a) + lgamma(b) - lgamma(a + b). Both run in constant time, and take
+ * positive arguments only; negative ones give NaN. lgamma(0) is +Inf. Results
+ * that don't fit saturate to +-Inf. Accurate to about 2^-44 for arguments
+ * below 16, and to about 2^-46 of the result above that. */
+fixed fix_lgamma(fixed op1);
+fixed fix_lbeta(fixed a, fixed b);
+
+void fix_lgamma_array(fixed* result, const fixed* op1, size_t n);
+
 /* Uses a polynomial approximation of sin. Very quick, but less accurate at the
  * edges. */
 //fixed fix_sin_fast(fixed op1);
@@ -106,6 +267,67 @@ int64_t fix_floor64(fixed op1);
 void fix_sprint(char* buffer, fixed f);
 void fix_sprint_nospecial(char* buffer, fixed f);
 
+/* Prints the fixed in base 10 like fix_sprint, but with exactly ndigits digits
+ * after the point (and no point if ndigits is 0), rounded to nearest with ties
+ * to even. Digits past FIX_FRAC_BITS are 0. Negative ndigits count as 0. The
+ * running time depends only on ndigits. The buffer must be at least
+ * FIX_PRINT_DIGITS_BUFFER_SIZE(ndigits) characters long. */
+#define FIX_PRINT_DIGITS_LENGTH(ndigits) \
+  (1 + FIX_PRINT_INT_CHARS + ((ndigits) > 0 ? (ndigits) + 1 : 0))
+#define FIX_PRINT_DIGITS_BUFFER_SIZE(ndigits) \
+  ((FIX_PRINT_DIGITS_LENGTH(ndigits) > 4 ? FIX_PRINT_DIGITS_LENGTH(ndigits) : 4) + 1)
+
+void fix_sprint_digits(char* buffer, fixed f, int32_t ndigits);
+
+/* Prints the shortest decimal that fix_parse reads back as f, with no padding:
+ * "-12.5", "0.1", "3". If several decimals of that length parse back to f,
+ * it's the nearest one. Infinities and NaN print as "Inf", "-Inf" and "NaN".
+ * The buffer must be at least FIX_PRINT_BUFFER_SIZE characters long.
+ *
+ * fix_sprint_shortest is constant time: it does the work for every digit
+ * count and masks out the unused ones, though the length of the output itself
+ * still depends on f. fix_sprint_shortest_fast stops at the first digit count
+ * that works, so it is much quicker on short outputs, but it is NOT constant
+ * time. Only use it on public data. */
+void fix_sprint_shortest(char* buffer, fixed f);
+void fix_sprint_shortest_fast(char* buffer, fixed f);
+
+/* Prints n fixeds into out, which holds cap characters, separated by sep (or
+ * by nothing, if sep is '\0'). fix_sprint_array writes each one as fix_sprint
+ * does, in fixed width; fix_sprint_shortest_array writes each one as
+ * fix_sprint_shortest does. Only whole elements are written, and out is always
+ * NUL-terminated (if cap isn't 0). Returns the number of elements written.
+ *
+ * Each element is printed in constant time, like the functions they match.
+ * fix_sprint_array works on blocks of elements at once, so it vectorizes. */
+size_t fix_sprint_array(char* out, size_t cap, const fixed* xs, size_t n, char sep);
+size_t fix_sprint_shortest_array(char* out, size_t cap, const fixed* xs, size_t n, char sep);
+
+/* Parses a decimal number from the first len bytes of buf: optional
+ * whitespace, an optional sign, digits with an optional '.', and optional
+ * whitespace. "inf", "infinity" and "nan" (in any case, with a sign) are also
+ * accepted, so fix_sprint's output always parses back to the same value. A
+ * NUL ends the string early. The value is rounded to the nearest fixed, ties
+ * to even, however many digits there are; values too big for a fixed become
+ * +-Inf.
+ *
+ * Returns 0 on success. On malformed input, stores NaN and returns -1. The
+ * running time depends only on len. */
+int8_t fix_parse(const char* buf, size_t len, fixed* result);
+
+/* Parses up to n fields from buf, separated by commas or newlines, into
+ * result, and returns how many it stored. Malformed fields are stored as NaN.
+ * A newline at the very end doesn't start another field. If consumed isn't
+ * NULL, it's set to the number of bytes read, including the last delimiter, so
+ * a caller can pick up where this left off.
+ *
+ * The running time depends only on len. This is not entirely constant time,
+ * though: the slots of result written for each 8 bytes of buf depend on how
+ * many fields end in them, which memory access can show. To keep the rest
+ * constant, a value is worked out at every byte, not just at the delimiters. */
+size_t fix_parse_array(fixed* result, size_t n, const char* buf, size_t len,
+    size_t* consumed);
+
 /* Prints a fixed to STDOUT. */
 void fix_print(fixed f);
 void fix_println(fixed f);
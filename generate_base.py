@@ -127,6 +127,7 @@ if __name__ == "__main__":
 typedef uint64_t fixed;
 
 #define FIX_PRINT_BUFFER_SIZE %d
+#define FIX_PRINT_INT_CHARS %d
 
 #define FIX_PRINTF_HEX "%%016"PRIx64
 #define FIX_PRINTF_DEC "%%"PRId64
@@ -147,7 +148,7 @@ static const fixed fix_e = 0x%016x;
 #define FIX_TAU fix_tau
 #define FIX_E fix_e
 
-#endif"""%(buffer_length, flag_bits, frac_bits, int_bits,
+#endif"""%(buffer_length, int_chars, flag_bits, frac_bits, int_bits,
            internal_frac_bits, internal_int_bits,
            fix_pi,fix_tau,fix_e)
           f.write(baseh)
@@ -169,14 +170,15 @@ static const fixed fix_e = 0x%016x;
             l = ["#define %s_%d ((fix_internal) 0x%016x)"%(name, i, decimal_to_fix_extrabits(x, internal_frac_bits)) for i,x in enumerate(lut)]
             return "\n".join(l) + "\n"
 
-        def make_c_internal_define_lut(lut, name, varname):
-            l = ["  0x%016x"%(decimal_to_fix_extrabits(x, internal_frac_bits)) for x in lut]
+        def make_c_internal_define_lut(lut, name, varname, fracbits = internal_frac_bits):
+            l = ["  0x%016x"%(decimal_to_fix_extrabits(x, fracbits)) for x in lut]
             return "#define %s fix_internal %s[%d] = { \\\n"%(name, varname, len(lut)) + \
                    ",\\\n".join(l) + \
                    "\\\n};\n"
 
-        # note that 1/0 isn't very useful, so just call it 1
-        internal_inv_integer_lut = [Decimal('1')] + [((decimal.Decimal('1')/decimal.Decimal(x))) for x in range(1,25)]
+        # note that 1/0 isn't very useful, so just call it 1. fix_exp's Taylor
+        # loop runs through n = 25, so we need entries up to 1/25.
+        internal_inv_integer_lut = [Decimal('1')] + [((decimal.Decimal('1')/decimal.Decimal(x))) for x in range(1,26)]
         ln_coef_lut = list(reversed([
                Decimal(x) for x in
                  (
@@ -249,19 +251,105 @@ static const fixed fix_e = 0x%016x;
         import mpmath,operator
         mpmath.mp.prec = 100
 
-        tangents = [mpmath.mpf(0.5)**i for i in range(0,61)]
+        # cordic runs cordic_n iterations, then cordic_finish turns through
+        # what's left, under 2^-(cordic_n-1), with a gain of up to
+        # 1 + 2^-(2*cordic_n-1). Keep that under a quarter of an epsilon.
+        cordic_n = (frac_bits + 4) // 2
+
+        tangents = [mpmath.mpf(0.5)**i for i in range(0,cordic_n)]
         angles = [mpmath.atan(tan) for tan in tangents]
         circle_fracs = [angle / (mpmath.pi/2) for angle in angles]
 
-        # To speed up the cordic function, we can ignore fractions that are too
-        # small
-        circle_fracs = [cf for cf in circle_fracs if cf >= mpmath.mpf(0.5)**(frac_bits+2)]
-
         cordic_lut = [decimal.Decimal(str(c)) for c in circle_fracs]
 
         ps = [mpmath.cos(angle) for angle in angles]
         p = decimal.Decimal(str(reduce(operator.mul,ps)))
-        cordic_p = decimal_to_fix_extrabits(p, internal_frac_bits)
+
+        # cordic keeps Z, C and S with two more fraction bits than fix_internal.
+        # They never get to 2, so the extra int bits aren't needed.
+        cordic_frac_bits = internal_frac_bits + 2
+        cordic_p = decimal_to_fix_extrabits(p, cordic_frac_bits)
+        cordic_half_pi = decimal_to_fix_extrabits(Decimal(str(mpmath.pi/2)), cordic_frac_bits)
+
+        # erfc on [0, 7), as one polynomial per unit interval in t = x - c,
+        # where c is the interval's midpoint. Past 7, erfc is below 2^-70.
+        # Degree 19 keeps the fits under 2^-65.
+        erfc_intervals = 7
+        erfc_degree = 19
+        erfc_coef_lut = []
+        for i in range(erfc_intervals):
+            c = i + mpmath.mpf(0.5)
+            coefs = mpmath.chebyfit(lambda t: mpmath.erfc(c + t),
+                                    [-0.5, 0.5], erfc_degree + 1)
+            erfc_coef_lut += [decimal.Decimal(str(x)) for x in coefs]
+
+        # The normal quantile, from Wichura's AS241 (PPND16): three rational
+        # functions of degree 7, good to about 1e-16. Their coefficients are
+        # far too big for a fix_internal, so each region evaluates in u = v *
+        # 2^s instead of v, and divides its numerator and denominator by 2^m.
+        # That keeps every coefficient and Horner partial sum under 4. The s
+        # values must match the shifts in fix_norm_ppf.
+        #
+        # central, |p - 0.5| <= 0.425:  v = 0.180625 - (p - 0.5)^2
+        # near tail, r <= 5:            v = r - 1.6
+        # far tail, r > 5:              v = r - 5, where r = sqrt(-ln(min(p, 1-p)))
+        norm_ppf_regions = [
+            (3, 6,
+             "3.3871328727963666080e0 1.3314166789178437745e+2 1.9715909503065514427e+3 "
+             "1.3731693765509461125e+4 4.5921953931549871457e+4 6.7265770927008700853e+4 "
+             "3.3430575583588128105e+4 2.5090809287301226727e+3",
+             "1.0 4.2313330701600911252e+1 6.8718700749205790830e+2 5.3941960214247511077e+3 "
+             "2.1213794301586595867e+4 3.9307895800092710610e+4 2.8729085735721942674e+4 "
+             "5.2264952788528545610e+3"),
+            (-2, 8,
+             "1.42343711074968357734e0 4.63033784615654529590e0 5.76949722146069140550e0 "
+             "3.64784832476320460504e0 1.27045825245236838258e0 2.41780725177450611770e-1 "
+             "2.27238449892691845833e-2 7.74545014278341407640e-4",
+             "1.0 2.05319162663775882187e0 1.67638483018380384940e0 6.89767334985100004550e-1 "
+             "1.48103976427480074590e-1 1.51986665636164571966e-2 5.47593808499534494600e-4 "
+             "1.05075007164441684324e-9"),
+            (0, 3,
+             "6.65790464350110377720e0 5.46378491116411436990e0 1.78482653991729133580e0 "
+             "2.96560571828504891230e-1 2.65321895265761230930e-2 1.24266094738807843860e-3 "
+             "2.71155556874348757815e-5 2.01033439929228813265e-7",
+             "1.0 5.99832206555887937690e-1 1.36929880922735805310e-1 1.48753612908506148525e-2 "
+             "7.86869131145613259100e-4 1.84631831751005468180e-5 1.42151175831644588870e-7 "
+             "2.04426310338993978564e-15"),
+        ]
+        norm_ppf_degree = 7
+        norm_ppf_coef_lut = []
+        for (s, m, num, den) in norm_ppf_regions:
+            for poly in (num, den):
+                coefs = [mpmath.mpf(x) / 2**(s * i + m) for i, x in enumerate(poly.split())]
+                norm_ppf_coef_lut += [decimal.Decimal(str(x)) for x in reversed(coefs)]
+        norm_ppf_const = [Decimal(x) for x in ("0.425", "0.180625", "1.6", "5")]
+
+        # Stirling's series for lgamma: entry 0 is ln(2 pi) / 2, and entry k is
+        # B_2k / (2k (2k - 1)). fix_lgamma only uses it past 16, where the
+        # eighth term is below 2^-65.
+        lgamma_coef = [decimal.Decimal(str(mpmath.ln(2 * mpmath.pi) / 2))] + \
+            [decimal.Decimal(str(mpmath.bernoulli(2 * k) / (2 * k * (2 * k - 1))))
+             for k in range(1, 9)]
+
+        # Powers of 5 for fix_round_decimal. It needs 5^d mod 2^64 for every d
+        # below FIX_FRAC_BITS, and 5^d itself (with its reciprocal, in
+        # uint64_recip's format, and floor(log2(5^d))) only while 5^d < 2^64;
+        # past that, dividing by it always rounds to 0.
+        pow5_exact = 28
+        pow5_lut = [5**d % 2**64 for d in range(64)]
+        pow5_recip_lut = []
+        pow5_log_lut = []
+        for d in range(pow5_exact):
+            log = (5**d).bit_length() - 1
+            pow5_recip_lut.append(2**126 // (5**d << (63 - log)))
+            pow5_log_lut.append(log)
+
+        def make_c_uint64_define_lut(lut, name, varname):
+            l = ["  0x%016x"%(x) for x in lut]
+            return "#define %s uint64_t %s[%d] = { \\\n"%(name, varname, len(lut)) + \
+                   ",\\\n".join(l) + \
+                   "\\\n};\n"
+
         with args["lutfile"] as f:
             lutc  = '#ifndef LUT_H\n'
             lutc += '#define LUT_H\n'
@@ -278,8 +366,27 @@ static const fixed fix_e = 0x%016x;
             lutc += (make_c_internal_defines(log10_coef_lut, "FIX_LOG10_COEF"))
             lutc += "\n"
             lutc += "#define CORDIC_N %d\n"%(len(cordic_lut))
+            lutc += "#define CORDIC_FRAC_BITS %d\n"%(cordic_frac_bits)
             lutc += "#define CORDIC_P 0x%x\n"%(cordic_p)
-            lutc += (make_c_internal_define_lut(cordic_lut, "CORDIC_LUT", "cordic_lut"))
+            lutc += "#define CORDIC_HALF_PI 0x%x\n"%(cordic_half_pi)
+            lutc += (make_c_internal_define_lut(cordic_lut, "CORDIC_LUT", "cordic_lut", cordic_frac_bits))
+            lutc += "\n"
+            lutc += "#define ERFC_INTERVALS %d\n"%(erfc_intervals)
+            lutc += "#define ERFC_DEGREE %d\n"%(erfc_degree)
+            lutc += (make_c_internal_define_lut(erfc_coef_lut, "ERFC_COEF_LUT", "erfc_coef_lut"))
+            lutc += "\n"
+            lutc += "#define NORM_PPF_REGIONS %d\n"%(len(norm_ppf_regions))
+            lutc += "#define NORM_PPF_DEGREE %d\n"%(norm_ppf_degree)
+            lutc += (make_c_internal_define_lut(norm_ppf_coef_lut, "NORM_PPF_COEF_LUT", "norm_ppf_coef_lut"))
+            lutc += (make_c_internal_defines(norm_ppf_const, "NORM_PPF_CONST"))
+            lutc += "\n"
+            lutc += (make_c_internal_defines(lgamma_coef, "LGAMMA_COEF"))
+            lutc += "\n"
+            lutc += "#define POW5_EXACT %d\n"%(pow5_exact)
+            lutc += (make_c_uint64_define_lut(pow5_lut, "POW5_LUT", "pow5_lut"))
+            lutc += (make_c_uint64_define_lut(pow5_recip_lut, "POW5_RECIP_LUT", "pow5_recip_lut"))
+            lutc += "#define POW5_LOG_LUT uint8_t pow5_log_lut[%d] = { %s };\n"%(
+                len(pow5_log_lut), ", ".join("%d"%x for x in pow5_log_lut))
             lutc += "\n#endif\n"
             f.write(lutc)
 
@@ -11,30 +11,27 @@ import sys
 # Strategy:
 #
 # Each binary fixed-point number has exactly one decimal expansion, with a fixed
-# number of non-zero digits. Also, the binary number can be considered as the
-# sum of each of the numbers represented by each of its bits.
-#
-# We're going to exploit these facts. First, we calculate the largest number of decimal
-# digits that a given fixed-point format (N intbits, 62-N fracbits) can generate:
+# number of non-zero digits: 2^-i has exactly i digits after the point. So the
+# layout of the output only depends on the format (N intbits, 62-N fracbits):
 #
 #   integer digits = ceil( log_10 ( 2^intbits ) )
 #   fractional digits = fracbits
 #   total size = integer digits + fractional digits + 2 (sign and decimal point)
 #
-# Now, we start generating at the absolute smallest decimal digit. By the
-# decimal expansion of 2^-i, only one bit (the 0th) can contribute anything
-# different than 0 to this deciaml digit. So, compute this final digit based on
-# the last bit.
+# The digits themselves come from a small engine, fix_print_digits, which is
+# the same for every format:
 #
-# Moving up one decimal spot, two bits can add their value. Compute this sum,
-# but remember that we might have carry from the previous digit.
+# The fraction is shifted to the top of a 64-bit word. Multiplying it by 10
+# pushes the next decimal digit out of the top, and leaves the rest of the
+# fraction behind; after fracbits steps, the fraction is exactly 0.
 #
-# Continue in this manner, producing the decimal digit for each location, until
-# the entire number is printed.
+# The integer is taken apart from the bottom, by dividing by 10. The division
+# is a multiply by a reciprocal, so there's no (variable time) divide
+# instruction.
 #
-# To support printing "NaN" and "+Inf", etc., add a term to the polynomial,
-# which multiplies by 0 if an exceptional state, zeroing out the normal
-# computation, and adding back in a " "  if necessary.
+# Both loops run a fixed number of times for a given format, so this is
+# constant time. To support printing "NaN" and "+Inf", etc., every character
+# is then masked with its exceptional value.
 
 # base.py might be overwritten; make sure we don't generate bytecode...
 sys.dont_write_bytecode = True
@@ -52,9 +49,515 @@ args = vars(parser.parse_args())
 
 
 
-def make_print_function(preamble, int_bits, frac_bits, flag_bits):
-    number_bits = int_bits + frac_bits
-
+print_digits = """
+/* Writes the sign, integer and fraction of a number, and then overwrites them
+ * if it's NaN or Inf. fpart is the fraction, shifted to the top of the word.
+ * If frac_chars cuts the fraction short and round is set, the digits are
+ * rounded to nearest, ties to even; otherwise they're truncated. With no
+ * fraction digits, there's no point either.
+ *
+ * The loops only depend on int_chars and frac_chars, and int_chars and round
+ * are constants in every caller, so once this is inlined, the unused parts
+ * fold away. */
+FIX_INLINE void fix_print_digits(char* buffer, uint64_t ipart, uint64_t fpart,
+    uint8_t neg, uint8_t isinfpos, uint8_t isinfneg, uint8_t isnan,
+    int int_chars, int frac_chars, uint8_t round) {
+  uint8_t excep = isinfpos | isinfneg | isnan;
+  uint8_t isinf = isinfpos | isinfneg;
+
+  int int_loc = 1;
+  int point_loc = int_loc + int_chars;
+  int frac_loc = point_loc + 1;
+  int length = frac_chars > 0 ? frac_loc + frac_chars : point_loc;
+
+  // We always need room for " NaN".
+  int special_length = length > 4 ? length : 4;
+
+  // The next digit is whatever a multiply by 10 carries out of the top.
+  uint64_t last = ipart;
+  for(int i = 0; i < frac_chars; i++) {
+    uint64_t lo = (fpart & 0xffffffff) * 10;
+    uint64_t hi = (fpart >> 32) * 10 + (lo >> 32);
+
+    last = hi >> 32;
+    buffer[frac_loc + i] = '0' + last;
+    fpart = (hi << 32) | (lo & 0xffffffff);
+  }
+
+  if(round) {
+    // What's left of the fraction is in units of the last digit.
+    uint64_t half = ((uint64_t) 1) << 63;
+    uint8_t carry = (fpart > half) | ((fpart == half) & (last & 1));
+
+    for(int i = frac_chars - 1; i >= 0; i--) {
+      uint8_t d = buffer[frac_loc + i] - '0' + carry;
+      carry = d == 10;
+      buffer[frac_loc + i] = '0' + MASK_UNLESS(!carry, d);
+    }
+
+    ipart += carry;
+  }
+
+  if(frac_chars > 0) {
+    buffer[point_loc] = '.';
+  }
+
+  /* ipart / 10 is the top half of ipart * c, shifted down 3. MUL_64_TOP rounds
+   * that top half, but ipart / 10's fractional part is at most 0.9 plus a
+   * hair, so rounding can't carry into the integer part. */
+  uint64_t c = 0xcccccccccccccccdull;
+  for(int i = int_chars - 1; i >= 0; i--) {
+    uint64_t q = MUL_64_TOP(ipart, c) >> 3;
+
+    buffer[int_loc + i] = '0' + (ipart - q * 10);
+    ipart = q;
+  }
+
+  uint8_t n = (neg & !excep) | isinfneg;
+  buffer[0] = MASK_UNLESS(n, '-') | MASK_UNLESS(!n, ' ');
+
+  for(int i = length; i <= special_length; i++) {
+    buffer[i] = '\\0';
+  }
+
+  // Exceptional values print as " NaN", "-Inf", etc., padded with spaces.
+  const char* nan = "NaN";
+  const char* inf = "Inf";
+  for(int i = 1; i < special_length; i++) {
+    char special = ' ';
+    if(i < 4) {
+      special = MASK_UNLESS(isnan, nan[i - 1]) | MASK_UNLESS(isinf, inf[i - 1]);
+    }
+    buffer[i] = MASK_UNLESS(excep, special) | MASK_UNLESS(!excep, buffer[i]);
+  }
+}
+"""
+
+print_shortest = """
+/* Checks whether rounding to the current digit still parses back to the same
+ * fixed. fpart is what's left of the fraction after the digits so far, and h
+ * is half an epsilon in units of the current digit, times 2^64 (or hbig, if
+ * that doesn't fit). The rounding error is the smaller of fpart and 1 - fpart.
+ * Parsing rounds ties to even, so an error of exactly half an epsilon is only
+ * fine if f is even.
+ *
+ * Once this holds for some number of digits, it holds for every larger one
+ * too. */
+FIX_INLINE uint8_t fix_print_rounds_back(uint64_t fpart, uint64_t h, uint8_t hbig,
+    uint8_t even) {
+  uint64_t nfpart = (~fpart) + 1;
+  uint8_t lower = fpart < nfpart;
+  uint64_t err = MASK_UNLESS(lower, fpart) | MASK_UNLESS(!lower, nfpart);
+
+  return hbig | (err < h) | ((err == h) & even);
+}
+
+// Whether rounding to nearest, ties to even, at the current digit rounds up.
+FIX_INLINE uint8_t fix_print_rounds_up(uint64_t fpart, uint64_t last) {
+  uint64_t half = ((uint64_t) 1) << 63;
+  return (fpart > half) | ((fpart == half) & (last & 1));
+}
+
+FIX_INLINE void fix_print_next_digit(uint64_t* fpart, uint64_t* last,
+    uint64_t* h, uint8_t* hbig) {
+  uint64_t lo = (*fpart & 0xffffffff) * 10;
+  uint64_t hi = (*fpart >> 32) * 10 + (lo >> 32);
+
+  *last = hi >> 32;
+  *fpart = (hi << 32) | (lo & 0xffffffff);
+
+  *hbig |= *h > UINT64_MAX / 10;
+  *h *= 10;
+}
+
+void fix_sprint_shortest(char* buffer, fixed f) {
+  uint8_t isinfpos = FIX_IS_INF_POS(f);
+  uint8_t isinfneg = FIX_IS_INF_NEG(f);
+  uint8_t isnan = FIX_IS_NAN(f);
+  uint8_t excep = isinfpos | isinfneg | isnan;
+  uint8_t neg = !!FIX_TOP_BIT(f);
+  f = fix_abs(f);
+
+  uint64_t ipart = f >> (FIX_FLAG_BITS + FIX_FRAC_BITS);
+  uint64_t fpart = (f >> FIX_FLAG_BITS) << (64 - FIX_FRAC_BITS);
+  uint8_t even = !((f >> FIX_FLAG_BITS) & 1);
+
+  /* Run every digit, and count the places that don't round back. If none do,
+   * all FIX_FRAC_BITS digits are needed, and those are exact. Keep whether
+   * each place rounds up, to pick out the one we stop at. */
+  uint8_t digits[FIX_FRAC_BITS];
+  uint64_t h = ((uint64_t) 1) << (63 - FIX_FRAC_BITS);
+  uint8_t hbig = 0;
+  uint64_t last = ipart;
+  uint64_t ndigits = 0;
+  uint64_t ups = 0;
+
+  for(int d = 0; d < FIX_FRAC_BITS; d++) {
+    ndigits += !fix_print_rounds_back(fpart, h, hbig, even);
+    ups |= ((uint64_t) fix_print_rounds_up(fpart, last)) << d;
+
+    fix_print_next_digit(&fpart, &last, &h, &hbig);
+    digits[d] = last;
+  }
+  uint8_t up = (ups >> ndigits) & 1;
+
+  // Drop the digits past ndigits, and round up into the ones we keep.
+  uint8_t carry = up;
+  for(int i = FIX_FRAC_BITS - 1; i >= 0; i--) {
+    uint8_t keep = i < ndigits;
+    uint8_t d = MASK_UNLESS(keep, digits[i] + carry);
+    uint8_t dcarry = d == 10;
+
+    carry = MASK_UNLESS(keep, dcarry) | MASK_UNLESS(!keep, carry);
+    digits[i] = MASK_UNLESS(!dcarry, d);
+  }
+  ipart += carry;
+
+  /* Lay the number out in full, as [sign][integer].[fraction], and then shift
+   * it left over the sign and the integer's leading zeros. The sign goes in
+   * the last of the slots we drop, if we need it. */
+#define FIX_PRINT_WORDS ((FIX_PRINT_BUFFER_SIZE + 7) / 8)
+  uint8_t t[8 * FIX_PRINT_WORDS];
+  int int_loc = 1;
+  int point_loc = int_loc + FIX_PRINT_INT_CHARS;
+  int frac_loc = point_loc + 1;
+  int length = frac_loc + FIX_FRAC_BITS;
+
+  t[0] = '0';
+  uint64_t c = 0xcccccccccccccccdull;
+  for(int i = FIX_PRINT_INT_CHARS - 1; i >= 0; i--) {
+    uint64_t q = MUL_64_TOP(ipart, c) >> 3;
+
+    t[int_loc + i] = '0' + (ipart - q * 10);
+    ipart = q;
+  }
+  t[point_loc] = '.';
+  for(int i = 0; i < FIX_FRAC_BITS; i++) {
+    t[frac_loc + i] = '0' + digits[i];
+  }
+  for(int i = length; i < 8 * FIX_PRINT_WORDS; i++) {
+    t[i] = 0;
+  }
+
+  uint64_t zeros = 0;
+  uint8_t leading = 1;
+  for(int i = int_loc; i < point_loc - 1; i++) {
+    leading &= t[i] == '0';
+    zeros += leading;
+  }
+
+  for(int i = 0; i < point_loc; i++) {
+    uint8_t sign = neg & (i == zeros);
+    t[i] = MASK_UNLESS(sign, '-') | MASK_UNLESS(!sign, t[i]);
+  }
+
+  /* Shifting byte by byte is slow, so pack the string into words, lowest
+   * character first, and shift those: by the bytes within a word, and then by
+   * whole words. */
+  uint64_t w[FIX_PRINT_WORDS + 2];
+  for(int i = 0; i < FIX_PRINT_WORDS; i++) {
+    const uint8_t* b = t + 8 * i;
+    w[i] = ((uint64_t) b[0]      ) | ((uint64_t) b[1] <<  8) |
+           ((uint64_t) b[2] << 16) | ((uint64_t) b[3] << 24) |
+           ((uint64_t) b[4] << 32) | ((uint64_t) b[5] << 40) |
+           ((uint64_t) b[6] << 48) | ((uint64_t) b[7] << 56);
+  }
+  w[FIX_PRINT_WORDS] = 0;
+  w[FIX_PRINT_WORDS + 1] = 0;
+
+  uint64_t shift = zeros + !neg;
+  uint64_t r = 8 * (shift & 7);
+  uint64_t q = shift >> 3;
+  for(int i = 0; i <= FIX_PRINT_WORDS; i++) {
+    w[i] = (w[i] >> r) | ((w[i + 1] << (63 - r)) << 1);
+  }
+  for(int i = 0; i < FIX_PRINT_WORDS; i++) {
+    uint64_t word = 0;
+    for(int j = 0; j <= FIX_PRINT_INT_CHARS / 8; j++) {
+      word |= MASK_UNLESS(q == j, w[i + j]);
+    }
+    w[i] = word;
+  }
+
+  uint64_t end = FIX_PRINT_INT_CHARS - zeros + neg + MASK_UNLESS(ndigits > 0, ndigits + 1);
+
+  /* Exceptional values print as "NaN", "Inf" and "-Inf", which all fit in the
+   * first word. */
+  uint64_t special = MASK_UNLESS(isnan,    0x4e614eull) |
+                     MASK_UNLESS(isinfpos, 0x666e49ull) |
+                     MASK_UNLESS(isinfneg, 0x666e492dull);
+
+  for(int i = 0; i < FIX_PRINT_WORDS; i++) {
+    // Clear everything from end on.
+    uint64_t bytes = MASK_UNLESS(end > 8 * i, end - 8 * i);
+    uint64_t keep = MASK_UNLESS(bytes >= 8, ~((uint64_t) 0)) |
+      MASK_UNLESS(bytes < 8, (((uint64_t) 1) << (8 * (bytes & 7))) - 1);
+    uint64_t word = w[i] & keep;
+
+    word = MASK_UNLESS(excep, i == 0 ? special : 0) | MASK_UNLESS(!excep, word);
+
+    for(int j = 0; j < 8 && 8 * i + j <= length; j++) {
+      buffer[8 * i + j] = (char) (word >> (8 * j));
+    }
+  }
+}
+
+void fix_sprint_shortest_fast(char* buffer, fixed f) {
+  if(FIX_IS_NAN(f)) {
+    strcpy(buffer, "NaN");
+    return;
+  }
+  if(FIX_IS_INF_POS(f)) {
+    strcpy(buffer, "Inf");
+    return;
+  }
+  if(FIX_IS_INF_NEG(f)) {
+    strcpy(buffer, "-Inf");
+    return;
+  }
+
+  fixed a = fix_abs(f);
+  uint64_t fpart = (a >> FIX_FLAG_BITS) << (64 - FIX_FRAC_BITS);
+  uint8_t even = !((a >> FIX_FLAG_BITS) & 1);
+
+  uint64_t h = ((uint64_t) 1) << (63 - FIX_FRAC_BITS);
+  uint8_t hbig = 0;
+  uint64_t last = a >> (FIX_FLAG_BITS + FIX_FRAC_BITS);
+  int ndigits = 0;
+  while(!fix_print_rounds_back(fpart, h, hbig, even)) {
+    fix_print_next_digit(&fpart, &last, &h, &hbig);
+    ndigits++;
+  }
+
+  char t[FIX_PRINT_BUFFER_SIZE];
+  fix_sprint_digits(t, f, ndigits);
+
+  // Skip the integer's leading zeros, and the sign's space.
+  char* p = t + 1;
+  while(p[0] == '0' && p[1] >= '0' && p[1] <= '9') {
+    p++;
+  }
+
+  if(t[0] == '-') {
+    *buffer++ = '-';
+  }
+  strcpy(buffer, p);
+}
+"""
+
+print_array = """
+/* fix_sprint_array prints a block of elements at a time. The inner loops all
+ * run across the elements of a block, with no branches, so the compiler can
+ * vectorize them: each lane of a vector is one element. Blocks are big enough
+ * that those loops aren't just unrolled instead.
+ *
+ * Each element's characters are put together in words, in memory order, so an
+ * element is written out a word at a time. */
+#define FIX_PRINT_BLOCK 32
+#define FIX_PRINT_WIDTH (FIX_PRINT_BUFFER_SIZE - 1)
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define FIX_PRINT_BYTE_SHIFT(k) (56 - 8 * (k))
+#else
+#define FIX_PRINT_BYTE_SHIFT(k) (8 * (k))
+#endif
+
+// Character c, at place p in an element, in its word.
+#define FIX_PRINT_CHAR(c, p) (((uint64_t) (c)) << FIX_PRINT_BYTE_SHIFT((p) & 7))
+
+FIX_INLINE void fix_print_block(char* out, size_t stride, const fixed* xs, size_t n) {
+  uint64_t ipart[FIX_PRINT_BLOCK];
+  uint64_t fpart[FIX_PRINT_BLOCK];
+  uint64_t mnormal[FIX_PRINT_BLOCK];
+  uint64_t mnan[FIX_PRINT_BLOCK];
+  uint64_t minf[FIX_PRINT_BLOCK];
+
+  // The characters of each element, one row per word of output.
+  uint64_t words[FIX_PRINT_WORDS][FIX_PRINT_BLOCK];
+
+  int int_loc = 1;
+  int point_loc = int_loc + FIX_PRINT_INT_CHARS;
+  int frac_loc = point_loc + 1;
+
+  // A short block is padded out with zeros, which aren't written.
+  fixed x[FIX_PRINT_BLOCK];
+  for(int j = 0; j < FIX_PRINT_BLOCK; j++) {
+    x[j] = 0;
+  }
+  for(size_t j = 0; j < n; j++) {
+    x[j] = xs[j];
+  }
+
+  for(int j = 0; j < FIX_PRINT_BLOCK; j++) {
+    fixed f = x[j];
+    uint64_t isinfpos = FIX_IS_INF_POS(f);
+    uint64_t isinfneg = FIX_IS_INF_NEG(f);
+    uint64_t isnan = FIX_IS_NAN(f);
+    uint64_t excep = isinfpos | isinfneg | isnan;
+    uint64_t neg = !!FIX_TOP_BIT(f);
+
+    // The same magnitude fix_abs gives, leaving FIX_MIN as 2^63.
+    uint64_t a = MASK_UNLESS_64(neg, (~f) + 4) | MASK_UNLESS_64(!neg, f);
+    ipart[j] = a >> (FIX_FLAG_BITS + FIX_FRAC_BITS);
+    fpart[j] = (a >> FIX_FLAG_BITS) << (64 - FIX_FRAC_BITS);
+
+    mnormal[j] = MASK_UNLESS_64(!excep, ~((uint64_t) 0));
+    mnan[j] = MASK_UNLESS_64(isnan, ~((uint64_t) 0));
+    minf[j] = MASK_UNLESS_64(isinfpos | isinfneg, ~((uint64_t) 0));
+
+    uint64_t s = (neg & !excep) | isinfneg;
+    words[0][j] = FIX_PRINT_CHAR(MASK_UNLESS_64(s, '-') | MASK_UNLESS_64(!s, ' '), 0);
+  }
+  for(int w = 1; w < FIX_PRINT_WORDS; w++) {
+    for(int j = 0; j < FIX_PRINT_BLOCK; j++) {
+      words[w][j] = 0;
+    }
+  }
+
+  // The next digit is whatever a multiply by 10 carries out of the top.
+  for(int i = 0; i < FIX_FRAC_BITS; i++) {
+    int p = frac_loc + i;
+    uint64_t* row = words[p / 8];
+    for(int j = 0; j < FIX_PRINT_BLOCK; j++) {
+      uint64_t lo = (fpart[j] & 0xffffffff) * 10;
+      uint64_t hi = (fpart[j] >> 32) * 10 + (lo >> 32);
+
+      row[j] |= FIX_PRINT_CHAR('0' + (hi >> 32), p);
+      fpart[j] = (hi << 32) | (lo & 0xffffffff);
+    }
+  }
+
+  for(int j = 0; j < FIX_PRINT_BLOCK; j++) {
+    words[point_loc / 8][j] |= FIX_PRINT_CHAR('.', point_loc);
+  }
+
+  /* The same reciprocal divide as fix_print_digits, but with the top half of
+   * the product taken exactly, from 32-bit pieces. Each piece's product is a
+   * 32 by 32 bit multiply, which vectors have. */
+  uint32_t clo = 0xcccccccd;
+  uint32_t chi = 0xcccccccc;
+  for(int i = FIX_PRINT_INT_CHARS - 1; i >= 0; i--) {
+    int p = int_loc + i;
+    uint64_t* row = words[p / 8];
+    for(int j = 0; j < FIX_PRINT_BLOCK; j++) {
+      uint64_t v = ipart[j];
+      uint32_t vlo = (uint32_t) v;
+      uint32_t vhi = (uint32_t) (v >> 32);
+
+      uint64_t mid = (((uint64_t) vlo * clo) >> 32) + (uint64_t) vhi * clo;
+      uint64_t mid2 = (mid & 0xffffffff) + (uint64_t) vlo * chi;
+      uint64_t q = ((uint64_t) vhi * chi + (mid >> 32) + (mid2 >> 32)) >> 3;
+
+      row[j] |= FIX_PRINT_CHAR('0' + (v - q * 10), p);
+      ipart[j] = q;
+    }
+  }
+
+  /* Exceptional values print as " NaN", "-Inf", etc., padded with spaces. The
+   * sign is kept from above. */
+  const char* nan = "NaN";
+  const char* inf = "Inf";
+  for(int w = 0; w < FIX_PRINT_WORDS; w++) {
+    uint64_t keep = 0;
+    uint64_t nanw = 0;
+    uint64_t infw = 0;
+    for(int p = 8 * w; p < 8 * w + 8 && p < FIX_PRINT_WIDTH; p++) {
+      keep |= FIX_PRINT_CHAR(p == 0 ? 0xff : 0, p);
+      nanw |= FIX_PRINT_CHAR(p == 0 ? 0 : p < 4 ? nan[p - 1] : ' ', p);
+      infw |= FIX_PRINT_CHAR(p == 0 ? 0 : p < 4 ? inf[p - 1] : ' ', p);
+    }
+
+    uint64_t* row = words[w];
+    for(int j = 0; j < FIX_PRINT_BLOCK; j++) {
+      row[j] = (row[j] & (mnormal[j] | keep)) | (mnan[j] & nanw) | (minf[j] & infw);
+    }
+  }
+
+  // Whole words, then what's left of the last one.
+  for(size_t j = 0; j < n; j++) {
+    char* o = out + j * stride;
+    for(int w = 0; w < FIX_PRINT_WIDTH / 8; w++) {
+      memcpy(o + 8 * w, &words[w][j], 8);
+    }
+    for(int p = FIX_PRINT_WIDTH / 8 * 8; p < FIX_PRINT_WIDTH; p++) {
+      o[p] = (char) (words[p / 8][j] >> FIX_PRINT_BYTE_SHIFT(p & 7));
+    }
+  }
+}
+
+FIX_INLINE void fix_print_blocks(char* out, size_t stride, const fixed* xs, size_t n) {
+  for(size_t i = 0; i < n; i += FIX_PRINT_BLOCK) {
+    size_t b = n - i < FIX_PRINT_BLOCK ? n - i : FIX_PRINT_BLOCK;
+    fix_print_block(out + i * stride, stride, xs + i, b);
+  }
+}
+
+#if FIX_X86_SIMD
+/* flatten inlines everything this calls, so all of it is compiled for AVX2. */
+static FIX_AVX2 __attribute__((flatten)) void fix_print_blocks_avx2(char* out, size_t stride,
+    const fixed* xs, size_t n) {
+  fix_print_blocks(out, stride, xs, n);
+}
+#endif
+
+static void fix_print_array(char* out, size_t stride, const fixed* xs, size_t n) {
+  FIX_USE_AVX2(fix_print_blocks_avx2(out, stride, xs, n));
+  fix_print_blocks(out, stride, xs, n);
+}
+
+size_t fix_sprint_array(char* out, size_t cap, const fixed* xs, size_t n, char sep) {
+  if(cap == 0) {
+    return 0;
+  }
+
+  // Each element takes up stride bytes, but the last has no separator.
+  size_t hassep = sep != 0;
+  size_t stride = FIX_PRINT_WIDTH + hassep;
+  size_t fit = (cap - 1 + hassep) / stride;
+  n = n < fit ? n : fit;
+
+  fix_print_array(out, stride, xs, n);
+
+  if(hassep) {
+    for(size_t i = 1; i < n; i++) {
+      out[i * stride - 1] = sep;
+    }
+  }
+
+  out[n == 0 ? 0 : n * stride - hassep] = 0;
+  return n;
+}
+
+size_t fix_sprint_shortest_array(char* out, size_t cap, const fixed* xs, size_t n, char sep) {
+  if(cap == 0) {
+    return 0;
+  }
+
+  size_t used = 0;
+  size_t count = 0;
+  for(; count < n; count++) {
+    char buf[FIX_PRINT_BUFFER_SIZE];
+    fix_sprint_shortest(buf, xs[count]);
+
+    size_t len = strlen(buf);
+    size_t hassep = (count > 0) & (sep != 0);
+    if(used + hassep + len + 1 > cap) {
+      break;
+    }
+
+    if(hassep) {
+      out[used++] = sep;
+    }
+    memcpy(out + used, buf, len);
+    used += len;
+  }
+
+  out[used] = 0;
+  return count;
+}
+"""
+
+def make_print_function(preamble, int_bits, frac_bits, flag_bits, digits=None):
     # characters in the integer is given by the base 10 log of the maximum number
     # but since we're two's complement, we subtract 1 power of two
     int_chars = int(math.ceil(math.log(2**(int_bits-1),10)))
@@ -66,93 +569,37 @@ def make_print_function(preamble, int_bits, frac_bits, flag_bits):
     #characters in the base-10 significand is exactly the number of bits
     #  0.5, 0.25, 0.125, etc.
     # Each step involves extending another power of ten down...
-    frac_chars = frac_bits
-
-    sign_char = 1
-    point_char = 1
-
-    sign_loc = 0
-    int_loc = sign_char
-    point_loc = sign_char + int_chars
-    frac_loc = sign_char + int_chars + point_char
-    length = sign_char + int_chars + point_char + frac_chars
-
-    ########
-
-    bits = [2**i for i in range(-frac_bits, int_bits)]
-
-    # Ensure the patterns are up to snuff
-    fmt = "%%0%d.%df"%(length - sign_char, frac_chars)
-    dec_patterns = [fmt%(b) for b in bits]
-
-    #generate the list of contributory things
-    fraction_patterns = [s[int_chars+sign_char:] for s in dec_patterns]
-    int_patterns = [s[:int_chars] for s in dec_patterns]
-
-    # make a dictionary of dictionaries for fraction patterns.
-    # Top level key: character in fraction [0, frac_chars)
-    # Second level key: contributory bit
-    # Second level value: resulting decimal digit
-    fracs = {i: {bit: fraction_patterns[bit][i] for bit in range(len(fraction_patterns))} for i in range(frac_chars)}
-    ints =  {i: {bit: int_patterns[bit][i]      for bit in range(len(int_patterns))}      for i in range(int_chars)}
-
-    def frac_poly(n):
-        patterns = [(k,v) for k, v in fracs[n].iteritems()]
-        terms = ["(%c * bit%d)"%(p, bit+flag_bits) for bit, p in patterns if p != "0"]
-        return " + ".join(terms)
-
-    def int_poly(n):
-        patterns = [(k,v) for k, v in ints[n].iteritems()]
-        terms = ["(%c * bit%d)"%(p, bit+flag_bits) for bit, p in patterns if p != "0"]
-        return " + ".join(terms)
-
+    #
+    # Unless the caller asks for some other number of digits (a C expression),
+    # in which case we round to that.
+    if digits is None:
+        frac_chars = "%d"%(frac_bits)
+        round = 0
+    else:
+        frac_chars = digits
+        round = 1
+
+    # Pull the integer and the fraction out of f, taking care not to shift by
+    # 64.
+    if int_bits == 0:
+        ipart = "0"
+    elif flag_bits + frac_bits + int_bits == 64:
+        ipart = "f >> %d"%(flag_bits + frac_bits)
+    else:
+        ipart = "(f >> %d) & 0x%xull"%(flag_bits + frac_bits, 2**int_bits - 1)
+
+    if frac_bits == 0:
+        fpart = "0"
+    elif frac_bits == 64:
+        fpart = "f"
+    else:
+        fpart = "(f >> %d) << %d"%(flag_bits, 64 - frac_bits)
 
     f = preamble;
     f += """
-  uint8_t excep = isinfpos | isinfneg | isnan;
-
-  uint32_t carry = 0;
-  uint32_t scratch = 0;
-  """
-
-    f += "\n".join(["  uint8_t bit%d = (((f) >> (%d))&1);"%(i,i) for i in range(flag_bits,flag_bits+number_bits)])
-
-    extra_polynomials = {
-            1: " + (isnan * %d) + (isinfpos | isinfneg) * %d"%(ord('N'), ord('I')),
-            2: " + (isnan * %d) + (isinfpos | isinfneg) * %d"%(ord('a'), ord('n')),
-            3: " + (isnan * %d) + (isinfpos | isinfneg) * %d"%(ord('N'), ord('f')),
-            }
-    def get_extra_poly(n):
-        return extra_polynomials.get(n, "+ (excep * %d)"%(ord(' ')))
-
-    # start at the end and move forward...
-    for position in reversed(range(frac_chars)):
-        poly = frac_poly(position)
-        f += ("  scratch = %s + carry;"%(poly))
-        f += ("  buffer[%d] = ((%d + (scratch %% 10)) * (1-excep) %s);\n"%(
-            frac_loc+position, ord('0'), get_extra_poly(frac_loc+position)))
-        f += ("carry = scratch / 10;\n")
-
-    f += ("\n");
-    f += ("  buffer[%d] = %s + (1-excep)*%d;"%(point_loc, get_extra_poly(point_loc), ord('.')))
-    f += ("\n");
-
-    for position in reversed(range(int_chars)):
-        poly = int_poly(position)
-        f += ("  scratch = %s + carry;\n"%(poly))
-        f += ("  buffer[%d] = ((%d + (scratch %% 10)) * (1-excep)) %s;\n"%(int_loc + position, ord('0'),
-            get_extra_poly(int_loc+position)))
-        f += ("carry = scratch / 10;\n")
-
-    f += ("""
-      uint8_t n = (neg*(1-excep) + isinfneg);
-      buffer[0] = %d * n + %d * (1-n);
-    """%(ord('-'), ord(' ')))
-
-    f += ("  buffer[%d] = '\\0';"%(length))
-
-    f += ("""}
-    """)
+  fix_print_digits(buffer, %s, %s, neg, isinfpos, isinfneg, isnan, %d, %s, %d);
+}
+"""%(ipart, fpart, int_chars, frac_chars, round)
     return f
 
 
@@ -166,9 +613,11 @@ with args["file"] as f:
  * This file is autogenerated by generate_print.py.
  * Please don't modify it manually.
  *********/
-
 """)
 
+    f.write(print_digits)
+    f.write("\n");
+
     f.write(make_print_function("""void fix_sprint(char* buffer, fixed f) {
   uint8_t isinfpos = FIX_IS_INF_POS(f);
   uint8_t isinfneg = FIX_IS_INF_NEG(f);
@@ -177,6 +626,20 @@ with args["file"] as f:
   f = fix_abs(f);""",
   int_bits, frac_bits, flag_bits))
 
+    f.write("\n");
+
+    f.write(make_print_function("""void fix_sprint_digits(char* buffer, fixed f, int32_t ndigits) {
+  uint8_t isinfpos = FIX_IS_INF_POS(f);
+  uint8_t isinfneg = FIX_IS_INF_NEG(f);
+  uint8_t isnan = FIX_IS_NAN(f);
+  uint32_t neg = !!FIX_TOP_BIT(f);
+  f = fix_abs(f);
+  ndigits = MASK_UNLESS_32(ndigits > 0, ndigits);""",
+  int_bits, frac_bits, flag_bits, "ndigits"))
+
+    f.write(print_shortest)
+    f.write(print_array)
+
     f.write("\n\n");
 
     f.write("#ifdef DEBUG\n")
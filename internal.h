@@ -130,11 +130,13 @@ typedef int64_t fixed_signed;
      ((value & 3) == 3))
 
 
+/* The bits are all 0 or 1 here, so this is ROUND_TO_EVEN_ADDITION without the
+ * casts to bool, which keeps loops over it vectorizable. */
 FIX_INLINE uint64_t ROUND_TO_EVEN_64(uint64_t value, int n_shift_bits) {
-    uint8_t lowbit = (value >> (n_shift_bits)) & 0x1;
-    uint8_t highroundbit = (value >> ((n_shift_bits)-1)) & 0x1;
+    uint64_t lowbit = (value >> (n_shift_bits)) & 0x1;
+    uint64_t highroundbit = (value >> ((n_shift_bits)-1)) & 0x1;
     uint64_t restroundbits = (value) & ((1ull << ((n_shift_bits)-1)) -1);
-    return (value >> n_shift_bits) + ROUND_TO_EVEN_ADDITION(lowbit, highroundbit, restroundbits);
+    return (value >> n_shift_bits) + (highroundbit & (lowbit | (restroundbits != 0)));
 }
 
 #define ROUND_TO_EVEN_SIGNED_32(value, n_shift_bits) \
@@ -413,6 +415,8 @@ uint64_t fixfrac(char* frac);
 
 typedef uint64_t fix_internal;
 
+int32_t fix_ln_split(uint64_t op1, fix_internal* rest);
+
 #define FIX_MUL_INTERN(op1, op2, overflow) \
     MUL_64_N(op1, op2, overflow, FIX_INTERN_FRAC_BITS)
 
@@ -483,58 +487,176 @@ FIX_INLINE uint8_t uint32_log2(uint32_t o) {
 }
 #define fixed_log2 uint64_log2
 
-FIX_INLINE fix_internal fix_circle_frac(fixed op1) {
-  fixed big_qtau = 0xc90fdaa22168c235; // "%x"%(mpmath.nint( (mpmath.pi / 2) * 2**63))
+/* Computes floor(sqrt(hi:lo)) for the 128-bit unsigned integer hi:lo.
+ *
+ * This is the schoolbook digit-by-digit method: bring down two bits of the
+ * radicand per iteration and decide one bit of the root. The remainder can grow
+ * to 66 bits, so it's kept as a pair of words. Always runs 64 iterations. */
+FIX_INLINE uint64_t uint128_sqrt(uint64_t hi, uint64_t lo) {
+  uint64_t root = 0;
+  uint64_t remhigh = 0;
+  uint64_t remlow = 0;
+
+  for(int i = 0; i < 64; i++) {
+    // Bring down the top two bits of the radicand.
+    remhigh = (remhigh << 2) | (remlow >> 62);
+    remlow  = (remlow  << 2) | (hi >> 62);
+    hi = (hi << 2) | (lo >> 62);
+    lo = lo << 2;
+
+    // trial = 4 * root + 1
+    uint64_t trialhigh = root >> 62;
+    uint64_t triallow = (root << 2) | 1;
+
+    uint8_t fits = (remhigh > trialhigh) | ((remhigh == trialhigh) & (remlow >= triallow));
+
+    uint64_t difflow = remlow - triallow;
+    uint64_t diffhigh = remhigh - trialhigh - (remlow < triallow);
+
+    remlow  = MASK_UNLESS( fits, difflow) | MASK_UNLESS(!fits, remlow);
+    remhigh = MASK_UNLESS( fits, diffhigh) | MASK_UNLESS(!fits, remhigh);
+    root = (root << 1) | fits;
+  }
 
-  /*
-   * We want to divide op1 by TAU/4 (i.e., Pi/2), and end up with a fix_internal
-   * within [0,4).
-   *
-   * Ugh. Code copied from fix_div_64, and modified for our purposes.
-   */
+  return root;
+}
 
-  uint8_t xpos =  !FIX_TOP_BIT(op1);
-  uint64_t absx = MASK_UNLESS_64( xpos,   op1) |
-                  MASK_UNLESS_64(!xpos, (~op1)+1 );
-  uint8_t logx = uint64_log2(absx);
 
-  /* We change the result by shifting these numbers up. Record the shift... */
-  int8_t shift = logx + 1 - (FIX_POINT_BITS);
 
-  uint64_t acc = absx << (62 - logx);
-  uint64_t base = big_qtau;
+/* fix_div_64 is long division: fix_div_64_start lines x and y up,
+ * fix_div_64_round finds one bit of the quotient, and fix_div_64_finish shifts
+ * and rounds it. They're split up so fix_div_array can run each step across a
+ * block of elements. Flags are 64 bits wide so that vectorizes, and shift
+ * counts that can be out of range are masked to 6 bits (as x86 does anyway),
+ * so the vector and scalar code agree. */
+FIX_INLINE void fix_div_64_start(fixed x, fixed y, uint64_t* acc, uint64_t* base,
+    int64_t* shiftamount) {
+  uint64_t xpos =  !FIX_TOP_BIT(x);
+  uint64_t ypos =  !FIX_TOP_BIT(y);
 
-  uint64_t result = 0;
-  int i = 0;
+  uint64_t absx = MASK_UNLESS_64( xpos, x ) |
+                  MASK_UNLESS_64(!xpos, (~x)+1 );
+  uint64_t absy = MASK_UNLESS_64( ypos, y ) |
+                  MASK_UNLESS_64(!ypos, (~y)+1 );
+
+  int64_t logx = uint64_log2(absx);
+  int64_t logy = uint64_log2(absy);
+
+  /* We change the result by shifting these numbers up. Record the shift... */
+  int64_t shift = logx - logy + 1;
 
   /* if absx is 0x80..0, then x was the largest negative number, and acc is
    * some nonsense. Fix that up... */
-  acc = MASK_UNLESS_64( absx == 0x8000000000000000, absx >> 1 ) |
-        MASK_UNLESS_64( absx != 0x8000000000000000, acc );
+  *acc = MASK_UNLESS_64( absx == 0x8000000000000000, absx >> 1 ) |
+         MASK_UNLESS_64( absx != 0x8000000000000000, absx << ((62 - logx) & 63) );
+  *base = absy << (63 - logy);
+
+  // result will have 64 bits of division result; we need to shift it into
+  // place. "Place" is a combination of FIX_POINT_BITS and 'shift', as computed
+  // above. Since we moved y to be slightly above x, result is a number in Q64.
+  *shiftamount = ((64 - FIX_POINT_BITS) - shift);
+}
 
-  // Now, perform long division: x / y
-  for(i = 63; i >= 0; i--) {
+FIX_INLINE void fix_div_64_round(uint64_t* acc, uint64_t* base, uint64_t* result) {
+  // Pesudocode:
+  //if((acc >= base) & (base != 0)) {
+  //    acc -= base;
+  //    result |= 1;
+  //}
 
-    // Pesudocode:
-    //if((acc >= base) & (base != 0)) {
-    //    acc -= base;
-    //    result |= 1;
-    //}
+  uint64_t expression = (*acc >= *base) & (*base != 0);
+  *acc = MASK_UNLESS( expression, *acc - *base) |
+         MASK_UNLESS(!expression, *acc);
+  *result = *result | MASK_UNLESS( expression, 1);
 
-    uint8_t expression = (acc >= base) & (base != 0);
-    acc = MASK_UNLESS( expression, acc - base) |
-          MASK_UNLESS(!expression, acc);
-    result = result | MASK_UNLESS( expression, 1);
+  *result = *result << 1;
+  *base = *base >> 1;
+}
 
-    result = result << 1;
-    base = base >> 1;
+FIX_INLINE uint64_t fix_div_64_finish(fixed x, fixed y, uint64_t result,
+    int64_t shiftamount, uint64_t* overflow) {
+  uint64_t xpos =  !FIX_TOP_BIT(x);
+  uint64_t ypos =  !FIX_TOP_BIT(y);
+  uint64_t absx = MASK_UNLESS_64( xpos, x ) |
+                  MASK_UNLESS_64(!xpos, (~x)+1 );
+
+  // The bits shifted off, which decide the rounding.
+  uint64_t s = ((uint64_t) shiftamount) & 63;
+  uint64_t roundbits = result - ((result >> s) << s);
+  result = MASK_UNLESS(shiftamount < 64, (result >> s));
+
+  // If we're supposed to shift the result to the left (or not at all), there's
+  // overflow. Although, if x was the largest negative number, not shifting the
+  // result is okay.
+  *overflow = (shiftamount < 0) | ((shiftamount == 0) & (absx != 0x8000000000000000));
+
+  result |= roundbits != 0;
+
+  // ROUND_TO_EVEN_64 rounds the same as FIX_DATA_BITS_ROUNDED's ROUND_TO_EVEN.
+  result = ROUND_TO_EVEN_64(result, FIX_FLAG_BITS) << FIX_FLAG_BITS;
+
+  // result has no flag bits, so this is what fix_neg would give, without a call.
+  result = MASK_UNLESS(ypos == xpos, result) |
+           MASK_UNLESS(ypos != xpos, (~result) + 1);
+
+  return FIX_DATA_BITS(result);
+}
+
+static inline uint64_t fix_div_64(fixed x, fixed y, uint8_t* overflow) {
+  uint64_t acc;
+  uint64_t base;
+  int64_t shiftamount;
+  uint64_t result = 0;
+  uint64_t isinf;
+
+  fix_div_64_start(x, y, &acc, &base, &shiftamount);
+
+  // Now, perform long division: x / y
+  for(int i = 63; i >= 0; i--) {
+    fix_div_64_round(&acc, &base, &result);
   }
-  // result now has 64 bits of division result; we need to shift it into place
-  // "Place" is a combination of FIX_POINT_BITS and 'shift', as computed above
-  // Since we moved y to be slightly above x, result contains a number in Q64.
-  //
-  int64_t shiftamount = ((64 - FIX_INTERN_FRAC_BITS) - shift);
-  result = MASK_UNLESS(shiftamount < 64, (result >> shiftamount));
+
+  result = fix_div_64_finish(x, y, result, shiftamount, &isinf);
+  *overflow = isinf;
+
+  return result;
+}
+
+#define fix_div_var fix_div_64
+
+/* fix_circle_frac divides op1 by TAU/4 (i.e., Pi/2), and ends up with a
+ * fix_internal within [0,4). It's long division, as in fix_div_64, and split
+ * up the same way: fix_circle_frac_start lines x up, fix_div_64_round finds
+ * each bit against FIX_CIRCLE_FRAC_BASE, and fix_circle_frac_finish shifts the
+ * quotient into place. */
+#define FIX_CIRCLE_FRAC_BASE 0xc90fdaa22168c235ull // "%x"%(mpmath.nint( (mpmath.pi / 2) * 2**63))
+
+FIX_INLINE void fix_circle_frac_start(fixed op1, uint64_t* acc, int64_t* shiftamount) {
+  uint64_t xpos =  !FIX_TOP_BIT(op1);
+  uint64_t absx = MASK_UNLESS_64( xpos,   op1) |
+                  MASK_UNLESS_64(!xpos, (~op1)+1 );
+  int64_t logx = uint64_log2(absx);
+
+  /* We change the result by shifting these numbers up. Record the shift... */
+  int64_t shift = logx + 1 - (FIX_POINT_BITS);
+
+  /* if absx is 0x80..0, then x was the largest negative number, and acc is
+   * some nonsense. Fix that up... */
+  *acc = MASK_UNLESS_64( absx == 0x8000000000000000, absx >> 1 ) |
+         MASK_UNLESS_64( absx != 0x8000000000000000, absx << ((62 - logx) & 63) );
+
+  // result will have 64 bits of division result; we need to shift it into
+  // place. "Place" is a combination of FIX_POINT_BITS and 'shift', as computed
+  // above. Since we moved y to be slightly above x, result is a number in Q64.
+  *shiftamount = ((64 - FIX_INTERN_FRAC_BITS) - shift);
+}
+
+FIX_INLINE fix_internal fix_circle_frac_finish(fixed op1, uint64_t result,
+    int64_t shiftamount) {
+  uint64_t xpos =  !FIX_TOP_BIT(op1);
+
+  uint64_t s = ((uint64_t) shiftamount) & 63;
+  result = MASK_UNLESS(shiftamount < 64, (result >> s));
 
   result = result & ((((fix_internal) 4) << (FIX_INTERN_FRAC_BITS))-1);
   result = MASK_UNLESS( xpos, result) |
@@ -544,9 +666,56 @@ FIX_INLINE fix_internal fix_circle_frac(fixed op1) {
   return result;
 }
 
+FIX_INLINE fix_internal fix_circle_frac(fixed op1) {
+  uint64_t acc;
+  uint64_t base = FIX_CIRCLE_FRAC_BASE;
+  uint64_t result = 0;
+  int64_t shiftamount;
 
+  fix_circle_frac_start(op1, &acc, &shiftamount);
 
-static inline uint64_t fix_div_64(fixed x, fixed y, uint8_t* overflow) {
+  // Now, perform long division: x / y
+  for(int i = 63; i >= 0; i--) {
+    fix_div_64_round(&acc, &base, &result);
+  }
+
+  return fix_circle_frac_finish(op1, result, shiftamount);
+}
+
+/* Computes 1/d, where d is a Q0.64 in [0.5, 1) (i.e., its top bit is set). The
+ * result is a Q2.62 in (1, 2], within two units in the last place.
+ *
+ * The seed is the linear fit 48/17 - 32/17 d, which is good to 1/17. Each
+ * Newton step r = r * (2 - d * r) squares the error, so four of them take us
+ * past 62 bits. */
+FIX_INLINE uint64_t uint64_recip(uint64_t d) {
+  uint64_t c32_17 = 0x7878787878787879; // 32/17 in Q2.62
+  uint64_t c48_17 = 0xb4b4b4b4b4b4b4b5; // 48/17 in Q2.62
+  uint64_t hi;
+  uint64_t lo;
+
+  UNSAFE_UNSIGNED_MUL_64_64_128(d, c32_17, lo, hi);
+  uint64_t r = c48_17 - hi;
+
+  for(int i = 0; i < 4; i++) {
+    // d * r is in (0, 2), so 2 - d * r fits in a Q2.62.
+    UNSAFE_UNSIGNED_MUL_64_64_128(d, r, lo, hi);
+    uint64_t e = (((uint64_t) 1) << 63) - hi;
+
+    UNSAFE_UNSIGNED_MUL_64_64_128(r, e, lo, hi);
+    r = (hi << 2) | (lo >> 62);
+  }
+
+  return r;
+}
+
+/* Same contract as fix_div_64, but multiplies by a reciprocal instead of doing
+ * 64 rounds of long division.
+ *
+ * The reciprocal gets the quotient to within two units. We then compute the
+ * exact remainder x * 2^FIX_FRAC_BITS - q * y in 128 bits and step q until the
+ * remainder is in [0, y), which means the result is correctly rounded. */
+static inline uint64_t fix_div_recip(fixed x, fixed y, uint8_t* overflow) {
   uint8_t xpos =  !FIX_TOP_BIT(x);
   uint8_t ypos =  !FIX_TOP_BIT(y);
 
@@ -558,60 +727,343 @@ static inline uint64_t fix_div_64(fixed x, fixed y, uint8_t* overflow) {
   uint8_t logx = uint64_log2(absx);
   uint8_t logy = uint64_log2(absy);
 
-  /* We change the result by shifting these numbers up. Record the shift... */
-  int8_t shift = logx - logy + 1;
+  uint64_t normx = absx << (63 - logx);
+  uint64_t normy = absy << (63 - logy);
 
-  uint64_t acc = absx << (62 - logx);
-  uint64_t base = absy << (63 - logy);
+  uint64_t hi;
+  uint64_t lo;
 
-  uint64_t result = 0;
+  // hi is normx / normy as a Q2.62, which is in (0.5, 2).
+  uint64_t r = uint64_recip(normy);
+  UNSAFE_UNSIGNED_MUL_64_64_128(normx, r, lo, hi);
 
-  /* if absx is 0x80..0, then x was the largest negative number, and acc is
-   * some nonsense. Fix that up... */
-  acc = MASK_UNLESS_64( absx == 0x8000000000000000, absx >> 1 ) |
-        MASK_UNLESS_64( absx != 0x8000000000000000, acc );
-  int i = 0;
+  /* x / y = hi * 2^(logx - logy - 62), and we want it with FIX_FRAC_BITS
+   * fractional bits. If we'd have to shift left, the quotient is at least
+   * 2^(FIX_BITS - FIX_FLAG_BITS - 1), which overflows. */
+  int shift = 62 - FIX_FRAC_BITS - logx + logy;
+  uint64_t q = MASK_UNLESS_64((shift > 0) & (shift < 64), hi >> (shift & 63));
 
-  // Now, perform long division: x / y
-  for(i = 63; i >= 0; i--) {
+  // remainder = x * 2^FIX_FRAC_BITS - q * y
+  uint64_t xhi = (absx >> 1) >> (63 - FIX_FRAC_BITS);
+  uint64_t xlo = absx << FIX_FRAC_BITS;
+  UNSAFE_UNSIGNED_MUL_64_64_128(q, absy, lo, hi);
+  uint64_t remlow  = xlo - lo;
+  uint64_t remhigh = xhi - hi - (xlo < lo);
 
-    // Pesudocode:
-    //if((acc >= base) & (base != 0)) {
-    //    acc -= base;
-    //    result |= 1;
-    //}
+  for(int i = 0; i < 2; i++) {
+    uint8_t neg = remhigh >> 63;
+    uint8_t big = (!neg) & ((remhigh != 0) | (remlow >= absy));
 
-    uint8_t expression = (acc >= base) & (base != 0);
-    acc = MASK_UNLESS( expression, acc - base) |
-          MASK_UNLESS(!expression, acc);
-    result = result | MASK_UNLESS( expression, 1);
+    uint64_t addlow  = MASK_UNLESS_64(neg, absy) | MASK_UNLESS_64(big, (~absy) + 1);
+    uint64_t addhigh = MASK_UNLESS_64(big, ~((uint64_t) 0));
 
-    result = result << 1;
-    base = base >> 1;
+    remlow += addlow;
+    remhigh += addhigh + (remlow < addlow);
+    q = q + big - neg;
   }
 
-  // result now has 64 bits of division result; we need to shift it into place
-  // "Place" is a combination of FIX_POINT_BITS and 'shift', as computed above
-  // Since we moved y to be slightly above x, result contains a number in Q64.
-  int64_t shiftamount = ((64 - FIX_POINT_BITS) - shift);
-  uint64_t roundbits = (result) & ((1ull << shiftamount) -1);
-  result = MASK_UNLESS(shiftamount < 64, (result >> shiftamount));
-
-  // If we're supposed to shift the result to the left (or not at all), there's
-  // overflow. Although, if x was the largest negative number, not shifting the
-  // result is okay.
-  *overflow = (shiftamount < 0) | ((shiftamount == 0) & (absx != 0x8000000000000000));
-
-  result |= !!roundbits;
+  // The remainder is in [0, y) now, so doubling it can't overflow.
+  uint64_t tworem = remlow << 1;
+  q += (tworem > absy) | ((tworem == absy) & (q & 1));
 
-  result = FIX_DATA_BITS_ROUNDED(result);
+  *overflow = (absy == 0) |
+    ((absx != 0) & ((shift <= 0) | (q >= (((uint64_t) 1) << (FIX_BITS - FIX_FLAG_BITS - 1)))));
 
+  uint64_t result = q << FIX_FLAG_BITS;
   result = MASK_UNLESS(ypos == xpos, result) |
-           MASK_UNLESS(ypos != xpos, fix_neg(result));
+           MASK_UNLESS(ypos != xpos, (~result) + 1);
 
   return FIX_DATA_BITS(result);
 }
 
-#define fix_div_var fix_div_64
+///////////////////////////////////////
+//  Inline arithmetic
+///////////////////////////////////////
+
+/* The bodies of fix_cmp, fix_neg, fix_abs, fix_add, fix_mul and fix_div.
+ * ftfp.c wraps them, and array.c inlines them into its loops, so the loops have
+ * no calls in them and the compiler is free to vectorize. Flags are kept 64
+ * bits wide for the same reason. */
+
+FIX_INLINE int8_t fix_cmp_inline(fixed op1, fixed op2) {
+  uint64_t nans = !!(FIX_IS_NAN(op1) | FIX_IS_NAN(op2));
+
+  uint64_t pos1 = !FIX_IS_NEG(op1);
+  uint64_t pos2 = !FIX_IS_NEG(op2);
+
+  uint64_t gt = (  FIX_IS_INF_POS(op1)  & (!FIX_IS_INF_POS(op2))) |
+                ((!FIX_IS_INF_NEG(op1)) &   FIX_IS_INF_NEG(op2));
+  uint64_t lt = ((!FIX_IS_INF_POS(op1)) &   FIX_IS_INF_POS(op2)) |
+                  (FIX_IS_INF_NEG(op1)  & (!FIX_IS_INF_NEG(op2)));
+
+  gt |= (!lt) & (pos1 & (!pos2));
+  lt |= (!gt) & ((!pos1) & pos2);
+
+  uint64_t cmp_gt = ((fixed) (op1) > (fixed) (op2));
+  uint64_t cmp_lt = ((fixed) (op1) < (fixed) (op2));
+
+  int8_t result =
+    MASK_UNLESS( nans, 1 ) |
+    MASK_UNLESS( !nans,
+        MASK_UNLESS( gt, 1) |
+        MASK_UNLESS( lt, -1) |
+        MASK_UNLESS(!(gt|lt),
+          MASK_UNLESS(cmp_gt, 1) |
+          MASK_UNLESS(cmp_lt, -1)));
+  return result;
+}
+
+FIX_INLINE fixed fix_neg_inline(fixed op1) {
+  // Flip our infs
+  // NaN is still NaN
+  // Because we're two's complement, FIX_MIN has no inverse. Make it positive
+  // infinity...
+  uint64_t isinfpos = FIX_IS_INF_NEG(op1) | (op1 == FIX_MIN);
+  uint64_t isinfneg = FIX_IS_INF_POS(op1);
+  uint64_t isnan = FIX_IS_NAN(op1);
+
+  // 2s comp negate the data bits
+  fixed tempresult = FIX_DATA_BITS(((~op1) + 4));
+
+  // Combine
+  return FIX_IF_NAN(isnan) |
+    FIX_IF_INF_POS(isinfpos & (!isnan)) |
+    FIX_IF_INF_NEG(isinfneg & (!isnan)) |
+    FIX_DATA_BITS(tempresult);
+}
+
+FIX_INLINE fixed fix_abs_inline(fixed op1) {
+  uint64_t isinfpos = FIX_IS_INF_POS(op1);
+  uint64_t isinfneg = FIX_IS_INF_NEG(op1);
+  uint64_t isnan = FIX_IS_NAN(op1);
+
+  fixed tempresult = MASK_UNLESS(FIX_TOP_BIT(~op1),                  op1       ) |
+                     MASK_UNLESS(FIX_TOP_BIT( op1), FIX_DATA_BITS(((~op1) + 4)));
+
+  /* check for FIX_MIN */
+  isinfpos |= (!(isinfpos | isinfneg)) & (!!FIX_TOP_BIT(op1)) & (op1 == tempresult);
+
+  return FIX_IF_NAN(isnan) |
+    FIX_IF_INF_POS((isinfpos | isinfneg) & (!isnan)) |
+    FIX_DATA_BITS(tempresult);
+}
+
+FIX_INLINE fixed fix_add_inline(fixed op1, fixed op2) {
+  uint64_t isnan = FIX_IS_NAN(op1) | FIX_IS_NAN(op2);
+  uint64_t isinfpos = FIX_IS_INF_POS(op1) | FIX_IS_INF_POS(op2);
+  uint64_t isinfneg = FIX_IS_INF_NEG(op1) | FIX_IS_INF_NEG(op2);
+
+  fixed tempresult = op1 + op2;
+
+  // check if we're overflowing: adding two positive numbers that results in a
+  // 'negative' number:
+  //   if both inputs are positive (top bit == 0) and the result is 'negative'
+  //   (top bit nonzero)
+  isinfpos |= ((FIX_TOP_BIT(op1) | FIX_TOP_BIT(op2)) == 0x0)
+    & (FIX_TOP_BIT(tempresult) != 0x0);
+
+  // check if there's negative infinity overflow
+  isinfneg |= ((FIX_TOP_BIT(op1) & FIX_TOP_BIT(op2)) == FIX_TOP_BIT_MASK)
+    & (FIX_TOP_BIT(tempresult) == 0x0);
+
+  // Force infpos to win in cases where it is unclear
+  isinfneg &= !isinfpos;
+
+  return FIX_IF_NAN(isnan) |
+    FIX_IF_INF_POS(isinfpos & (!isnan)) |
+    FIX_IF_INF_NEG(isinfneg & (!isnan)) |
+    FIX_DATA_BITS(tempresult);
+}
+
+FIX_INLINE fixed fix_mul_inline(fixed op1, fixed op2) {
+  uint64_t isinfop1 = (FIX_IS_INF_NEG(op1) | FIX_IS_INF_POS(op1));
+  uint64_t isinfop2 = (FIX_IS_INF_NEG(op2) | FIX_IS_INF_POS(op2));
+  uint64_t isnegop1 = FIX_IS_INF_NEG(op1) | (FIX_IS_NEG(op1) & !isinfop1);
+  uint64_t isnegop2 = FIX_IS_INF_NEG(op2) | (FIX_IS_NEG(op2) & !isinfop2);
+
+  uint64_t isnan = FIX_IS_NAN(op1) | FIX_IS_NAN(op2);
+  uint64_t isinf = 0;
+
+  uint64_t iszero = (op1 == FIX_ZERO) | (op2 == FIX_ZERO);
+
+  // ROUND_TO_EVEN_64 rounds the same as ROUND_TO_EVEN, but vectorizes.
+  fixed tmp = ROUND_TO_EVEN_64(FIX_MUL_64(op1, op2, isinf), FIX_FLAG_BITS) << FIX_FLAG_BITS;
+
+  isinf = (!iszero) & (isinfop1 | isinfop2 | isinf) & (!isnan);
+
+  uint64_t isinfpos = isinf & !(isnegop1 ^ isnegop2);
+  uint64_t isinfneg = isinf & (isnegop1 ^ isnegop2);
+
+  return FIX_IF_NAN(isnan) |
+    FIX_IF_INF_POS(isinfpos & (!isnan)) |
+    FIX_IF_INF_NEG(isinfneg & (!isnan)) |
+    FIX_DATA_BITS(tmp);
+}
+
+/* Works out fix_div's special cases, given fix_div_64's result. See fix_div in
+ * ftfp.c for the table of them. */
+FIX_INLINE fixed fix_div_special(fixed op1, fixed op2, fixed tempresult, uint64_t isinf) {
+  uint64_t divbyzero = op2 == FIX_ZERO;
+
+  uint64_t isinfop1 = (FIX_IS_INF_NEG(op1) | FIX_IS_INF_POS(op1));
+  uint64_t isinfop2 = (FIX_IS_INF_NEG(op2) | FIX_IS_INF_POS(op2));
+
+  uint64_t isnegop1 = FIX_IS_INF_NEG(op1) | (FIX_IS_NEG(op1) & !isinfop1);
+  uint64_t isnegop2 = FIX_IS_INF_NEG(op2) | (FIX_IS_NEG(op2) & !isinfop2);
+
+  uint64_t isnan = FIX_IS_NAN(op1) | FIX_IS_NAN(op2) | ((op1 == FIX_ZERO) & (op2 == FIX_ZERO));
+
+  uint64_t inf = (isinf | isinfop1) & (!isnan);
+  uint64_t isinfpos = (inf & !(isnegop1 ^ isnegop2)) | (divbyzero & !isnegop1);
+  uint64_t isinfneg = (inf & (isnegop1 ^ isnegop2)) | (divbyzero & isnegop1);
+
+  uint64_t iszero = (!(isinfop1)) & isinfop2;
+
+  return FIX_IF_NAN(isnan) |
+    FIX_IF_INF_POS(isinfpos & (!isnan) & (!iszero)) |
+    FIX_IF_INF_NEG(isinfneg & (!isnan) & (!iszero)) |
+    MASK_UNLESS(!iszero, FIX_DATA_BITS(tempresult));
+}
+
+FIX_INLINE fixed fix_div_inline(fixed op1, fixed op2) {
+  uint8_t isinf = 0;
+
+  fixed tempresult = fix_div_64(op1, op2, &isinf);
+
+  return fix_div_special(op1, op2, tempresult, isinf);
+}
+
+///////////////////////////////////////
+//  Pieces of fix_exp and the logs
+///////////////////////////////////////
+
+/* These are the loops in power.c that do nearly all of the multiplying. They're
+ * here so that the AVX2 kernels can finish off odd elements with them. */
+
+/* Computes coefs[degree] * m^degree + ... + coefs[1] * m, as fix_ln_poly and
+ * its siblings do: Horner's rule, leaving off the constant term. */
+FIX_INLINE fix_internal fix_intern_poly(fix_internal m, const fix_internal* coefs,
+    int degree, uint8_t* overflow) {
+  uint8_t ovf = 0;
+  fix_internal tmp = FIX_MUL_INTERN(m, coefs[degree], ovf);
+
+  for(int k = degree - 1; k >= 1; k--) {
+    tmp = FIX_MUL_INTERN(m, tmp + coefs[k], ovf);
+  }
+
+  *overflow |= ovf;
+  return tmp;
+}
+
+/* The Taylor series for e^x, in fix_internal, to terms terms. inv[n] is 1/n. */
+FIX_INLINE fix_internal fix_exp_series(fix_internal x, const fix_internal* inv,
+    int terms, uint8_t* overflow) {
+  fix_internal e_x = 1ull << FIX_INTERN_FRAC_BITS;
+  fix_internal term = 1ull << FIX_INTERN_FRAC_BITS;
+  uint8_t ovf = 0;
+
+  for(int i = 1; i < terms; i ++) {
+    term = FIX_MUL_INTERN(term, x, ovf);
+    term = FIX_MUL_INTERN(term, inv[i], ovf);
+
+    e_x += term;
+  }
+
+  *overflow |= ovf;
+  return e_x;
+}
+
+/* Squares rshift * 2^rint_bits squarings times, keeping rshift's top bit set.
+ * It always goes round loops times, and leaves the number alone once squarings
+ * runs out. */
+FIX_INLINE void fix_exp_square(uint64_t* rshift, int64_t* rint_bits,
+    uint64_t squarings, int loops) {
+  uint64_t r = *rshift;
+  int64_t bits = *rint_bits;
+
+  for(int i = 0; i < loops; i++) {
+    uint64_t r2 = MUL_64_TOP(r, r);
+
+    // r2 will represent a number between [0.25, 1) in 0.64 fixed. Therefore,
+    // it _might_ have a zero top bit. If it does, take it off.
+    r = MASK_UNLESS(squarings >  0, r2 << !(FIX_TOP_BIT(r2))) |
+        MASK_UNLESS(squarings == 0, r);
+
+    bits = bits + MASK_UNLESS(squarings > 0, bits - !FIX_TOP_BIT(r2));
+
+    squarings = MASK_UNLESS(squarings > 0, squarings-1);
+  }
+
+  *rshift = r;
+  *rint_bits = bits;
+}
+
+///////////////////////////////////////
+//  SIMD kernels
+///////////////////////////////////////
+
+/* Hand-written kernels for the _array functions, in array_avx2.c and
+ * array_avx512.c. They're compiled with target attributes rather than flags,
+ * so the library still runs anywhere, and array.c and power.c only call them
+ * when the CPU has the instructions. Each one handles all n elements, and gives exactly
+ * what the scalar functions do. cordic.c's trig arrays instead compile the
+ * same block code twice, once as FIX_AVX2. */
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define FIX_X86_SIMD 1
+#else
+#define FIX_X86_SIMD 0
+#endif
+
+/* Calls call, and returns from the function it's in, if has() says the CPU can
+ * run it. The check is on the CPU, never the data. */
+#if FIX_X86_SIMD
+#define FIX_USE_KERNEL(has, call) \
+  if(has()) { \
+    call; \
+    return; \
+  }
+#else
+#define FIX_USE_KERNEL(has, call)
+#endif
+
+#define FIX_USE_AVX2(call) FIX_USE_KERNEL(fix_cpu_has_avx2, call)
+#define FIX_USE_IFMA(call) FIX_USE_KERNEL(fix_cpu_has_ifma, call)
+
+#if FIX_X86_SIMD
+/* For the kernels, and for code that's written to vectorize and is compiled a
+ * second time for AVX2. */
+#define FIX_AVX2 __attribute__((target("avx2")))
+
+FIX_INLINE int fix_cpu_has_avx2(void) {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+}
+
+FIX_INLINE int fix_cpu_has_ifma(void) {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma");
+}
+
+void fix_cmp_array_avx2(int8_t* result, const fixed* op1, const fixed* op2, size_t n);
+void fix_neg_array_avx2(fixed* result, const fixed* op1, size_t n);
+void fix_abs_array_avx2(fixed* result, const fixed* op1, size_t n);
+void fix_add_array_avx2(fixed* result, const fixed* op1, const fixed* op2, size_t n);
+void fix_sub_array_avx2(fixed* result, const fixed* op1, const fixed* op2, size_t n);
+void fix_mul_array_avx2(fixed* result, const fixed* op1, const fixed* op2, size_t n);
+void fix_add_scalar_array_avx2(fixed* result, const fixed* op1, fixed op2, size_t n);
+void fix_mul_scalar_array_avx2(fixed* result, const fixed* op1, fixed op2, size_t n);
+
+/* Stages of fix_exp_array and the log arrays, in power.c. Each is one of the
+ * functions above, on n elements. The overflow flags come back as 0 or 1. */
+void fix_intern_poly_array_avx2(fix_internal* result, uint64_t* overflow,
+    const fix_internal* m, const fix_internal* coefs, int degree, size_t n);
+void fix_exp_series_array_avx2(fix_internal* e_x, uint64_t* overflow,
+    const fix_internal* x, const fix_internal* inv, int terms, size_t n);
+void fix_exp_square_array_avx2(uint64_t* rshift, int64_t* rint_bits,
+    const uint64_t* squarings, int loops, size_t n);
+
+void fix_mul_array_ifma(fixed* result, const fixed* op1, const fixed* op2, size_t n);
+void fix_mul_scalar_array_ifma(fixed* result, const fixed* op1, fixed op2, size_t n);
+#endif
 
 #endif
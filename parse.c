@@ -0,0 +1,426 @@
+#include "ftfp.h"
+#include "internal.h"
+
+// Contains the decimal parser for libftfp.
+
+/* The parser is a state machine, run over every byte of the buffer. Rather
+ * than branch, or index a table with the input, each character class has a
+ * 64-bit word holding the next state for every current state, one nibble each,
+ * and we shift the current state's nibble out. */
+#define PARSE_LEAD   0 // leading whitespace
+#define PARSE_SIGN   1 // just after a sign
+#define PARSE_INT    2 // in the integer digits
+#define PARSE_DOT    3 // a leading '.', with no digits yet
+#define PARSE_FRAC   4 // in the fraction digits
+#define PARSE_WORD   5 // in a word; we accept inf, infinity and nan
+#define PARSE_TRAIL  6 // trailing whitespace
+#define PARSE_END    7 // past a NUL; everything from here on is ignored
+#define PARSE_ERR    8
+
+#define PARSE_TRANS(lead, sign, int, dot, frac, word, trail) \
+  (((uint64_t) (lead)       ) | ((uint64_t) (sign)  <<  4) | \
+   ((uint64_t) (int)   <<  8) | ((uint64_t) (dot)   << 12) | \
+   ((uint64_t) (frac)  << 16) | ((uint64_t) (word)  << 20) | \
+   ((uint64_t) (trail) << 24) | ((uint64_t) PARSE_END << 28) | \
+   ((uint64_t) PARSE_ERR << 32))
+
+#define PARSE_ON_SPACE PARSE_TRANS(PARSE_LEAD, PARSE_ERR, PARSE_TRAIL, PARSE_ERR,  \
+                                   PARSE_TRAIL, PARSE_TRAIL, PARSE_TRAIL)
+#define PARSE_ON_SIGN  PARSE_TRANS(PARSE_SIGN, PARSE_ERR, PARSE_ERR, PARSE_ERR,    \
+                                   PARSE_ERR, PARSE_ERR, PARSE_ERR)
+#define PARSE_ON_DIGIT PARSE_TRANS(PARSE_INT, PARSE_INT, PARSE_INT, PARSE_FRAC,    \
+                                   PARSE_FRAC, PARSE_ERR, PARSE_ERR)
+#define PARSE_ON_DOT   PARSE_TRANS(PARSE_DOT, PARSE_DOT, PARSE_FRAC, PARSE_ERR,    \
+                                   PARSE_ERR, PARSE_ERR, PARSE_ERR)
+#define PARSE_ON_ALPHA PARSE_TRANS(PARSE_WORD, PARSE_WORD, PARSE_ERR, PARSE_ERR,   \
+                                   PARSE_ERR, PARSE_WORD, PARSE_ERR)
+#define PARSE_ON_NUL   PARSE_TRANS(PARSE_ERR, PARSE_ERR, PARSE_END, PARSE_ERR,     \
+                                   PARSE_END, PARSE_END, PARSE_END)
+#define PARSE_ON_OTHER PARSE_TRANS(PARSE_ERR, PARSE_ERR, PARSE_ERR, PARSE_ERR,     \
+                                   PARSE_ERR, PARSE_ERR, PARSE_ERR)
+
+// Words, lowercased, packed big-endian into a uint64_t.
+#define PARSE_WORD_INF      0x696e66ull
+#define PARSE_WORD_INFINITY 0x696e66696e697479ull
+#define PARSE_WORD_NAN      0x6e616eull
+
+/* Fraction digits are kept in decimal, in words of 19, which is as many as fit.
+ * Rounding correctly only needs the first FIX_FRAC_BITS + 1 of them: a tie
+ * between two fixeds takes exactly that many digits to write, so if those
+ * digits don't say which side of a tie we're on, they're the tie, and whether
+ * any later digit is nonzero decides it. */
+#define PARSE_CHUNK_DIGITS 19
+#define PARSE_CHUNKS ((FIX_FRAC_BITS + PARSE_CHUNK_DIGITS) / PARSE_CHUNK_DIGITS)
+#define PARSE_TEN_18 1000000000000000000ull
+#define PARSE_TEN_19 10000000000000000000ull
+// floor((2^128 - 1) / 10^19) - 2^64
+#define PARSE_TEN_19_INV 0xd83c94fb6d2ac34aull
+
+// fix_parse_array works out the values of this many bytes at a time.
+#define PARSE_BLOCK 8
+
+// Everything the parser knows about the field it's in.
+typedef struct {
+  uint64_t state;
+  uint64_t neg;
+  uint64_t acc;
+
+  uint64_t word;
+  uint64_t wordlen;
+
+  // The fraction digits, each in its place in frac[chunk].
+  uint64_t frac[PARSE_CHUNKS];
+  uint64_t place;
+  uint64_t chunk;
+  uint64_t sticky;
+} parse_field;
+
+/* What fix_parse_array keeps of the field for each byte of a block, as it was
+ * just before that byte. The bytes are innermost, so the compiler vectorizes
+ * across them. */
+typedef struct {
+  uint64_t state[PARSE_BLOCK];
+  uint64_t neg[PARSE_BLOCK];
+  uint64_t acc[PARSE_BLOCK];
+  uint64_t word[PARSE_BLOCK];
+  uint64_t wordlen[PARSE_BLOCK];
+  uint64_t frac[PARSE_CHUNKS][PARSE_BLOCK];
+  uint64_t sticky[PARSE_BLOCK];
+} parse_block;
+
+FIX_INLINE void parse_start(parse_field* p) {
+  p->state = PARSE_LEAD;
+  p->neg = 0;
+  p->acc = 0;
+  p->word = 0;
+  p->wordlen = 0;
+  for(int j = 0; j < PARSE_CHUNKS; j++) {
+    p->frac[j] = 0;
+  }
+  p->place = PARSE_TEN_18;
+  p->chunk = 0;
+  p->sticky = 0;
+}
+
+/* Works out how byte c moves the parser on: the next state for every current
+ * state, one nibble each, as in PARSE_TRANS. If delims is set, a newline or
+ * comma ends the field, and takes every state back to PARSE_LEAD; since that's
+ * 0, and nothing else ends up all 0, it shows as 0. */
+FIX_INLINE uint64_t parse_trans(uint8_t c, uint8_t delims) {
+  uint8_t lower = c | 0x20;
+  uint8_t d = c - '0';
+
+  uint8_t isdelim = delims & ((c == '\n') | (c == ','));
+  uint8_t isspace = ((c == ' ') | (c == '\t') | (c == '\r') | (c == '\n')) & !isdelim;
+  uint8_t issign = (c == '+') | (c == '-');
+  uint8_t isdigit = d < 10;
+  uint8_t isdot = c == '.';
+  uint8_t isalpha = (lower >= 'a') & (lower <= 'z');
+  uint8_t isnul = c == '\0';
+  uint8_t isother = !(isdelim | isspace | issign | isdigit | isdot | isalpha | isnul);
+
+  return MASK_UNLESS_64(isspace, PARSE_ON_SPACE) |
+    MASK_UNLESS_64(issign,  PARSE_ON_SIGN) |
+    MASK_UNLESS_64(isdigit, PARSE_ON_DIGIT) |
+    MASK_UNLESS_64(isdot,   PARSE_ON_DOT) |
+    MASK_UNLESS_64(isalpha, PARSE_ON_ALPHA) |
+    MASK_UNLESS_64(isnul,   PARSE_ON_NUL) |
+    MASK_UNLESS_64(isother, PARSE_ON_OTHER);
+}
+
+// Reads one more byte, c, which moves the parser on as trans says.
+FIX_INLINE void parse_byte(parse_field* p, uint8_t c, uint64_t trans) {
+  uint8_t lower = c | 0x20;
+  uint64_t d = (uint64_t) (uint8_t) (c - '0');
+  uint8_t isdigit = d < 10;
+  uint8_t isdelim = trans == 0;
+
+  uint64_t next = (trans >> (p->state * 4)) & 0xf;
+
+  p->neg |= (next == PARSE_SIGN) & (c == '-');
+
+  /* Once the integer part gets to 2^59, another digit makes it too big for any
+   * fixed. From then on bit 62 stays set, however the rest wraps. */
+  uint8_t isint = isdigit & (next == PARSE_INT);
+  uint64_t nacc = (p->acc * 10 + d) | MASK_UNLESS_64(p->acc >> 59, ((uint64_t) 1) << 62);
+  p->acc = MASK_UNLESS_64(isint, nacc) | MASK_UNLESS_64(!isint, p->acc);
+
+  uint8_t isword = next == PARSE_WORD;
+  p->word = MASK_UNLESS_64(isword, (p->word << 8) | lower) | MASK_UNLESS_64(!isword, p->word);
+  p->wordlen += isword;
+
+  /* Add d times place into the current word of fraction digits, then step
+   * place down, or on to the next word. Digits past the last word only matter
+   * through the sticky bit. */
+  uint8_t isfrac = isdigit & (next == PARSE_FRAC);
+  uint64_t dplace = MASK_UNLESS_64(isfrac, d * p->place);
+  for(int j = 0; j < PARSE_CHUNKS; j++) {
+    p->frac[j] += MASK_UNLESS_64(p->chunk == j, dplace);
+  }
+  p->sticky |= isfrac & (p->chunk >= PARSE_CHUNKS) & (d != 0);
+
+  /* place is a power of ten, so it divides by 10 exactly, and halving it then
+   * multiplying by the inverse of 5 mod 2^64 does that. */
+  uint8_t wrap = p->place == 1;
+  uint64_t nplace = (p->place >> 1) * 0xcccccccccccccccdull;
+  nplace = MASK_UNLESS_64(wrap, PARSE_TEN_18) | MASK_UNLESS_64(!wrap, nplace);
+  p->place = MASK_UNLESS_64(isfrac, nplace) | MASK_UNLESS_64(!isfrac, p->place);
+  p->chunk += isfrac & wrap;
+
+  p->state = next;
+
+  // Start the next field afresh.
+  p->neg &= !isdelim;
+  p->acc = MASK_UNLESS_64(!isdelim, p->acc);
+  p->word = MASK_UNLESS_64(!isdelim, p->word);
+  p->wordlen = MASK_UNLESS_64(!isdelim, p->wordlen);
+  for(int j = 0; j < PARSE_CHUNKS; j++) {
+    p->frac[j] = MASK_UNLESS_64(!isdelim, p->frac[j]);
+  }
+  p->place = MASK_UNLESS_64(isdelim, PARSE_TEN_18) | MASK_UNLESS_64(!isdelim, p->place);
+  p->chunk = MASK_UNLESS_64(!isdelim, p->chunk);
+  p->sticky &= !isdelim;
+}
+
+FIX_INLINE void parse_keep(parse_block* k, size_t j, const parse_field* p) {
+  k->state[j] = p->state;
+  k->neg[j] = p->neg;
+  k->acc[j] = p->acc;
+  k->word[j] = p->word;
+  k->wordlen[j] = p->wordlen;
+  for(int i = 0; i < PARSE_CHUNKS; i++) {
+    k->frac[i][j] = p->frac[i];
+  }
+  k->sticky[j] = p->sticky;
+}
+
+/* The fraction is r = 0.d1 d2 ..., kept as R = floor(r * 2^64) and a sticky bit
+ * for whether r is any larger than that. Going from the last word of digits
+ * back to the first, each step is r = (w + r) / 10^19. Since R is an integer,
+ * floor((w * 2^64 + R + anything below 1) / 10^19) is floor((w * 2^64 + R) /
+ * 10^19), so R stays exact, and only the remainder feeds the sticky bit.
+ *
+ * This takes one step: it sets *R to floor((w * 2^64 + *R) / 10^19), and sets
+ * *sticky if that wasn't exact. It's Moller and Granlund's division by a
+ * constant, with a precomputed reciprocal; 10^19 has its top bit set, so it
+ * needs no normalizing. */
+FIX_INLINE void parse_frac_step(uint64_t w, uint64_t* R, uint64_t* sticky) {
+  uint64_t lo = *R;
+  uint64_t q0;
+  uint64_t q1;
+  UNSAFE_UNSIGNED_MUL_64_64_128(w, PARSE_TEN_19_INV, q0, q1);
+  q0 += lo;
+  q1 += w + (q0 < lo) + 1;
+
+  // q1 is the quotient, or one more than it, or one less.
+  uint64_t r = lo - q1 * PARSE_TEN_19;
+  uint64_t over = r > q0;
+  q1 -= over;
+  r += MASK_UNLESS_64(over, PARSE_TEN_19);
+  uint64_t under = r >= PARSE_TEN_19;
+  q1 += under;
+  r -= MASK_UNLESS_64(under, PARSE_TEN_19);
+
+  *R = q1;
+  *sticky |= r != 0;
+}
+
+/* Works out the value of a field that ends in the given state, from what the
+ * parser kept of it, and its fraction as parse_frac_step leaves it. Returns 0,
+ * or -1 if it's malformed. */
+FIX_INLINE int8_t parse_value(uint64_t state, uint64_t neg, uint64_t acc, uint64_t word,
+    uint64_t wordlen, uint64_t R, uint64_t sticky, fixed* result) {
+  // Round the fraction to FIX_FRAC_BITS; it may round up to 1.
+  uint64_t s = 64 - FIX_FRAC_BITS;
+  uint64_t lowbit = (R >> s) & 0x1;
+  uint64_t highroundbit = (R >> (s - 1)) & 0x1;
+  uint64_t restroundbits = (R & ((((uint64_t) 1) << (s - 1)) - 1)) | sticky;
+  uint64_t frac = (R >> s) + ROUND_TO_EVEN_ADDITION(lowbit, highroundbit, restroundbits);
+
+  // The magnitude, in epsilons, can be as much as 2^61 if we're negative.
+  uint64_t intlimit = ((uint64_t) 1) << (FIX_INT_BITS - 1);
+  uint64_t overflow = acc > intlimit;
+  uint64_t m = (MASK_UNLESS_64(!overflow, acc) << FIX_FRAC_BITS) + frac;
+  uint64_t limit = (((uint64_t) 1) << (FIX_BITS - FIX_FLAG_BITS - 1)) - !neg;
+  overflow |= m > limit;
+
+  uint64_t isword = wordlen != 0;
+  uint64_t isinf = (word == PARSE_WORD_INF) | (word == PARSE_WORD_INFINITY);
+  uint64_t isnan = word == PARSE_WORD_NAN;
+  uint64_t wordok = (wordlen <= 8) & (isinf | isnan);
+
+  /* A field can end in PARSE_INT, or anywhere from PARSE_FRAC to PARSE_END.
+   * Without a word, it can only get to those with a digit. */
+  uint64_t valid = ((state == PARSE_INT) | (state - PARSE_FRAC <= PARSE_END - PARSE_FRAC)) &
+    ((!isword) | wordok);
+
+  isnan = (!valid) | (isword & isnan);
+  isinf = valid & ((isword & isinf) | ((!isword) & overflow));
+  uint64_t isinfpos = isinf & !neg;
+  uint64_t isinfneg = isinf & neg;
+
+  uint64_t f = m << FIX_FLAG_BITS;
+  f = MASK_UNLESS_64( neg, (~f) + 1) |
+      MASK_UNLESS_64(!neg, f);
+
+  *result = FIX_IF_NAN(isnan) |
+    FIX_IF_INF_POS(isinfpos & (!isnan)) |
+    FIX_IF_INF_NEG(isinfneg & (!isnan)) |
+    MASK_UNLESS(!(isinfpos | isinfneg | isnan), FIX_DATA_BITS(f));
+
+  return MASK_UNLESS(!valid, -1);
+}
+
+// Works out the value of the field read so far, as if it ended here.
+FIX_INLINE int8_t parse_finish(const parse_field* p, fixed* result) {
+  uint64_t R = 0;
+  uint64_t sticky = p->sticky;
+  for(int i = PARSE_CHUNKS - 1; i >= 0; i--) {
+    parse_frac_step(p->frac[i], &R, &sticky);
+  }
+
+  return parse_value(p->state, p->neg, p->acc, p->word, p->wordlen, R, sticky, result);
+}
+
+int8_t fix_parse(const char* buf, size_t len, fixed* result) {
+  parse_field p;
+  parse_start(&p);
+
+  for(size_t i = 0; i < len; i++) {
+    parse_byte(&p, (uint8_t) buf[i], parse_trans((uint8_t) buf[i], 0));
+  }
+
+  return parse_finish(&p, result);
+}
+
+/* fix_parse_array makes one pass over buf, a block of PARSE_BLOCK bytes at a
+ * time. For each byte, it keeps the field as it was just before that byte, then
+ * works out all their values together (the Makefile adds -ftree-vectorize for
+ * this file). The values at delimiters are picked out into slots with masked
+ * selects, and the block goes into result after the count that came before it.
+ * So the only memory access that depends on buf is where each block goes. A
+ * store that isn't wanted writes result[n - 1] back as it was, so n can't be 0.
+ * As in cordic.c, this is compiled again for AVX2, and used if the CPU has it. */
+FIX_INLINE void parse_blocks(fixed* result, size_t n, const char* buf, size_t len,
+    size_t* countp, size_t* startp) {
+  size_t count = 0;
+  size_t start = 0;
+
+  parse_field p;
+  parse_start(&p);
+
+  for(size_t b = 0; b < len; b += PARSE_BLOCK) {
+    parse_block k;
+    uint64_t trans[PARSE_BLOCK];
+    size_t base = count;
+    size_t m = (len - b < PARSE_BLOCK) ? len - b : PARSE_BLOCK;
+
+    /* The value at each byte, and the slot it goes in: its count, from base,
+     * if the byte ends a field, and PARSE_BLOCK, which is no slot, if not. */
+    fixed value[PARSE_BLOCK];
+    uint64_t slot[PARSE_BLOCK];
+
+    // The last block is padded out with NULs, which are never read.
+    uint8_t bytes[PARSE_BLOCK];
+    for(size_t j = 0; j < PARSE_BLOCK; j++) {
+      bytes[j] = 0;
+    }
+    for(size_t j = 0; j < m; j++) {
+      bytes[j] = (uint8_t) buf[b + j];
+    }
+    for(size_t j = 0; j < PARSE_BLOCK; j++) {
+      trans[j] = parse_trans(bytes[j], 1);
+    }
+
+    for(size_t j = 0; j < m; j++) {
+      uint8_t isend = (trans[j] == 0) & (count < n);
+
+      parse_keep(&k, j, &p);
+      slot[j] = MASK_UNLESS_64(isend, count - base) | MASK_UNLESS_64(!isend, PARSE_BLOCK);
+      count += isend;
+      start = MASK_UNLESS_64(isend, b + j + 1) | MASK_UNLESS_64(!isend, start);
+
+      parse_byte(&p, bytes[j], trans[j]);
+    }
+    for(size_t j = m; j < PARSE_BLOCK; j++) {
+      parse_keep(&k, j, &p);
+      slot[j] = PARSE_BLOCK;
+    }
+
+    uint64_t R[PARSE_BLOCK];
+    uint64_t sticky[PARSE_BLOCK];
+    for(size_t j = 0; j < PARSE_BLOCK; j++) {
+      R[j] = 0;
+      sticky[j] = k.sticky[j];
+    }
+    for(int i = PARSE_CHUNKS - 1; i >= 0; i--) {
+      for(size_t j = 0; j < PARSE_BLOCK; j++) {
+        parse_frac_step(k.frac[i][j], &R[j], &sticky[j]);
+      }
+    }
+    for(size_t j = 0; j < PARSE_BLOCK; j++) {
+      parse_value(k.state[j], k.neg[j], k.acc[j], k.word[j], k.wordlen[j], R[j], sticky[j],
+          &value[j]);
+    }
+
+    // Every value is masked into every slot, and only lands in its own.
+    fixed block[PARSE_BLOCK];
+    for(size_t i = 0; i < PARSE_BLOCK; i++) {
+      block[i] = 0;
+    }
+    for(size_t j = 0; j < PARSE_BLOCK; j++) {
+      for(size_t i = 0; i < PARSE_BLOCK; i++) {
+        block[i] |= MASK_UNLESS_64(slot[j] == i, value[j]);
+      }
+    }
+
+    // Past the new values, slots are written back as they were.
+    for(size_t j = 0; j < PARSE_BLOCK; j++) {
+      uint64_t isnew = j < count - base;
+      size_t i = MASK_UNLESS_64(isnew, base + j) | MASK_UNLESS_64(!isnew, n - 1);
+      result[i] = MASK_UNLESS_64(isnew, block[j]) | MASK_UNLESS_64(!isnew, result[i]);
+    }
+  }
+
+  // Whatever follows the last delimiter is a field too, unless it's empty.
+  fixed last;
+  parse_finish(&p, &last);
+  uint64_t islast = (count < n) & (start < len);
+  size_t i = MASK_UNLESS_64(islast, count) | MASK_UNLESS_64(!islast, n - 1);
+  result[i] = MASK_UNLESS_64(islast, last) | MASK_UNLESS_64(!islast, result[i]);
+  count += islast;
+  start = MASK_UNLESS_64(islast, len) | MASK_UNLESS_64(!islast, start);
+
+  *countp = count;
+  *startp = start;
+}
+
+#if FIX_X86_SIMD
+/* flatten inlines everything this calls, so all of it is compiled for AVX2. */
+static FIX_AVX2 __attribute__((flatten)) void parse_blocks_avx2(fixed* result, size_t n,
+    const char* buf, size_t len, size_t* countp, size_t* startp) {
+  parse_blocks(result, n, buf, len, countp, startp);
+}
+#endif
+
+static void parse_array(fixed* result, size_t n, const char* buf, size_t len,
+    size_t* countp, size_t* startp) {
+  FIX_USE_AVX2(parse_blocks_avx2(result, n, buf, len, countp, startp));
+  parse_blocks(result, n, buf, len, countp, startp);
+}
+
+size_t fix_parse_array(fixed* result, size_t n, const char* buf, size_t len,
+    size_t* consumed) {
+  size_t count = 0;
+  size_t start = 0;
+
+  if(n != 0) {
+    parse_array(result, n, buf, len, &count, &start);
+  }
+
+  if(consumed != NULL) {
+    *consumed = start;
+  }
+
+  return count;
+}
@@ -59,6 +59,16 @@ void run_test_p(char* name, void (*function) (char*,fixed), fixed a){
   TEST_INTERNALS( (*function)(buf, a); )
 }
 
+void run_test_pd(char* name, void (*function) (char*,fixed,int32_t), fixed a, int32_t b){
+  char buf[100];
+  TEST_INTERNALS( (*function)(buf, a, b); )
+}
+
+void run_test_sc(char* name, void (*function) (fixed,fixed*,fixed*), fixed a){
+  fixed s, c;
+  TEST_INTERNALS( (*function)(a, &s, &c); )
+}
+
 void run_test_sb(char* name, int8_t (*function) (fixed), fixed a){
   TEST_INTERNALS( (*function)(a); )
 }
@@ -67,6 +77,85 @@ void run_test_db(char* name, int8_t (*function) (fixed,fixed), fixed a, fixed b)
   TEST_INTERNALS( (*function)(a, b); )
 }
 
+void run_test_si(char* name, fixed (*function) (fixed,int32_t), fixed a, int32_t b){
+  TEST_INTERNALS( (*function)(a, b); )
+}
+
+void run_test_sl(char* name, fixed (*function) (fixed,int64_t), fixed a, int64_t b){
+  TEST_INTERNALS( (*function)(a, b); )
+}
+
+void run_test_parse(char* name, int8_t (*function) (const char*,size_t,fixed*), const char* buf){
+  fixed f;
+  size_t len = strlen(buf);
+  TEST_INTERNALS( (*function)(buf, len, &f); )
+}
+
+/* The _array tests run a whole array every PERF_ARRAY_N iterations, so the
+ * cycles reported are per element. */
+#define PERF_ARRAY_N 256
+void run_test_pa(char* name, size_t (*function) (char*,size_t,const fixed*,size_t,char), fixed a){
+  fixed xs[PERF_ARRAY_N];
+  char buf[PERF_ARRAY_N * FIX_PRINT_BUFFER_SIZE];
+  for(int i = 0; i < PERF_ARRAY_N; i++) {
+    xs[i] = fix_mul_i64(a, i);
+  }
+  TEST_INTERNALS( if(ctr % PERF_ARRAY_N == 0) { (*function)(buf, sizeof(buf), xs, PERF_ARRAY_N, ','); } )
+}
+
+/* Parses a comma-separated buffer of PERF_ARRAY_N numbers every len
+ * iterations, so the cycles reported are per byte of input. */
+void run_test_parse_array(char* name, fixed a){
+  fixed xs[PERF_ARRAY_N];
+  fixed out[PERF_ARRAY_N];
+  char buf[PERF_ARRAY_N * FIX_PRINT_BUFFER_SIZE];
+  for(int i = 0; i < PERF_ARRAY_N; i++) {
+    xs[i] = fix_mul_i64(a, i);
+  }
+  fix_sprint_shortest_array(buf, sizeof(buf), xs, PERF_ARRAY_N, ',');
+  size_t len = strlen(buf);
+  TEST_INTERNALS( if(ctr % len == 0) { fix_parse_array(out, PERF_ARRAY_N, buf, len, NULL); } )
+}
+
+void run_test_ua(char* name, void (*function) (fixed*,const fixed*,size_t), fixed a){
+  fixed xs[PERF_ARRAY_N];
+  fixed out[PERF_ARRAY_N];
+  for(int i = 0; i < PERF_ARRAY_N; i++) {
+    xs[i] = a;
+  }
+  TEST_INTERNALS( if(ctr % PERF_ARRAY_N == 0) { (*function)(out, xs, PERF_ARRAY_N); } )
+}
+
+void run_test_da(char* name, void (*function) (fixed*,const fixed*,const fixed*,size_t), fixed a, fixed b){
+  fixed xs[PERF_ARRAY_N];
+  fixed ys[PERF_ARRAY_N];
+  fixed out[PERF_ARRAY_N];
+  for(int i = 0; i < PERF_ARRAY_N; i++) {
+    xs[i] = a;
+    ys[i] = b;
+  }
+  TEST_INTERNALS( if(ctr % PERF_ARRAY_N == 0) { (*function)(out, xs, ys, PERF_ARRAY_N); } )
+}
+
+void run_test_ca(char* name, void (*function) (int8_t*,const fixed*,const fixed*,size_t), fixed a, fixed b){
+  fixed xs[PERF_ARRAY_N];
+  fixed ys[PERF_ARRAY_N];
+  int8_t out[PERF_ARRAY_N];
+  for(int i = 0; i < PERF_ARRAY_N; i++) {
+    xs[i] = a;
+    ys[i] = b;
+  }
+  TEST_INTERNALS( if(ctr % PERF_ARRAY_N == 0) { (*function)(out, xs, ys, PERF_ARRAY_N); } )
+}
+
+void run_test_sa(char* name, void (*function) (fixed*,const fixed*,fixed,size_t), fixed a, fixed b){
+  fixed xs[PERF_ARRAY_N];
+  fixed out[PERF_ARRAY_N];
+  for(int i = 0; i < PERF_ARRAY_N; i++) {
+    xs[i] = a;
+  }
+  TEST_INTERNALS( if(ctr % PERF_ARRAY_N == 0) { (*function)(out, xs, b, PERF_ARRAY_N); } )
+}
 
 int main(int argc, char* argv[]){
   printf(    "function ""  cycles\n");
@@ -87,27 +176,79 @@ int main(int argc, char* argv[]){
   run_test_d ("fix_sub        ",fix_sub,0,0);
   run_test_d ("fix_mul        ",fix_mul,0,0);
   run_test_d ("fix_div        ",fix_div,0,0);
+  run_test_sl("fix_mul_i64    ",fix_mul_i64,10,3);
+  run_test_sl("fix_div_i64    ",fix_div_i64,10,3);
+  printf("\n");
+
+  // Throughput of the _array versions, in cycles per element.
+  run_test_ua("fix_neg_array  ",fix_neg_array,10);
+  run_test_ua("fix_abs_array  ",fix_abs_array,10);
+  run_test_ca("fix_cmp_array  ",fix_cmp_array,10,10);
+  run_test_da("fix_add_array  ",fix_add_array,0,0);
+  run_test_da("fix_sub_array  ",fix_sub_array,0,0);
+  run_test_da("fix_mul_array  ",fix_mul_array,0,0);
+  run_test_da("fix_div_array  ",fix_div_array,0,0);
+  run_test_sa("fix_add_scalar_array",fix_add_scalar_array,0,0);
+  run_test_sa("fix_mul_scalar_array",fix_mul_scalar_array,0,0);
+  run_test_sa("fix_div_scalar_array",fix_div_scalar_array,0,0);
   printf("\n");
 
   run_test_s ("fix_floor      ",fix_floor,10);
   run_test_s ("fix_ceil       ",fix_ceil,10);
+  run_test_s ("fix_round      ",fix_round,10);
+  run_test_s ("fix_trunc      ",fix_trunc,10);
+  run_test_si("fix_round_decimal",fix_round_decimal,10,2);
+  run_test_d ("fix_fmod       ",fix_fmod,10,3);
+  run_test_d ("fix_remainder  ",fix_remainder,10,3);
+  run_test_si("fix_ldexp      ",fix_ldexp,10,3);
   printf("\n");
 
   run_test_s ("fix_exp        ",fix_exp,10);
   run_test_s ("fix_ln         ",fix_ln,10);
   run_test_s ("fix_log2       ",fix_log2,10);
   run_test_s ("fix_log10      ",fix_log10,10);
+  run_test_s ("fix_expm1      ",fix_expm1,10);
+  run_test_s ("fix_log1p      ",fix_log1p,10);
+  run_test_ua("fix_exp_array  ",fix_exp_array,10);
+  run_test_ua("fix_ln_array   ",fix_ln_array,10);
+  run_test_ua("fix_log2_array ",fix_log2_array,10);
+  run_test_ua("fix_log10_array",fix_log10_array,10);
   printf("\n");
 
   run_test_s ("fix_sqrt       ",fix_sqrt,10);
+  run_test_s ("fix_cbrt       ",fix_cbrt,10);
+  run_test_d ("fix_hypot      ",fix_hypot,10,10);
   run_test_d ("fix_pow        ",fix_pow,10,10);
   printf("\n");
 
   run_test_s ("fix_sin        ",fix_sin,10);
   run_test_s ("fix_cos        ",fix_cos,10);
   run_test_s ("fix_tan        ",fix_tan,10);
+  run_test_sc("fix_sincos     ",fix_sincos,10);
+  run_test_ua("fix_sin_array  ",fix_sin_array,10);
+  run_test_ua("fix_cos_array  ",fix_cos_array,10);
+  run_test_s ("fix_sin_turns  ",fix_sin_turns,10);
+  run_test_s ("fix_cos_turns  ",fix_cos_turns,10);
+  run_test_s ("fix_tan_turns  ",fix_tan_turns,10);
+  run_test_sc("fix_sincos_turns",fix_sincos_turns,10);
+  run_test_s ("fix_sinpi      ",fix_sinpi,10);
   //run_test_s ("fix_sin_fast   ",fix_sin_fast,10);
   printf("\n");
 
+  run_test_s ("fix_erf        ",fix_erf,10);
+  run_test_s ("fix_erfc       ",fix_erfc,10);
+  run_test_s ("fix_norm_cdf   ",fix_norm_cdf,10);
+  run_test_s ("fix_norm_ppf   ",fix_norm_ppf,10);
+  run_test_s ("fix_lgamma     ",fix_lgamma,10);
+  run_test_d ("fix_lbeta      ",fix_lbeta,10,10);
+  printf("\n");
+
   run_test_p ("fix_sprint      ",fix_sprint,10);
+  run_test_pd("fix_sprint_digits",fix_sprint_digits,10,6);
+  run_test_p ("fix_sprint_shortest",fix_sprint_shortest,fix_convert_from_double(0.1));
+  run_test_p ("fix_sprint_shortest_fast",fix_sprint_shortest_fast,fix_convert_from_double(0.1));
+  run_test_pa("fix_sprint_array",fix_sprint_array,fix_convert_from_double(0.37));
+  run_test_pa("fix_sprint_shortest_array",fix_sprint_shortest_array,fix_convert_from_double(0.37));
+  run_test_parse("fix_parse      ",fix_parse,"-12345.6789012345678");
+  run_test_parse_array("fix_parse_array (per byte)",fix_convert_from_double(0.37));
 }
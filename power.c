@@ -4,12 +4,19 @@
 
 // Contains the logarithmic, exponential, and square root functions for libftfp.
 
-fixed fix_exp(fixed op1) {
-
-  uint8_t isinfpos = FIX_IS_INF_POS(op1);
-  uint8_t isinfneg = FIX_IS_INF_NEG(op1);
-  uint8_t isnan    = FIX_IS_NAN(op1);
-
+/* fix_exp is done in stages, so that fix_exp_array can run the expensive ones
+ * (fix_exp_series and fix_exp_square, in internal.h) on a block of elements at
+ * a time:
+ *
+ *   fix_exp_reduce     maps op1 into (-2, 2) as a fix_internal x
+ *   fix_exp_series     takes the Taylor series of e^x
+ *   fix_exp_normalize  puts e^x in a one-off floating point format
+ *   fix_exp_square     squares it back up to e^op1
+ *   fix_exp_finish     rounds it to a fixed, and handles the special cases
+ *
+ * fix_exp_reduce sets *squarings to the number of squarings needed; it's
+ * nonzero if op1 was outside (-2, 2), in which case x != op1. */
+FIX_INLINE fix_internal fix_exp_reduce(fixed op1, uint64_t* squarings) {
   uint8_t isneg    = FIX_IS_NEG(op1);
 
   uint8_t log2     = fixed_log2(op1);
@@ -17,8 +24,6 @@ fixed fix_exp(fixed op1) {
 
   uint8_t actuallog = MASK_UNLESS(!isneg, log2) | MASK_UNLESS( isneg, log2_neg);
 
-  INT_INV_LUT;
-
   /* If the number is < 2, then move it directly to the fix_internal format.
    * Otherwise, map it to (-2, 2) in fix_internal. */
   fix_internal scratch =
@@ -38,108 +43,96 @@ fixed fix_exp(fixed op1) {
 
   /* Since we mapped the number down, we'll need to square the result later.
    * Note that we don't need to or/mask in 0. */
-  uint8_t squarings =
+  *squarings =
       /*MASK_UNLESS(actuallog <= FIX_POINT_BITS, 0 ) |*/
       MASK_UNLESS(actuallog > FIX_POINT_BITS, actuallog - FIX_POINT_BITS );
 
-  /*
-   * Use the Taylor series:
-   *
-   *              n=inf
-   *               ---
-   *               \      x^n
-   *     e^x   =    >    -----
-   *               /      n !
-   *               ---
-   *               n=1
-   *
-   * As an optimization, you can generate the next term from the previous term:
-   *
-   *   T(n) = T(n-1) * x / n
-   *
-   * We keep around a LUT of values of 1/n, and can simply multiply instead of divide:
-   *
-   *   T(n) = T(n-1) * x * INV_LUT(n)
-   *
-   * Choosing the number of terms is tricky: since we have a variable number of
-   * fractional bits, we compute when the terms will become zero. That is:
-   *
-   *   Find n s.t.:
-   *
-   *      2^n
-   *     -----   <   2 ^ (-FIX_FRAC_BITS)
-   *      n !
-   *
-   * By summing the log_2( x/n ), you can pick a value for the internal
-   * representation:
-   *
-   * Since we chose this such that the last round adds nothing, we are
-   * guaranteed bit-accurate taylor series approximation (at least in a fix_internal).
-   */
-
-#define FIX_EXP_LOOP 26
-
-  /* To generate the table of fractional bits vs. loop iterations:
-   *
-   * l = 0.
-   * for i in range(1,40):
-   *   l += math.log(x/i,2)
-   *   print "#elif FIX_FRAC_BITS < %d"%(abs(l)-1)
-   *   print "  #define FIX_EXP_LOOP %d"%(i)
-   *   if l < -61:
-   *       break
-   */
-
-  fix_internal e_x = 1ull << FIX_INTERN_FRAC_BITS;
-  fix_internal term = 1ull << FIX_INTERN_FRAC_BITS;
-  uint8_t overflow = 0;
-
-  for(int i = 1; i < FIX_EXP_LOOP; i ++) {
-    term = FIX_MUL_INTERN(term, scratch, overflow);
-    term = FIX_MUL_INTERN(term, LUT_int_inv_integer[i], overflow);
-
-    e_x += term;
-  }
+  return scratch;
+}
 
-  isinfpos |= overflow;
+/*
+ * Use the Taylor series:
+ *
+ *              n=inf
+ *               ---
+ *               \      x^n
+ *     e^x   =    >    -----
+ *               /      n !
+ *               ---
+ *               n=1
+ *
+ * As an optimization, you can generate the next term from the previous term:
+ *
+ *   T(n) = T(n-1) * x / n
+ *
+ * We keep around a LUT of values of 1/n, and can simply multiply instead of divide:
+ *
+ *   T(n) = T(n-1) * x * INV_LUT(n)
+ *
+ * Choosing the number of terms is tricky: since we have a variable number of
+ * fractional bits, we compute when the terms will become zero. That is:
+ *
+ *   Find n s.t.:
+ *
+ *      2^n
+ *     -----   <   2 ^ (-FIX_FRAC_BITS)
+ *      n !
+ *
+ * By summing the log_2( x/n ), you can pick a value for the internal
+ * representation:
+ *
+ * Since we chose this such that the last round adds nothing, we are
+ * guaranteed bit-accurate taylor series approximation (at least in a fix_internal).
+ */
 
-  fix_internal result = e_x;
+#define FIX_EXP_LOOP 26
 
-  // x is in the range [-2^FIX_INT_BITS, 2^FIX_INT_BITS], and we
-  // mapped it to [-2, 2]. We need one squaring for each halving, which means
-  // that squarings can be at most log2(2^FIX_INT_BITS)-2 or
-  // log2(2^FIX_FRAC_BITS)-2.
-  //
-  // (We need to worry about frac bits because negative numbers will map to <= -1,
-  // which produces 0.367, which might then need to multiply itself out of
-  // existence.)
-  //
-  // But that's overzealous: If x is positive, e^x must fit in 2^FIX_INT_BITS,
-  // or we will return FIX_INF_POS.
-  //
-  // If we reduced the number before the approximation (as opposed to leaving it
-  // alone), then x was greater than or equal to 2, and the reduction r will be
-  // >= 1. In this case, the approximation of e^r will produce at least e^1, or
-  // ~2.718. This requires only ceil(log2(ln(2^FIX_INT_BITS))+1) successive
-  // doublings before it will overflow the fixed.
-  //
-  // If x is negative, we need s squarings so that 0.367 will square itself
-  // to < 2^FIX_FRAC_BITS. By the same argument, we need
-  // ceil(log2(ln(2**-FIX_FRAC_BITS))) squarings.
-  //
-  // In python:
-  //
-  // pos_squarings = [(n, math.ceil(math.log(math.log(2**n),2))) for n in range(1,93)]
-  // neg_squarings = [(n, math.ceil(math.log(abs(math.log(2**(-(63-n)))),2))) for n in range(1,61)]
-  // squarings = [(x[0], max(x[1], y[1]) if y is not None else x[1])
-  //              for x,y in itertools.izip_longest(pos_squarings, neg_squarings)]
-  // for k, g in itertools.groupby(squarings, operator.itemgetter(1)):
-  //     int_bits = list(g)
-  //     print "#elif FIX_INT_BITS <= %d"%( max([x for x,y in int_bits]) )
-  //     print "#define FIX_SQUARE_LOOP %d"%(k)
-  //
+/* To generate the table of fractional bits vs. loop iterations:
+ *
+ * l = 0.
+ * for i in range(1,40):
+ *   l += math.log(x/i,2)
+ *   print "#elif FIX_FRAC_BITS < %d"%(abs(l)-1)
+ *   print "  #define FIX_EXP_LOOP %d"%(i)
+ *   if l < -61:
+ *       break
+ */
 
-  // These numbers can be smaller for a 32-bit exp.
+// x is in the range [-2^FIX_INT_BITS, 2^FIX_INT_BITS], and we
+// mapped it to [-2, 2]. We need one squaring for each halving, which means
+// that squarings can be at most log2(2^FIX_INT_BITS)-2 or
+// log2(2^FIX_FRAC_BITS)-2.
+//
+// (We need to worry about frac bits because negative numbers will map to <= -1,
+// which produces 0.367, which might then need to multiply itself out of
+// existence.)
+//
+// But that's overzealous: If x is positive, e^x must fit in 2^FIX_INT_BITS,
+// or we will return FIX_INF_POS.
+//
+// If we reduced the number before the approximation (as opposed to leaving it
+// alone), then x was greater than or equal to 2, and the reduction r will be
+// >= 1. In this case, the approximation of e^r will produce at least e^1, or
+// ~2.718. This requires only ceil(log2(ln(2^FIX_INT_BITS))+1) successive
+// doublings before it will overflow the fixed.
+//
+// If x is negative, we need s squarings so that 0.367 will square itself
+// to < 2^FIX_FRAC_BITS. By the same argument, we need
+// ceil(log2(ln(2**-FIX_FRAC_BITS))) squarings.
+//
+// In python:
+//
+// pos_squarings = [(n, math.ceil(math.log(math.log(2**n),2))) for n in range(1,93)]
+// neg_squarings = [(n, math.ceil(math.log(abs(math.log(2**(-(63-n)))),2))) for n in range(1,61)]
+// squarings = [(x[0], max(x[1], y[1]) if y is not None else x[1])
+//              for x,y in itertools.izip_longest(pos_squarings, neg_squarings)]
+// for k, g in itertools.groupby(squarings, operator.itemgetter(1)):
+//     int_bits = list(g)
+//     print "#elif FIX_INT_BITS <= %d"%( max([x for x,y in int_bits]) )
+//     print "#define FIX_SQUARE_LOOP %d"%(k)
+//
+
+// These numbers can be smaller for a 32-bit exp.
 
 #if FIX_INT_BITS <= 16
 #define FIX_SQUARE_LOOP 6
@@ -151,73 +144,67 @@ fixed fix_exp(fixed op1) {
 #error Unknown number of FIX_INT_BITS in fix_exp
 #endif
 
-  /* We need to square the result a few times. To do this as accurately as
-   * possible, we'd like to keep as many significant bits as we can. To this
-   * end, we build our own one-off floating point format.
-   *
-   * First, result is some number in [e^-2, e^2], which means it's positive.
-   *
-   * Take the floor(log2(result)), and save that as the "int bits" i. Then, in
-   * rshift, shift result such that its MSB is in bit 63. Treated as a 0.64
-   * fixed point value, this number is in [0.5, 1).
-   *
-   *   resultl         = rshift * 2^i
-   *
-   * To square things, we do:
-   *
-   *   result * result = rshift * rshift * 2^i * 2^i
-   *   result * result = rshift * rshift * 2^(i+i)
-   *
-   * Note though, that rshift is in [0.25, 1). We want to keep as many
-   * significant bits as possible. Therefore, if rshift * rshift < 0.5, shift it
-   * up one and subtract off one int bit.
-   *
-   *   r2shift * 2^i' = rshift * rshift * 2^(2i)
-   *
-   *   r2shift = rshift * rshift             if rshift * rshift >= 0.5
-   *   r2shift = rshift * rshift * 2          otherwise.
-   *
-   *   i' = 2i                               if rshift * rshift >= 0.5
-   *   i' = 2i - 1                           if rshift * rshift < 0.5
-   *
-   * Error calculations:
-   *
-   *  rshift begins as a exp result, accurate to 2^FIX_INTERN_FRAC_BITS, or
-   *  2^60.
-   *
-   *  Each time we square the number, we retain 64 significant bits, and lose 64
-   *  less significant bits. This causes an error at each stage of <= X * 2^-64.
-   *  The total error, after n squarings, can then be bounded by:
-   *
-   *    E = ( ( (rshift * (1+2^-60))^2 * (1+2^-64) )^2 ...)^2
-   *
-   *    E = (rshift)^(2^n) * (1 + 2^-60)^(2^n) * (1 + 2^-64)^(2^n - 1)
-   *
-   *  With the maximum of 6 squarings, this gives a maximum error of n * 2^-53.9,
-   *  for almost 54 bits of accuracy.
-   *
-   */
+/* We need to square the result a few times. To do this as accurately as
+ * possible, we'd like to keep as many significant bits as we can. To this
+ * end, we build our own one-off floating point format.
+ *
+ * First, result is some number in [e^-2, e^2], which means it's positive.
+ *
+ * Take the floor(log2(result)), and save that as the "int bits" i. Then, in
+ * rshift, shift result such that its MSB is in bit 63. Treated as a 0.64
+ * fixed point value, this number is in [0.5, 1).
+ *
+ *   resultl         = rshift * 2^i
+ *
+ * To square things, we do:
+ *
+ *   result * result = rshift * rshift * 2^i * 2^i
+ *   result * result = rshift * rshift * 2^(i+i)
+ *
+ * Note though, that rshift is in [0.25, 1). We want to keep as many
+ * significant bits as possible. Therefore, if rshift * rshift < 0.5, shift it
+ * up one and subtract off one int bit.
+ *
+ *   r2shift * 2^i' = rshift * rshift * 2^(2i)
+ *
+ *   r2shift = rshift * rshift             if rshift * rshift >= 0.5
+ *   r2shift = rshift * rshift * 2          otherwise.
+ *
+ *   i' = 2i                               if rshift * rshift >= 0.5
+ *   i' = 2i - 1                           if rshift * rshift < 0.5
+ *
+ * Error calculations:
+ *
+ *  rshift begins as a exp result, accurate to 2^FIX_INTERN_FRAC_BITS, or
+ *  2^60.
+ *
+ *  Each time we square the number, we retain 64 significant bits, and lose 64
+ *  less significant bits. This causes an error at each stage of <= X * 2^-64.
+ *  The total error, after n squarings, can then be bounded by:
+ *
+ *    E = ( ( (rshift * (1+2^-60))^2 * (1+2^-64) )^2 ...)^2
+ *
+ *    E = (rshift)^(2^n) * (1 + 2^-60)^(2^n) * (1 + 2^-64)^(2^n - 1)
+ *
+ *  With the maximum of 6 squarings, this gives a maximum error of n * 2^-53.9,
+ *  for almost 54 bits of accuracy.
+ *
+ */
 
+FIX_INLINE void fix_exp_normalize(fix_internal result, uint64_t* rshift,
+    int64_t* rint_bits) {
   int32_t rlog = fixed_log2(result);
-  fix_internal rshift = (result) << (63 - rlog);
-  int32_t rint_bits = rlog - FIX_INTERN_FRAC_BITS +1; // +1 is for the sign bit we're not using
-
-  fix_internal r2shift = 0;
-
-  for(int i = 0; i < FIX_SQUARE_LOOP; i++) {
-
-    r2shift = MUL_64_TOP(rshift, rshift);
-
-    // r2shift will represent a number between [0.25, 1) in 0.64 fixed. Therefore, it _might_
-    // have a zero top bit. If it does, take it off.
-
-    rshift = MASK_UNLESS(squarings >  0, r2shift << !(FIX_TOP_BIT(r2shift))) |
-             MASK_UNLESS(squarings == 0, rshift);
-
-    rint_bits = rint_bits + MASK_UNLESS(squarings > 0, rint_bits - !FIX_TOP_BIT(r2shift));
+  *rshift = (result) << (63 - rlog);
+  *rint_bits = rlog - FIX_INTERN_FRAC_BITS +1; // +1 is for the sign bit we're not using
+}
 
-    squarings = MASK_UNLESS(squarings > 0, squarings-1);
-  }
+/* overflow is from fix_exp_series. If e^op1 is just too big to fit, *half is
+ * set to e^op1 / 2; otherwise it's zero. */
+FIX_INLINE fixed fix_exp_finish(fixed op1, uint64_t rshift, int64_t rint_bits,
+    uint8_t overflow, fixed* half) {
+  uint8_t isinfpos = FIX_IS_INF_POS(op1) | overflow;
+  uint8_t isinfneg = FIX_IS_INF_NEG(op1);
+  uint8_t isnan    = FIX_IS_NAN(op1);
 
   // If this is positive, we've overflowed the 64-bit range.
   // If this is zero, we've overflowed the sign bit.
@@ -227,6 +214,9 @@ fixed fix_exp(fixed op1) {
   fixed final_result = MASK_UNLESS(shift > (-64 + FIX_FLAG_BITS),
         ROUND_TO_EVEN(rshift, ((-shift) + FIX_FLAG_BITS)) << FIX_FLAG_BITS);
 
+  *half = MASK_UNLESS((shift == 0) & (!isinfpos) & (!isinfneg) & (!isnan),
+        ROUND_TO_EVEN(rshift, FIX_FLAG_BITS + 1) << FIX_FLAG_BITS);
+
   isinfpos |= ((shift >= 0) & (!isinfneg));
 
   // note that we want to return 0 if op1 is FIX_INF_NEG...
@@ -235,6 +225,131 @@ fixed fix_exp(fixed op1) {
     MASK_UNLESS(!isinfneg, FIX_DATA_BITS(final_result));
 }
 
+/* Computes e^op1. Also hands back the pieces fix_expm1 needs: *series is set
+ * to the Taylor series of e^x without its constant term (i.e., e^x - 1), and
+ * *reduced is set if x != op1. *half is as in fix_exp_finish. */
+FIX_INLINE fixed fix_exp_kernel(fixed op1, fix_internal* series, uint8_t* reduced,
+    fixed* half) {
+  INT_INV_LUT;
+
+  uint64_t squarings;
+  fix_internal scratch = fix_exp_reduce(op1, &squarings);
+  *reduced = squarings > 0;
+
+  uint8_t overflow = 0;
+  fix_internal e_x = fix_exp_series(scratch, LUT_int_inv_integer, FIX_EXP_LOOP, &overflow);
+
+  *series = e_x - (1ull << FIX_INTERN_FRAC_BITS);
+
+  uint64_t rshift;
+  int64_t rint_bits;
+  fix_exp_normalize(e_x, &rshift, &rint_bits);
+  fix_exp_square(&rshift, &rint_bits, squarings, FIX_SQUARE_LOOP);
+
+  return fix_exp_finish(op1, rshift, rint_bits, overflow, half);
+}
+
+fixed fix_exp(fixed op1) {
+  fix_internal series;
+  uint8_t reduced;
+  fixed half;
+  return fix_exp_kernel(op1, &series, &reduced, &half);
+}
+
+/* The _array versions of exp and the logs go a block of FIX_POWER_BLOCK elements
+ * at a time. The cheap stages run on each element in turn, and the long chains
+ * of multiplies (the series and squarings, or the polynomial) go to an AVX2
+ * kernel for the whole block. Without AVX2, they just loop over the scalar
+ * functions. */
+#define FIX_POWER_BLOCK 32
+
+#if FIX_X86_SIMD
+static void fix_exp_blocks(fixed* result, const fixed* op1, size_t n) {
+  INT_INV_LUT;
+
+  for(size_t i = 0; i < n; i += FIX_POWER_BLOCK) {
+    size_t b = n - i < FIX_POWER_BLOCK ? n - i : FIX_POWER_BLOCK;
+    fix_internal x[FIX_POWER_BLOCK];
+    uint64_t squarings[FIX_POWER_BLOCK];
+    fix_internal e_x[FIX_POWER_BLOCK];
+    uint64_t overflow[FIX_POWER_BLOCK];
+    uint64_t rshift[FIX_POWER_BLOCK];
+    int64_t rint_bits[FIX_POWER_BLOCK];
+
+    for(size_t j = 0; j < b; j++) {
+      x[j] = fix_exp_reduce(op1[i + j], &squarings[j]);
+    }
+
+    fix_exp_series_array_avx2(e_x, overflow, x, LUT_int_inv_integer, FIX_EXP_LOOP, b);
+
+    for(size_t j = 0; j < b; j++) {
+      fix_exp_normalize(e_x[j], &rshift[j], &rint_bits[j]);
+    }
+
+    fix_exp_square_array_avx2(rshift, rint_bits, squarings, FIX_SQUARE_LOOP, b);
+
+    for(size_t j = 0; j < b; j++) {
+      fixed half;
+      result[i + j] = fix_exp_finish(op1[i + j], rshift[j], rint_bits[j], overflow[j], &half);
+    }
+  }
+}
+#endif
+
+void fix_exp_array(fixed* result, const fixed* op1, size_t n) {
+  FIX_USE_AVX2(fix_exp_blocks(result, op1, n));
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_exp(op1[i]);
+  }
+}
+
+fixed fix_expm1(fixed op1) {
+  uint8_t isinfpos = FIX_IS_INF_POS(op1);
+  uint8_t isinfneg = FIX_IS_INF_NEG(op1);
+  uint8_t isnan    = FIX_IS_NAN(op1);
+
+  fix_internal series;
+  uint8_t reduced;
+  fixed half;
+  fixed e_x = fix_exp_kernel(op1, &series, &reduced, &half);
+
+  fixed neg_one = FIXNUM(-1,0);
+
+  /* If op1 is in (-2, 2), the series is e^op1 - 1 directly, with all 60 bits of
+   * a fix_internal and no 1 to cancel. Otherwise e^op1 is either large or
+   * smaller than e^-2, and subtracting one from it loses nothing. */
+  fixed small = FIX_INTERN_TO_FIXED(series);
+  fixed large = fix_add(e_x, neg_one);
+
+#if FIX_INT_BITS < FIX_INTERN_INT_BITS
+  /* e^2 - 1 doesn't fit in all builds. */
+  isinfpos |= (!reduced) & (!FIX_IS_NEG(op1)) &
+    (((fixed_signed) series >= (fixed_signed) (FIX_INT_MAX << FIX_INTERN_FRAC_BITS)) |
+     FIX_IS_NEG(small));
+#endif
+
+  /* e^op1 may overflow while e^op1 - 1 still fits. Then we have e^op1 / 2, and
+   * e^op1 - 1 = 2 * (e^op1 / 2 - 1/2). */
+  uint8_t edge = half != 0;
+  fixed large_edge = (half - (((fixed) 1) << (FIX_POINT_BITS - 1))) << 1;
+  large = MASK_UNLESS(!edge, large) | MASK_UNLESS(edge, large_edge);
+
+  isinfpos |= reduced & (FIX_IS_INF_POS(large) | (edge & FIX_IS_NEG(large_edge)));
+
+  return FIX_IF_NAN(isnan) |
+    FIX_IF_INF_POS(isinfpos & (!isnan)) |
+    MASK_UNLESS(isinfneg, neg_one) |
+    MASK_UNLESS(!(isinfpos | isinfneg | isnan),
+        MASK_UNLESS(!reduced, FIX_DATA_BITS(small)) |
+        MASK_UNLESS( reduced, FIX_DATA_BITS(large)));
+}
+
+void fix_expm1_array(fixed* result, const fixed* op1, size_t n) {
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_expm1(op1[i]);
+  }
+}
+
   // We don't want to use a inline function here to avoid pointers
   // compute (int) log2(op1)  (as a uint32_t, not fixed)
 
@@ -260,27 +375,71 @@ fixed fix_exp(fixed op1) {
     MASK_UNLESS(log2 >  FIX_INTERN_FRAC_BITS, op1 >> (log2 - FIX_INTERN_FRAC_BITS)); \
   m -= (((fix_internal) 1) << FIX_INTERN_FRAC_BITS);
 
-fixed fix_ln(fixed op1) {
-  /* Approach taken from http://eesite.bitbucket.org/html/software/log_app/log_app.html */
-
-  uint8_t isinfpos = FIX_IS_INF_POS(op1);
-  uint8_t isinfneg = FIX_IS_INF_NEG(op1) | (op1 == 0);
-  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_NEG(op1);
+/* Evaluates ln(1+m) for m in [-0.5, 0.5], leaving off the constant term of
+ * the polynomial so that small m stay accurate relative to their size. */
+FIX_INLINE fix_internal fix_ln_poly(fix_internal m, uint8_t* overflow) {
+  uint8_t ovf = 0;
+  fix_internal tmp;
 
-  FIX_LOG_PROLOG(op1, log2, m);
+  tmp = FIX_MUL_INTERN(m,       FIX_LN_COEF_24, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_23, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_22, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_21, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_20, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_19, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_18, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_17, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_16, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_15, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_14, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_13, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_12, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_11, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_10, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_9, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_8, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_7, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_6, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_5, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_4, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_3, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_2, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_1, ovf);
+
+  *overflow |= ovf;
+  return tmp;
+}
 
+/* Finishes off fix_ln_kernel: ln(op1) is (log2 - FIX_POINT_BITS) * ln(2) +
+ * ln(1+m), and poly is fix_ln_poly(m). */
+FIX_INLINE fixed fix_ln_finish(uint32_t log2, fix_internal poly, uint8_t* overflow) {
   // Python: "0x%016x"%((decimal.Decimal(2).ln() * 2**63)
   //     .quantize(decimal.Decimal('1.'), rounding=decimal.ROUND_HALF_EVEN))
   uint64_t ln2 = 0x58b90bfbe8e7bcd6;
-  uint8_t overflow = 0;
+  uint8_t ovf = 0;
 
   // this will go negative for numbers < 1.
 #if 63 - FIX_POINT_BITS != 0
-  fixed nln2 = MUL_64_N(ln2, ((int64_t) (log2)) - FIX_POINT_BITS, overflow, 63 - FIX_POINT_BITS);
+  fixed nln2 = MUL_64_N(ln2, ((int64_t) (log2)) - FIX_POINT_BITS, ovf, 63 - FIX_POINT_BITS);
 #else
-  fixed nln2 = MUL_64_ALL(ln2, ((int64_t) (log2)) - FIX_POINT_BITS, overflow);
+  fixed nln2 = MUL_64_ALL(ln2, ((int64_t) (log2)) - FIX_POINT_BITS, ovf);
 #endif
 
+  fix_internal tmp = poly + FIX_LN_COEF_0;
+
+  fixed r = FIX_INTERN_TO_FIXED(tmp);
+  r += nln2;
+
+  *overflow |= ovf;
+  return r;
+}
+
+/* Computes ln(op1) for an unsigned op1 with FIX_POINT_BITS of fraction. op1 may
+ * use all 64 bits, which lets fix_log1p take the log of 1+x without
+ * overflowing. The result is unflagged. */
+FIX_INLINE fixed fix_ln_kernel(uint64_t op1, uint8_t* overflow) {
+  FIX_LOG_PROLOG(op1, log2, m);
+
   // now, calculate ln(1+m):
 
   // Use a order-24 polynomial over -5,5, accurate to about 2**-48:
@@ -289,47 +448,28 @@ fixed fix_ln(fixed op1) {
   // octave:86> p = polyfit( x, log(x+1), 24)
   // octave:87> log2(max(abs(polyval(p, x) - log(1+x))))
   // ans = -48.4454111483224
+  return fix_ln_finish(log2, fix_ln_poly(m, overflow), overflow);
+}
 
+/* Splits ln(op1), for an unsigned op1 with FIX_POINT_BITS of fraction, into
+ * n * ln(2) + *rest, and returns n. rest is in [ln(0.75), ln(1.5)). Callers
+ * whose logs don't fit in a fixed can put the pieces back together at their
+ * own scale. */
+int32_t fix_ln_split(uint64_t op1, fix_internal* rest) {
+  FIX_LOG_PROLOG(op1, log2, m);
 
-  // This works, but replicates work:
-  //fix_internal tmp =
-  //  (FIX_MUL_INTERN(m,
-  //      FIX_MUL_INTERN(m,
-  //        FIX_MUL_INTERN(m,
-  //          FIX_LN_COEF_3, overflow)
-  //        + FIX_LN_COEF_2, overflow)
-  //      + FIX_LN_COEF_1, overflow)
-  //    + FIX_LN_COEF_0);
-  fix_internal tmp;
+  uint8_t overflow = 0;
+  *rest = fix_ln_poly(m, &overflow) + FIX_LN_COEF_0;
 
-  tmp = FIX_MUL_INTERN(m,       FIX_LN_COEF_24, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_23, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_22, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_21, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_20, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_19, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_18, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_17, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_16, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_15, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_14, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_13, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_12, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_11, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_10, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_9, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_8, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_7, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_6, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_5, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_4, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_3, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_2, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LN_COEF_1, overflow);
-  tmp =                   tmp + FIX_LN_COEF_0;
+  return ((int32_t) log2) - FIX_POINT_BITS;
+}
 
-  fixed r = FIX_INTERN_TO_FIXED(tmp);
-  r += nln2;
+/* ln, log2 and log10 all flag their results the same way: r is the log of op1,
+ * and overflow says it was too negative to fit. */
+FIX_INLINE fixed fix_log_special(fixed op1, fixed r, uint8_t overflow) {
+  uint8_t isinfpos = FIX_IS_INF_POS(op1);
+  uint8_t isinfneg = FIX_IS_INF_NEG(op1) | (op1 == 0);
+  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_NEG(op1);
 
   isinfneg |= (!isnan) & (!isinfpos) & overflow;
 
@@ -339,24 +479,70 @@ fixed fix_ln(fixed op1) {
     FIX_DATA_BITS(r);
 }
 
-
-fixed fix_log2(fixed op1) {
+fixed fix_ln(fixed op1) {
   /* Approach taken from http://eesite.bitbucket.org/html/software/log_app/log_app.html */
 
-  uint8_t isinfpos = FIX_IS_INF_POS(op1);
-  uint8_t isinfneg = FIX_IS_INF_NEG(op1) | (op1 == 0);
-  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_NEG(op1);
+  uint8_t overflow = 0;
+  fixed r = fix_ln_kernel(op1, &overflow);
 
-  FIX_LOG_PROLOG(op1, log2, m);
+  return fix_log_special(op1, r, overflow);
+}
+
+fixed fix_log1p(fixed op1) {
+  uint8_t isinfpos = FIX_IS_INF_POS(op1);
+  uint8_t isinfneg = op1 == FIXNUM(-1,0);
+  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_INF_NEG(op1) |
+    (FIX_IS_NEG(op1) & ((fixed_signed) op1 < (fixed_signed) FIXNUM(-1,0)));
+
+  /* Near zero, take the polynomial on op1 itself. ln(1+x) ~= x there, so this
+   * keeps the relative accuracy that forming 1+x would throw away. */
+  fixed quarter = ((fixed) 1) << (FIX_POINT_BITS - 2);
+  fixed half    = ((fixed) 1) << (FIX_POINT_BITS - 1);
+  uint8_t small = ((fixed_signed) op1 >= -((fixed_signed) quarter)) &
+                  ((fixed_signed) op1 <    (fixed_signed) half);
+
+  fix_internal m =
+#if FIX_INTERN_FRAC_BITS >= FIX_POINT_BITS
+      op1 << (FIX_INTERN_FRAC_BITS - FIX_POINT_BITS);
+#else
+      SIGN_EX_SHIFT_RIGHT(op1, (FIX_POINT_BITS - FIX_INTERN_FRAC_BITS));
+#endif
+  m = MASK_UNLESS(small, m);
 
   uint8_t overflow = 0;
+  fixed r_small = FIX_INTERN_TO_FIXED(fix_ln_poly(m, &overflow));
 
-  // Check if we're going to overflow n
-  fixed ntmp = (((fixed) (log2)) - FIX_POINT_BITS);
-  fixed sign_mask = ~((((fixed) 1) << (64 - FIX_POINT_BITS - 1)) - 1);
-  overflow |= ((ntmp & sign_mask) != 0) & ((ntmp & sign_mask) != sign_mask);
+  /* Everywhere else, 1+x fits as long as we let it use the sign bit. */
+  uint64_t onepx = FIX_DATA_BITS(op1) + (((uint64_t) 1) << FIX_POINT_BITS);
+  onepx = MASK_UNLESS(!(small | isnan | isinfneg | isinfpos), onepx) |
+          MASK_UNLESS(  small | isnan | isinfneg | isinfpos,
+              ((uint64_t) 1) << FIX_POINT_BITS);
+  fixed r_large = fix_ln_kernel(onepx, &overflow);
 
-  fixed n = ntmp << FIX_POINT_BITS;
+  /* ln(1+x) can be too negative to fit in small builds. */
+  isinfneg |= (!(small | isnan | isinfpos)) &
+    (overflow | (FIX_IS_NEG(op1) & !FIX_IS_NEG(r_large)));
+
+  return FIX_IF_NAN(isnan) |
+    FIX_IF_INF_POS(isinfpos) |
+    FIX_IF_INF_NEG(isinfneg & !isnan) |
+    MASK_UNLESS(!(isnan | isinfpos | isinfneg),
+        MASK_UNLESS( small, FIX_DATA_BITS(r_small)) |
+        MASK_UNLESS(!small, FIX_DATA_BITS(r_large)));
+}
+
+void fix_log1p_array(fixed* result, const fixed* op1, size_t n) {
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_log1p(op1[i]);
+  }
+}
+
+
+/* Evaluates log2(1+m) for m in [-0.5, 0.5], without the constant term, like
+ * fix_ln_poly. */
+FIX_INLINE fix_internal fix_log2_poly(fix_internal m, uint8_t* overflow) {
+  uint8_t ovf = 0;
+  fix_internal tmp;
 
   // Use an order-25 polynomial to approximate log2(1+m) over -.5,5.
   // Accurate to about 2**-48.
@@ -365,67 +551,72 @@ fixed fix_log2(fixed op1) {
   // octave:89> log2(max(abs(polyval(p, x) - log2(1+x))))
   // ans = -48.2995602818589
 
-  // now, calculate log2(1+m):
-  fix_internal tmp;
+  tmp = FIX_MUL_INTERN(m,       FIX_LOG2_COEF_25, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_24, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_23, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_22, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_21, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_20, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_19, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_18, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_17, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_16, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_15, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_14, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_13, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_12, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_11, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_10, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_9, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_8, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_7, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_6, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_5, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_4, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_3, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_2, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_1, ovf);
+
+  *overflow |= ovf;
+  return tmp;
+}
 
-  tmp = FIX_MUL_INTERN(m,       FIX_LOG2_COEF_25, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_24, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_23, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_22, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_21, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_20, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_19, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_18, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_17, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_16, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_15, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_14, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_13, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_12, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_11, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_10, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_9, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_8, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_7, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_6, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_5, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_4, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_3, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_2, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG2_COEF_1, overflow);
-  tmp =                   tmp + FIX_LOG2_COEF_0;
+/* log2(op1) is (log2 - FIX_POINT_BITS) + log2(1+m), and poly is
+ * fix_log2_poly(m). */
+FIX_INLINE fixed fix_log2_finish(uint32_t log2, fix_internal poly, uint8_t* overflow) {
+  // Check if we're going to overflow n
+  fixed ntmp = (((fixed) (log2)) - FIX_POINT_BITS);
+  fixed sign_mask = ~((((fixed) 1) << (64 - FIX_POINT_BITS - 1)) - 1);
+  *overflow |= ((ntmp & sign_mask) != 0) & ((ntmp & sign_mask) != sign_mask);
+
+  fixed n = ntmp << FIX_POINT_BITS;
+
+  fix_internal tmp = poly + FIX_LOG2_COEF_0;
 
   fixed r = FIX_INTERN_TO_FIXED(tmp);
   r += n;
 
-  isinfneg |= (!isnan) & (!isinfpos) & overflow;
-
-  return FIX_IF_NAN(isnan) |
-    FIX_IF_INF_POS(isinfpos) |
-    FIX_IF_INF_NEG(isinfneg) |
-    FIX_DATA_BITS(r);
+  return r;
 }
 
-fixed fix_log10(fixed op1) {
+fixed fix_log2(fixed op1) {
   /* Approach taken from http://eesite.bitbucket.org/html/software/log_app/log_app.html */
 
-  uint8_t isinfpos = FIX_IS_INF_POS(op1);
-  uint8_t isinfneg = FIX_IS_INF_NEG(op1) | (op1 == 0);
-  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_NEG(op1);
-
   FIX_LOG_PROLOG(op1, log2, m);
 
-  // Python: "0x%016x"%((decimal.Decimal(2).ln() * 2**63)
-  //     .quantize(decimal.Decimal('1.'), rounding=decimal.ROUND_HALF_EVEN))
-  fixed log10_2 = 0x268826a13ef3fde6;
   uint8_t overflow = 0;
 
-  // this will go negative for numbers < 1.
-#if 63 - FIX_POINT_BITS != 0
-  fixed nlog10_2 = MUL_64_N(log10_2, ((int64_t) (log2)) - FIX_POINT_BITS, overflow, 63 - FIX_POINT_BITS);
-#else
-  fixed nlog10_2 = MUL_64_ALL(log10_2, ((int64_t) (log2)) - FIX_POINT_BITS, overflow);
-#endif
+  // now, calculate log2(1+m):
+  fixed r = fix_log2_finish(log2, fix_log2_poly(m, &overflow), &overflow);
+
+  return fix_log_special(op1, r, overflow);
+}
+
+/* Evaluates log10(1+m) for m in [-0.5, 0.5], without the constant term, like
+ * fix_ln_poly. */
+FIX_INLINE fix_internal fix_log10_poly(fix_internal m, uint8_t* overflow) {
+  uint8_t ovf = 0;
+  fix_internal tmp;
 
   // Use a 24-order polynomial to approximate log10 on -5,5. Accurate to about 2*-48.
   //
@@ -433,43 +624,161 @@ fixed fix_log10(fixed op1) {
   // octave:81> log2(max(abs(polyval(p, x) - log10(1+x))))
   // ans = -48.6780719051126
 
-  fix_internal tmp;
+  tmp = FIX_MUL_INTERN(m,       FIX_LOG10_COEF_24, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_23, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_22, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_21, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_20, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_19, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_18, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_17, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_16, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_15, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_14, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_13, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_12, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_11, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_10, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_9, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_8, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_7, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_6, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_5, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_4, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_3, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_2, ovf);
+  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_1, ovf);
+
+  *overflow |= ovf;
+  return tmp;
+}
+
+/* log10(op1) is (log2 - FIX_POINT_BITS) * log10(2) + log10(1+m), and poly is
+ * fix_log10_poly(m). */
+FIX_INLINE fixed fix_log10_finish(uint32_t log2, fix_internal poly, uint8_t* overflow) {
+  // Python: "0x%016x"%((decimal.Decimal(2).ln() * 2**63)
+  //     .quantize(decimal.Decimal('1.'), rounding=decimal.ROUND_HALF_EVEN))
+  fixed log10_2 = 0x268826a13ef3fde6;
+
+  // this will go negative for numbers < 1.
+#if 63 - FIX_POINT_BITS != 0
+  fixed nlog10_2 = MUL_64_N(log10_2, ((int64_t) (log2)) - FIX_POINT_BITS, *overflow, 63 - FIX_POINT_BITS);
+#else
+  fixed nlog10_2 = MUL_64_ALL(log10_2, ((int64_t) (log2)) - FIX_POINT_BITS, *overflow);
+#endif
 
-  tmp = FIX_MUL_INTERN(m,       FIX_LOG10_COEF_24, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_23, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_22, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_21, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_20, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_19, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_18, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_17, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_16, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_15, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_14, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_13, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_12, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_11, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_10, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_9, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_8, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_7, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_6, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_5, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_4, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_3, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_2, overflow);
-  tmp = FIX_MUL_INTERN(m, tmp + FIX_LOG10_COEF_1, overflow);
-  tmp =                   tmp + FIX_LOG10_COEF_0;
+  fix_internal tmp = poly + FIX_LOG10_COEF_0;
 
   fixed r = FIX_INTERN_TO_FIXED(tmp);
   r += nlog10_2;
 
-  isinfneg |= (!isnan) & (!isinfpos) & overflow;
+  return r;
+}
 
-  return FIX_IF_NAN(isnan) |
-    FIX_IF_INF_POS(isinfpos) |
-    FIX_IF_INF_NEG(isinfneg) |
-    FIX_DATA_BITS(r);
+fixed fix_log10(fixed op1) {
+  /* Approach taken from http://eesite.bitbucket.org/html/software/log_app/log_app.html */
+
+  FIX_LOG_PROLOG(op1, log2, m);
+
+  uint8_t overflow = 0;
+
+  fixed r = fix_log10_finish(log2, fix_log10_poly(m, &overflow), &overflow);
+
+  return fix_log_special(op1, r, overflow);
+}
+
+#if FIX_X86_SIMD
+// The polynomials again, as tables for fix_intern_poly_array_avx2.
+static const fix_internal fix_ln_coefs[] = {
+  FIX_LN_COEF_0, FIX_LN_COEF_1, FIX_LN_COEF_2, FIX_LN_COEF_3, FIX_LN_COEF_4,
+  FIX_LN_COEF_5, FIX_LN_COEF_6, FIX_LN_COEF_7, FIX_LN_COEF_8, FIX_LN_COEF_9,
+  FIX_LN_COEF_10, FIX_LN_COEF_11, FIX_LN_COEF_12, FIX_LN_COEF_13, FIX_LN_COEF_14,
+  FIX_LN_COEF_15, FIX_LN_COEF_16, FIX_LN_COEF_17, FIX_LN_COEF_18, FIX_LN_COEF_19,
+  FIX_LN_COEF_20, FIX_LN_COEF_21, FIX_LN_COEF_22, FIX_LN_COEF_23, FIX_LN_COEF_24
+};
+
+static const fix_internal fix_log2_coefs[] = {
+  FIX_LOG2_COEF_0, FIX_LOG2_COEF_1, FIX_LOG2_COEF_2, FIX_LOG2_COEF_3,
+  FIX_LOG2_COEF_4, FIX_LOG2_COEF_5, FIX_LOG2_COEF_6, FIX_LOG2_COEF_7,
+  FIX_LOG2_COEF_8, FIX_LOG2_COEF_9, FIX_LOG2_COEF_10, FIX_LOG2_COEF_11,
+  FIX_LOG2_COEF_12, FIX_LOG2_COEF_13, FIX_LOG2_COEF_14, FIX_LOG2_COEF_15,
+  FIX_LOG2_COEF_16, FIX_LOG2_COEF_17, FIX_LOG2_COEF_18, FIX_LOG2_COEF_19,
+  FIX_LOG2_COEF_20, FIX_LOG2_COEF_21, FIX_LOG2_COEF_22, FIX_LOG2_COEF_23,
+  FIX_LOG2_COEF_24, FIX_LOG2_COEF_25
+};
+
+static const fix_internal fix_log10_coefs[] = {
+  FIX_LOG10_COEF_0, FIX_LOG10_COEF_1, FIX_LOG10_COEF_2, FIX_LOG10_COEF_3,
+  FIX_LOG10_COEF_4, FIX_LOG10_COEF_5, FIX_LOG10_COEF_6, FIX_LOG10_COEF_7,
+  FIX_LOG10_COEF_8, FIX_LOG10_COEF_9, FIX_LOG10_COEF_10, FIX_LOG10_COEF_11,
+  FIX_LOG10_COEF_12, FIX_LOG10_COEF_13, FIX_LOG10_COEF_14, FIX_LOG10_COEF_15,
+  FIX_LOG10_COEF_16, FIX_LOG10_COEF_17, FIX_LOG10_COEF_18, FIX_LOG10_COEF_19,
+  FIX_LOG10_COEF_20, FIX_LOG10_COEF_21, FIX_LOG10_COEF_22, FIX_LOG10_COEF_23,
+  FIX_LOG10_COEF_24
+};
+
+#define FIX_LOG_E  0
+#define FIX_LOG_2  1
+#define FIX_LOG_10 2
+
+/* Like fix_exp_blocks. base is the same for the whole call, so branching on it
+ * doesn't depend on the data. */
+static void fix_log_blocks(fixed* result, const fixed* op1, size_t n, int base) {
+  const fix_internal* coefs =
+    base == FIX_LOG_E ? fix_ln_coefs : (base == FIX_LOG_2 ? fix_log2_coefs : fix_log10_coefs);
+  int degree = base == FIX_LOG_2 ? 25 : 24;
+
+  for(size_t i = 0; i < n; i += FIX_POWER_BLOCK) {
+    size_t b = n - i < FIX_POWER_BLOCK ? n - i : FIX_POWER_BLOCK;
+    uint32_t log2s[FIX_POWER_BLOCK];
+    fix_internal ms[FIX_POWER_BLOCK];
+    fix_internal poly[FIX_POWER_BLOCK];
+    uint64_t overflow[FIX_POWER_BLOCK];
+
+    for(size_t j = 0; j < b; j++) {
+      fixed x = op1[i + j];
+      FIX_LOG_PROLOG(x, log2, m);
+      log2s[j] = log2;
+      ms[j] = m;
+    }
+
+    fix_intern_poly_array_avx2(poly, overflow, ms, coefs, degree, b);
+
+    for(size_t j = 0; j < b; j++) {
+      uint8_t ovf = overflow[j];
+      fixed r;
+      if(base == FIX_LOG_E) {
+        r = fix_ln_finish(log2s[j], poly[j], &ovf);
+      } else if(base == FIX_LOG_2) {
+        r = fix_log2_finish(log2s[j], poly[j], &ovf);
+      } else {
+        r = fix_log10_finish(log2s[j], poly[j], &ovf);
+      }
+      result[i + j] = fix_log_special(op1[i + j], r, ovf);
+    }
+  }
+}
+#endif
+
+void fix_ln_array(fixed* result, const fixed* op1, size_t n) {
+  FIX_USE_AVX2(fix_log_blocks(result, op1, n, FIX_LOG_E));
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_ln(op1[i]);
+  }
+}
+
+void fix_log2_array(fixed* result, const fixed* op1, size_t n) {
+  FIX_USE_AVX2(fix_log_blocks(result, op1, n, FIX_LOG_2));
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_log2(op1[i]);
+  }
+}
+
+void fix_log10_array(fixed* result, const fixed* op1, size_t n) {
+  FIX_USE_AVX2(fix_log_blocks(result, op1, n, FIX_LOG_10));
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_log10(op1[i]);
+  }
 }
 
 fixed fix_sqrt(fixed op1) {
@@ -554,6 +863,137 @@ fixed fix_sqrt(fixed op1) {
     FIX_DATA_BITS(x);
 }
 
+fixed fix_cbrt(fixed op1) {
+  // Write |op1| = m * 2^(3k + t), with m in [1, 2) and t in {0, 1, 2}. Then
+  //
+  //   cbrt(op1) = cbrt(m) * cbrt(2^t) * 2^k
+  //
+  // We find y = m^(-1/3) with Newton's Method on f(y) = y^-3 - m, which only
+  // needs multiplies:
+  //
+  //   y' = y + y * (1 - m y^3) / 3
+  //
+  // and then cbrt(m) = m * y^2.
+
+  uint8_t isinfpos = FIX_IS_INF_POS(op1);
+  uint8_t isinfneg = FIX_IS_INF_NEG(op1);
+  uint8_t isnan = FIX_IS_NAN(op1);
+  uint8_t isneg = FIX_IS_NEG(op1);
+  uint8_t iszero = FIX_DATA_BITS(op1) == 0;
+
+  // FIX_MIN is fine here: we treat its magnitude as unsigned.
+  fixed data = FIX_DATA_BITS(op1);
+  uint64_t absx = FIX_ABS_64(data);
+
+  int32_t log2 = uint64_log2(absx);
+  int32_t e = log2 - FIX_POINT_BITS;
+
+  // k = floor(e / 3). e is in [-FIX_FRAC_BITS, FIX_INT_BITS), so offset it to be
+  // positive and divide by multiplying with 2^16 / 3.
+  int32_t k = ((((uint32_t) (e + 63)) * 0x5556) >> 16) - 21;
+  int32_t t = e - 3*k;
+
+  // m in [1, 2) as a fix_internal.
+  fix_internal m =
+    MASK_UNLESS(log2 <= FIX_INTERN_FRAC_BITS, absx << ((FIX_INTERN_FRAC_BITS - log2) & 63)) |
+    MASK_UNLESS(log2 >  FIX_INTERN_FRAC_BITS, absx >> ((log2 - FIX_INTERN_FRAC_BITS) & 63));
+
+  uint8_t overflow = 0;
+
+  // Python: "0x%016x"%(mpmath.nint(mpmath.mpf('1.19') * 2**60)) and 0.2032.
+  // This linear guess is within 1.4% of m^(-1/3) over [1, 2), so four
+  // iterations are enough for the 60 bits of a fix_internal.
+  fix_internal guess_a = 0x130a3d70a3d70a3d;
+  fix_internal guess_b = 0x03404ea4a8c154ca;
+  fix_internal third   = 0x0555555555555555;
+  fix_internal one     = ((fix_internal) 1) << FIX_INTERN_FRAC_BITS;
+
+  fix_internal y = guess_a - FIX_MUL_INTERN(guess_b, m, overflow);
+
+  for(int i = 0; i < 4; i++) {
+    fix_internal y2 = FIX_MUL_INTERN(y, y, overflow);
+    fix_internal my3 = FIX_MUL_INTERN(m, FIX_MUL_INTERN(y2, y, overflow), overflow);
+    fix_internal d = FIX_MUL_INTERN(one - my3, third, overflow);
+    y = y + FIX_MUL_INTERN(y, d, overflow);
+  }
+
+  fix_internal r = FIX_MUL_INTERN(m, FIX_MUL_INTERN(y, y, overflow), overflow);
+
+  // Python: "0x%016x"%(mpmath.nint(mpmath.cbrt(2) * 2**60)), and cbrt(4).
+  fix_internal cbrt_2t =
+    MASK_UNLESS(t == 0, one) |
+    MASK_UNLESS(t == 1, 0x1428a2f98d728ae2) |
+    MASK_UNLESS(t == 2, 0x1965fea53d6e3c83);
+  r = FIX_MUL_INTERN(r, cbrt_2t, overflow);
+
+  // r is in [1, 2), and the result is r * 2^k. Shift it into a fixed; depending
+  // on k, this is a right shift (with rounding) or a left shift by at most one.
+  int32_t shift = FIX_INTERN_FRAC_BITS - FIX_FRAC_BITS - k;
+  int32_t rshift = MASK_UNLESS(shift >= 2, shift) | MASK_UNLESS(shift < 2, 2);
+  int32_t lshift = MASK_UNLESS(shift <= 0, -shift);
+  uint64_t mag = FIX_ALL_BIT_MASK & (
+      MASK_UNLESS(shift >= 2, ROUND_TO_EVEN(r, rshift)) |
+      MASK_UNLESS(shift == 1, ROUND_TO_EVEN_ONE_BIT(r)) |
+      MASK_UNLESS(shift <= 0, r << lshift));
+  mag = mag << FIX_FLAG_BITS;
+
+#if FIX_INT_BITS == 1
+  // With one int bit, cbrt of something just under one can round up to one,
+  // which we can't represent. Return FIX_MAX instead.
+  mag = MASK_UNLESS(( isneg) | (mag != FIX_MIN), mag) |
+        MASK_UNLESS((!isneg) & (mag == FIX_MIN), FIX_MAX);
+#endif
+
+  fixed result = MASK_UNLESS(!isneg, mag) |
+                 MASK_UNLESS( isneg, (~mag) + 1);
+
+  return FIX_IF_NAN(isnan) |
+    FIX_IF_INF_POS(isinfpos & (!isnan)) |
+    FIX_IF_INF_NEG(isinfneg & (!isnan)) |
+    MASK_UNLESS(!iszero, FIX_DATA_BITS(result));
+}
+
+fixed fix_hypot(fixed x, fixed y) {
+  // Rather than squaring in fixed (which overflows as soon as x^2 does), work
+  // on the magnitudes as integers in units of FIX_EPSILON. Those are at most
+  // 2^61, so x^2 + y^2 fits comfortably in 128 bits. The integer square root of
+  // that is the exact answer; scale the sum by 4 first so that we get one more
+  // bit of the root to round with.
+  //
+  // The root can't be exactly halfway between two fixeds, so rounding is just
+  // "add one and shift".
+
+  uint8_t isnan = FIX_IS_NAN(x) | FIX_IS_NAN(y);
+  uint8_t isinfpos =
+    FIX_IS_INF_POS(x) | FIX_IS_INF_NEG(x) |
+    FIX_IS_INF_POS(y) | FIX_IS_INF_NEG(y);
+
+  fixed datax = FIX_DATA_BITS(x);
+  fixed datay = FIX_DATA_BITS(y);
+  uint64_t absx = FIX_ABS_64(datax) >> FIX_FLAG_BITS;
+  uint64_t absy = FIX_ABS_64(datay) >> FIX_FLAG_BITS;
+
+  uint64_t x2low, x2high, y2low, y2high;
+  UNSAFE_UNSIGNED_MUL_64_64_128(absx, absx, x2low, x2high);
+  UNSAFE_UNSIGNED_MUL_64_64_128(absy, absy, y2low, y2high);
+
+  uint64_t sumlow = x2low + y2low;
+  uint64_t sumhigh = x2high + y2high + (sumlow < x2low);
+
+  sumhigh = (sumhigh << 2) | (sumlow >> 62);
+  sumlow = sumlow << 2;
+
+  uint64_t root = uint128_sqrt(sumhigh, sumlow);
+  uint64_t result = (root + 1) >> 1;
+
+  // Anything at or past 2^61 epsilons doesn't fit in a positive fixed.
+  isinfpos |= (result >> (FIX_BITS - FIX_FLAG_BITS - 1)) != 0;
+
+  return FIX_IF_NAN(isnan) |
+    FIX_IF_INF_POS(isinfpos & (!isnan)) |
+    MASK_UNLESS(!isinfpos, FIX_DATA_BITS(result << FIX_FLAG_BITS));
+}
+
 /* fix_pow: Computes x^y.
  *
  *  Uses the exponential method:
@@ -0,0 +1,504 @@
+#include "ftfp.h"
+#include "internal.h"
+#include "lut.h"
+
+// Contains the error function, the normal distribution and log-gamma for libftfp.
+
+/* Computes erfc(z) for a fix_internal z in [0, 8). There's one polynomial per
+ * unit interval, in t = z - (i + 0.5). Every interval's coefficients are read,
+ * and only the ones for z's interval are kept, so the memory access pattern
+ * doesn't depend on z. There's no polynomial for [7, 8); erfc is below 2^-70
+ * there, so we return 0. */
+FIX_INLINE fix_internal fix_erfc_poly(fix_internal z) {
+  static const ERFC_COEF_LUT;
+
+  uint64_t interval = z >> FIX_INTERN_FRAC_BITS;
+  fix_internal t = z - (interval << FIX_INTERN_FRAC_BITS) -
+    (((fix_internal) 1) << (FIX_INTERN_FRAC_BITS - 1));
+
+  fix_internal coef[ERFC_DEGREE + 1];
+  for(int j = 0; j <= ERFC_DEGREE; j++) {
+    coef[j] = 0;
+  }
+  for(int i = 0; i < ERFC_INTERVALS; i++) {
+    for(int j = 0; j <= ERFC_DEGREE; j++) {
+      coef[j] |= MASK_UNLESS(interval == i, erfc_coef_lut[i * (ERFC_DEGREE + 1) + j]);
+    }
+  }
+
+  // The coefficients are highest degree first.
+  uint8_t overflow = 0;
+  fix_internal result = coef[0];
+  for(int j = 1; j <= ERFC_DEGREE; j++) {
+    result = FIX_MUL_INTERN(result, t, overflow) + coef[j];
+  }
+
+  return result;
+}
+
+/* Computes erfc(|op1|), or erfc(|op1| / sqrt(2)) if scaled is set, and sets
+ * *neg if op1 is negative. Infinities count as very large numbers. */
+FIX_INLINE fix_internal fix_erfc_abs(fixed op1, uint8_t scaled, uint8_t* neg) {
+  uint8_t isinf = FIX_IS_INF_POS(op1) | FIX_IS_INF_NEG(op1);
+  *neg = FIX_IS_NEG(op1) | FIX_IS_INF_NEG(op1);
+
+  // FIX_MIN's magnitude doesn't fit in a fixed, but it does fit in a uint64_t.
+  uint64_t a = FIX_ABS_64(FIX_DATA_BITS(op1));
+  uint64_t whole = a >> FIX_POINT_BITS;
+
+  fix_internal z =
+#if FIX_INTERN_FRAC_BITS >= FIX_POINT_BITS
+      a << (FIX_INTERN_FRAC_BITS - FIX_POINT_BITS);
+#else
+      a >> (FIX_POINT_BITS - FIX_INTERN_FRAC_BITS);
+#endif
+
+  /* |op1| / sqrt(2) has FIX_POINT_BITS + 64 fractional bits as a 128-bit
+   * product. That's always more than a fix_internal has. */
+  uint64_t inv_sqrt2 = 0xb504f333f9de6484; // "%x"%(mpmath.nint(2**64 / mpmath.sqrt(2)))
+#if FIX_POINT_BITS >= FIX_INTERN_FRAC_BITS
+  fix_internal z_scaled = MUL_64_TOP(a, inv_sqrt2) >> (FIX_POINT_BITS - FIX_INTERN_FRAC_BITS);
+#else
+  uint64_t hi;
+  uint64_t lo;
+  UNSAFE_UNSIGNED_MUL_64_64_128(a, inv_sqrt2, lo, hi);
+  fix_internal z_scaled = (hi << (FIX_INTERN_FRAC_BITS - FIX_POINT_BITS)) |
+                          (lo >> (FIX_POINT_BITS + 64 - FIX_INTERN_FRAC_BITS));
+#endif
+
+  /* Past 7 (or 7 * sqrt(2)), erfc is 0 to within our precision. Catching that
+   * here also keeps z inside a fix_internal. */
+  uint8_t big = isinf | MASK_UNLESS( scaled, whole >= 10) |
+                        MASK_UNLESS(!scaled, whole >=  7);
+
+  z = MASK_UNLESS( scaled, z_scaled) |
+      MASK_UNLESS(!scaled, z);
+  z = MASK_UNLESS(!big, z);
+
+  return MASK_UNLESS(!big, fix_erfc_poly(z));
+}
+
+/* Converts a result in [-2, 2] to a fixed. Small builds can't hold the top of
+ * that range, so saturate instead of wrapping around. */
+FIX_INLINE fixed fix_stats_to_fixed(fix_internal x) {
+#if FIX_INT_BITS <= 2
+  uint8_t big = (fixed_signed) x >=
+    (fixed_signed) (((fix_internal) 1) << (FIX_INTERN_FRAC_BITS + FIX_INT_BITS - 1));
+  return MASK_UNLESS(big, FIX_MAX) | MASK_UNLESS(!big, FIX_INTERN_TO_FIXED(x));
+#else
+  return FIX_INTERN_TO_FIXED(x);
+#endif
+}
+
+fixed fix_erf(fixed op1) {
+  uint8_t isnan = FIX_IS_NAN(op1);
+
+  uint8_t neg;
+  fix_internal e = fix_erfc_abs(op1, 0, &neg);
+
+  // erf(x) = 1 - erfc(x), and erf is odd.
+  fix_internal one = ((fix_internal) 1) << FIX_INTERN_FRAC_BITS;
+  fix_internal result = MASK_UNLESS( neg, e - one) |
+                        MASK_UNLESS(!neg, one - e);
+
+  return FIX_IF_NAN(isnan) | MASK_UNLESS(!isnan, fix_stats_to_fixed(result));
+}
+
+fixed fix_erfc(fixed op1) {
+  uint8_t isnan = FIX_IS_NAN(op1);
+
+  uint8_t neg;
+  fix_internal e = fix_erfc_abs(op1, 0, &neg);
+
+  // erfc(-x) = 2 - erfc(x)
+  fix_internal two = ((fix_internal) 2) << FIX_INTERN_FRAC_BITS;
+  fix_internal result = MASK_UNLESS( neg, two - e) |
+                        MASK_UNLESS(!neg, e);
+
+  return FIX_IF_NAN(isnan) | MASK_UNLESS(!isnan, fix_stats_to_fixed(result));
+}
+
+fixed fix_norm_cdf(fixed op1) {
+  uint8_t isnan = FIX_IS_NAN(op1);
+
+  uint8_t neg;
+  fix_internal e = fix_erfc_abs(op1, 1, &neg);
+
+  // Phi(x) = erfc(-x / sqrt(2)) / 2
+  fix_internal one = ((fix_internal) 1) << FIX_INTERN_FRAC_BITS;
+  fix_internal result = MASK_UNLESS( neg, e >> 1) |
+                        MASK_UNLESS(!neg, one - (e >> 1));
+
+  return FIX_IF_NAN(isnan) | MASK_UNLESS(!isnan, fix_stats_to_fixed(result));
+}
+
+/* Computes ln(m * 2^e), for m > 0, as a signed Q8.56. The logs the quantile
+ * and lgamma need go well past 8, so they don't fit in a fix_internal. */
+FIX_INLINE uint64_t fix_ln_wide(uint64_t m, int32_t e) {
+  fix_internal rest;
+  int32_t n = fix_ln_split(m, &rest) + FIX_POINT_BITS + e;
+
+  // ln(m * 2^e) = n * ln(2) + rest
+  uint64_t ln2 = 0xb17217f7d1cf79ac; // "%x"%(mpmath.nint(mpmath.ln(2) * 2**64))
+  uint8_t neg = n < 0;
+  uint64_t absn = MASK_UNLESS( neg, (uint64_t) (-((int64_t) n))) |
+                  MASK_UNLESS(!neg, (uint64_t) n);
+  uint64_t hi;
+  uint64_t lo;
+  UNSAFE_UNSIGNED_MUL_64_64_128(absn, ln2, lo, hi);
+
+  uint64_t nln2 = (hi << 56) | (lo >> 8);
+  nln2 = MASK_UNLESS( neg, (~nln2) + 1) |
+         MASK_UNLESS(!neg, nln2);
+
+  return nln2 + SIGN_EX_SHIFT_RIGHT(rest, 4);
+}
+
+/* Computes sqrt(-ln(p)) as a fix_internal, for an unsigned p with
+ * FIX_POINT_BITS of fraction in (0, 1). */
+FIX_INLINE fix_internal fix_sqrt_neg_ln(uint64_t p) {
+  uint64_t l = -fix_ln_wide(p, -FIX_POINT_BITS);
+
+  // sqrt(l * 2^64) has 28 + 32 = 60 fractional bits.
+  return uint128_sqrt(l, 0);
+}
+
+/* Divides two positive fix_internals, returning half of the quotient (i.e. a
+ * Q5.59). The normal quantile reaches 8.8, which doesn't fit in a Q4.60. */
+FIX_INLINE uint64_t fix_div_intern_half(fix_internal num, fix_internal den) {
+  uint8_t logd = uint64_log2(den);
+  uint64_t r = uint64_recip(den << (63 - logd));
+
+  /* den is 2^(logd - 59) * (den << (63 - logd)) / 2^64, so num / den in Q5.59
+   * is num * r / 2^(4 + logd). */
+  uint64_t hi;
+  uint64_t lo;
+  UNSAFE_UNSIGNED_MUL_64_64_128(num, r, lo, hi);
+
+  uint8_t shift = 4 + logd;
+  return MASK_UNLESS(shift <  64, (hi << ((64 - shift) & 63)) | (lo >> (shift & 63))) |
+         MASK_UNLESS(shift >= 64, hi >> ((shift - 64) & 63));
+}
+
+fixed fix_norm_ppf(fixed op1) {
+  static const NORM_PPF_COEF_LUT;
+
+  uint64_t p = FIX_DATA_BITS(op1);
+  uint64_t one = ((uint64_t) 1) << FIX_POINT_BITS;
+
+  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_INF_POS(op1) | FIX_IS_INF_NEG(op1) |
+                  FIX_IS_NEG(op1) | (p > one);
+  uint8_t isinfneg = (!isnan) & (p == 0);
+  uint8_t isinfpos = (!isnan) & (p == one);
+
+  fix_internal q =
+#if FIX_INTERN_FRAC_BITS >= FIX_POINT_BITS
+      (p << (FIX_INTERN_FRAC_BITS - FIX_POINT_BITS))
+#else
+      (p >> (FIX_POINT_BITS - FIX_INTERN_FRAC_BITS))
+#endif
+      - (((fix_internal) 1) << (FIX_INTERN_FRAC_BITS - 1));
+  uint8_t neg = FIX_TOP_BIT(q) != 0;
+
+  /* Wichura's AS241 splits [0, 1] into three regions, and each gets its own
+   * rational function. We work out every region's variable, then pick one
+   * along with its coefficients. */
+  uint8_t central = FIX_ABS_64(q) <= NORM_PPF_CONST_0;
+
+  // The tails use r = sqrt(-ln(min(p, 1-p))). Keep the log's input nonzero.
+  uint64_t tail = MASK_UNLESS( neg, p) |
+                  MASK_UNLESS(!neg, one - p);
+  tail |= MASK_UNLESS(tail == 0, 1 << FIX_FLAG_BITS);
+  fix_internal r = fix_sqrt_neg_ln(tail);
+  uint8_t near = r <= NORM_PPF_CONST_3;
+
+  uint8_t ovf = 0;
+  uint8_t region0 = central;
+  uint8_t region1 = (!central) & near;
+  uint8_t region2 = (!central) & (!near);
+
+  // These shifts match the ones generate_base.py scaled the coefficients by.
+  fix_internal u =
+    MASK_UNLESS(region0, (NORM_PPF_CONST_1 - FIX_MUL_INTERN(q, q, ovf)) << 3) |
+    MASK_UNLESS(region1, SIGN_EX_SHIFT_RIGHT(r - NORM_PPF_CONST_2, 2)) |
+    MASK_UNLESS(region2, r - NORM_PPF_CONST_3);
+
+  fix_internal coef[2 * (NORM_PPF_DEGREE + 1)];
+  for(int j = 0; j < 2 * (NORM_PPF_DEGREE + 1); j++) {
+    coef[j] = 0;
+  }
+  for(int i = 0; i < NORM_PPF_REGIONS; i++) {
+    uint8_t in = MASK_UNLESS(i == 0, region0) |
+                 MASK_UNLESS(i == 1, region1) |
+                 MASK_UNLESS(i == 2, region2);
+    for(int j = 0; j < 2 * (NORM_PPF_DEGREE + 1); j++) {
+      coef[j] |= MASK_UNLESS(in, norm_ppf_coef_lut[i * 2 * (NORM_PPF_DEGREE + 1) + j]);
+    }
+  }
+
+  // Numerator, then denominator, each highest degree first.
+  fix_internal num = coef[0];
+  fix_internal den = coef[NORM_PPF_DEGREE + 1];
+  for(int j = 1; j <= NORM_PPF_DEGREE; j++) {
+    num = FIX_MUL_INTERN(num, u, ovf) + coef[j];
+    den = FIX_MUL_INTERN(den, u, ovf) + coef[NORM_PPF_DEGREE + 1 + j];
+  }
+
+  // The selected region's numerator and denominator are positive.
+  uint64_t ratio = fix_div_intern_half(num, den | (den == 0));
+
+  // In the central region x = q * ratio; in the tails x = -+ratio.
+  uint64_t x = MASK_UNLESS( central, FIX_MUL_INTERN(q, ratio, ovf)) |
+               MASK_UNLESS((!central) & neg, (~ratio) + 1) |
+               MASK_UNLESS((!central) & (!neg), ratio);
+
+  // x is a Q5.59, so this is FIX_INTERN_TO_FIXED with one less fractional bit.
+#if FIX_FRAC_BITS >= FIX_INTERN_FRAC_BITS - 1
+  fixed result = FIX_DATA_BITS(x << (FIX_POINT_BITS - (FIX_INTERN_FRAC_BITS - 1)));
+#elif FIX_FRAC_BITS == FIX_INTERN_FRAC_BITS - 2
+  fixed result = FIX_DATA_BITS(ROUND_TO_EVEN_ONE_BIT_SIGNED(x) << FIX_FLAG_BITS);
+#else
+  fixed result = FIX_DATA_BITS(
+      ROUND_TO_EVEN_SIGNED(x, FIX_INTERN_FRAC_BITS - 1 - FIX_FRAC_BITS) << FIX_FLAG_BITS);
+#endif
+
+  // |x| stays below 8.8, so only small builds can overflow.
+#if FIX_INT_BITS <= 4
+  fixed_signed limit = ((fixed_signed) 1) << (FIX_INTERN_FRAC_BITS - 1 + FIX_INT_BITS - 1);
+  isinfpos |= (!isnan) & ((fixed_signed) x >= limit);
+  isinfneg |= (!isnan) & ((fixed_signed) x < -limit);
+#endif
+
+  return FIX_IF_NAN(isnan) |
+    FIX_IF_INF_POS(isinfpos & !isnan) |
+    FIX_IF_INF_NEG(isinfneg & !isnan) |
+    MASK_UNLESS(!(isnan | isinfpos | isinfneg), result);
+}
+
+/* Computes 1/y as a fix_internal, for y = raw / 2^frac of at least 16. */
+FIX_INLINE fix_internal fix_recip_intern(uint64_t raw, int32_t frac) {
+  uint8_t l = uint64_log2(raw);
+  uint64_t r = uint64_recip(raw << (63 - l));
+
+  // y = (raw << (63 - l)) / 2^64 * 2^(l + 1 - frac), and r is a Q2.62.
+  return r >> (l + 3 - frac);
+}
+
+/* Evaluates the tail of Stirling's series, ln(2 pi) / 2 + sum_k B_2k / (2k
+ * (2k - 1) y^(2k - 1)), given w = 1/y. */
+FIX_INLINE fix_internal fix_lgamma_series(fix_internal w) {
+  uint8_t ovf = 0;
+  fix_internal w2 = FIX_MUL_INTERN(w, w, ovf);
+  fix_internal tmp;
+
+  tmp = FIX_MUL_INTERN(w2,       LGAMMA_COEF_8, ovf);
+  tmp = FIX_MUL_INTERN(w2, tmp + LGAMMA_COEF_7, ovf);
+  tmp = FIX_MUL_INTERN(w2, tmp + LGAMMA_COEF_6, ovf);
+  tmp = FIX_MUL_INTERN(w2, tmp + LGAMMA_COEF_5, ovf);
+  tmp = FIX_MUL_INTERN(w2, tmp + LGAMMA_COEF_4, ovf);
+  tmp = FIX_MUL_INTERN(w2, tmp + LGAMMA_COEF_3, ovf);
+  tmp = FIX_MUL_INTERN(w2, tmp + LGAMMA_COEF_2, ovf);
+  tmp = FIX_MUL_INTERN(w,  tmp + LGAMMA_COEF_1, ovf);
+
+  return tmp + LGAMMA_COEF_0;
+}
+
+/* Widens a signed Q8.56 to a signed 128-bit hi:lo with FIX_POINT_BITS of
+ * fraction. Going down to fewer bits truncates; the flag bits are still
+ * there as guard bits, and get rounded off at the end. */
+FIX_INLINE void fix_wide_to_128(uint64_t w, uint64_t* hi, uint64_t* lo) {
+#if FIX_POINT_BITS > 56
+  *lo = w << (FIX_POINT_BITS - 56);
+  *hi = SIGN_EX_SHIFT_RIGHT(w, 64 - (FIX_POINT_BITS - 56));
+#else
+  *lo = SIGN_EX_SHIFT_RIGHT(w, 56 - FIX_POINT_BITS);
+  *hi = SIGN_EX_SHIFT_RIGHT(w, 63);
+#endif
+}
+
+/* Computes lgamma(y) for y = raw / 2^FIX_POINT_BITS > 0. raw may use all 64
+ * bits. The result is a signed 128-bit hi:lo with FIX_POINT_BITS of fraction,
+ * which can be far bigger than a fixed; fix_lbeta needs to combine three of
+ * them before it knows whether the answer fits.
+ *
+ * Stirling's series is only good for large arguments, so below 16 we use
+ * lgamma(y) = lgamma(y + 16) - ln(y (y+1) ... (y+15)). Both ways are always
+ * computed. */
+FIX_INLINE void fix_lgamma_kernel(uint64_t raw, uint64_t* hi, uint64_t* lo) {
+  uint64_t one = ((uint64_t) 1) << FIX_POINT_BITS;
+  uint64_t half56 = ((uint64_t) 1) << 55;
+  uint8_t small = (raw >> FIX_POINT_BITS) < 16;
+  uint64_t mhi;
+  uint64_t mlo;
+
+  // Small arguments, in a Q8.56. Big ones are swapped for 1 here.
+  uint64_t ya = MASK_UNLESS( small, raw) |
+                MASK_UNLESS(!small, one);
+#if FIX_POINT_BITS >= 56
+  uint64_t yw = ya >> (FIX_POINT_BITS - 56);
+#else
+  uint64_t yw = ya << (56 - FIX_POINT_BITS);
+#endif
+  uint64_t z = yw + (((uint64_t) 16) << 56);
+
+  /* The product keeps a 64-bit mantissa m with the top bit set, and a binary
+   * exponent e, so that it's m * 2^e. The first factor is y itself, at full
+   * precision, since y may be tiny. */
+  uint8_t l = uint64_log2(ya);
+  uint64_t m = ya << (63 - l);
+  int32_t e = ((int32_t) l) - 63 - FIX_POINT_BITS;
+  for(int i = 1; i < 16; i++) {
+    uint64_t f = yw + (((uint64_t) i) << 56);
+    uint8_t lf = uint64_log2(f);
+    e += ((int32_t) lf) - 63 - 56;
+
+    UNSAFE_UNSIGNED_MUL_64_64_128(m, f << (63 - lf), mlo, mhi);
+    uint8_t top = mhi >> 63;
+    m = MASK_UNLESS( top, mhi) |
+        MASK_UNLESS(!top, (mhi << 1) | (mlo >> 63));
+    e += 63 + top;
+  }
+  uint64_t lnp = fix_ln_wide(m, e);
+
+  // (z - 1/2) ln(z) - z is below 110, so it fits.
+  uint64_t lnz = fix_ln_wide(z, -56);
+  uint64_t zm = z - half56;
+  UNSAFE_UNSIGNED_MUL_64_64_128(zm, lnz, mlo, mhi);
+  uint64_t a = ((mhi << 8) | (mlo >> 56)) - z - lnp +
+    SIGN_EX_SHIFT_RIGHT(fix_lgamma_series(fix_recip_intern(z, 56)), 4);
+
+  fix_wide_to_128(a, hi, lo);
+
+#if FIX_INT_BITS > 4
+  /* Big arguments, straight from Stirling's series. ln(y) is positive, and
+   * (y - 1/2) ln(y) needs up to 70 integer bits. Small ones are swapped for
+   * 16 here. */
+  uint64_t yb = MASK_UNLESS(!small, raw) |
+                MASK_UNLESS( small, ((uint64_t) 16) << FIX_POINT_BITS);
+  uint64_t lny = fix_ln_wide(yb, -FIX_POINT_BITS);
+  uint64_t ym = yb - (one >> 1);
+  UNSAFE_UNSIGNED_MUL_64_64_128(ym, lny, mlo, mhi);
+  uint64_t bhi = mhi >> 56;
+  uint64_t blo = (mhi << 8) | (mlo >> 56);
+
+  bhi -= blo < yb;
+  blo -= yb;
+
+  uint64_t shi;
+  uint64_t slo;
+  fix_wide_to_128(SIGN_EX_SHIFT_RIGHT(fix_lgamma_series(fix_recip_intern(yb, FIX_POINT_BITS)), 4),
+                  &shi, &slo);
+  blo += slo;
+  bhi += shi + (blo < slo);
+
+  *hi = MASK_UNLESS( small, *hi) |
+        MASK_UNLESS(!small, bhi);
+  *lo = MASK_UNLESS( small, *lo) |
+        MASK_UNLESS(!small, blo);
+#endif
+}
+
+/* Rounds a signed 128-bit hi:lo with FIX_POINT_BITS of fraction to a fixed,
+ * or to an infinity of the right sign if it's out of range. */
+FIX_INLINE fixed fix_128_to_fixed(uint64_t hi, uint64_t lo) {
+  uint64_t half = ((uint64_t) 1) << (FIX_FLAG_BITS - 1);
+  lo += half;
+  hi += lo < half;
+
+  uint8_t neg = hi >> 63;
+  uint8_t fits = hi == MASK_UNLESS(lo >> 63, ~((uint64_t) 0));
+
+  return MASK_UNLESS( fits, FIX_DATA_BITS(lo)) |
+         MASK_UNLESS(!fits, FIX_IF_INF_POS(!neg) | FIX_IF_INF_NEG(neg));
+}
+
+fixed fix_lgamma(fixed op1) {
+  uint64_t one = ((uint64_t) 1) << FIX_POINT_BITS;
+  uint64_t y = FIX_DATA_BITS(op1);
+  uint8_t iszero = y == 0;
+
+  // We only handle positive arguments. lgamma has a pole at 0.
+  uint8_t isinfpos = FIX_IS_INF_POS(op1) | (iszero & !FIX_IS_NAN(op1) & !FIX_IS_INF_NEG(op1));
+  uint8_t isnan = FIX_IS_NAN(op1) | FIX_IS_INF_NEG(op1) | FIX_IS_NEG(op1);
+
+  uint64_t hi;
+  uint64_t lo;
+  fix_lgamma_kernel(MASK_UNLESS(!iszero, y) | MASK_UNLESS(iszero, one), &hi, &lo);
+
+  return FIX_IF_NAN(isnan) |
+    FIX_IF_INF_POS(isinfpos & !isnan) |
+    MASK_UNLESS(!(isnan | isinfpos), fix_128_to_fixed(hi, lo));
+}
+
+fixed fix_lbeta(fixed a, fixed b) {
+  uint64_t one = ((uint64_t) 1) << FIX_POINT_BITS;
+  uint64_t x = FIX_DATA_BITS(a);
+  uint64_t y = FIX_DATA_BITS(b);
+
+  uint8_t ainf = FIX_IS_INF_POS(a);
+  uint8_t binf = FIX_IS_INF_POS(b);
+  uint8_t azero = (x == 0) & !FIX_IS_NAN(a) & !ainf & !FIX_IS_INF_NEG(a);
+  uint8_t bzero = (y == 0) & !FIX_IS_NAN(b) & !binf & !FIX_IS_INF_NEG(b);
+
+  /* B(0, b) is infinite and B(Inf, b) is 0, so their logs are +Inf and -Inf.
+   * B(0, Inf) could be anything. */
+  uint8_t isnan = FIX_IS_NAN(a) | FIX_IS_INF_NEG(a) | FIX_IS_NEG(a) |
+                  FIX_IS_NAN(b) | FIX_IS_INF_NEG(b) | FIX_IS_NEG(b) |
+                  ((azero | bzero) & (ainf | binf));
+  uint8_t isinfpos = (!isnan) & (azero | bzero);
+  uint8_t isinfneg = (!isnan) & (ainf | binf);
+
+  x = MASK_UNLESS(x != 0, x) | MASK_UNLESS(x == 0, one);
+  y = MASK_UNLESS(y != 0, y) | MASK_UNLESS(y == 0, one);
+
+  // lbeta(a, b) = lgamma(a) + lgamma(b) - lgamma(a + b)
+  uint64_t ahi;
+  uint64_t alo;
+  uint64_t bhi;
+  uint64_t blo;
+  uint64_t shi;
+  uint64_t slo;
+  fix_lgamma_kernel(x, &ahi, &alo);
+  fix_lgamma_kernel(y, &bhi, &blo);
+  fix_lgamma_kernel(x + y, &shi, &slo);
+
+  uint64_t lo = alo + blo;
+  uint64_t hi = ahi + bhi + (lo < alo);
+  hi -= (shi + (lo < slo));
+  lo -= slo;
+
+  return FIX_IF_NAN(isnan) |
+    FIX_IF_INF_POS(isinfpos & !isnan) |
+    FIX_IF_INF_NEG(isinfneg & !isnan) |
+    MASK_UNLESS(!(isnan | isinfpos | isinfneg), fix_128_to_fixed(hi, lo));
+}
+
+void fix_erf_array(fixed* result, const fixed* op1, size_t n) {
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_erf(op1[i]);
+  }
+}
+
+void fix_erfc_array(fixed* result, const fixed* op1, size_t n) {
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_erfc(op1[i]);
+  }
+}
+
+void fix_norm_cdf_array(fixed* result, const fixed* op1, size_t n) {
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_norm_cdf(op1[i]);
+  }
+}
+
+void fix_norm_ppf_array(fixed* result, const fixed* op1, size_t n) {
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_norm_ppf(op1[i]);
+  }
+}
+
+void fix_lgamma_array(fixed* result, const fixed* op1, size_t n) {
+  for(size_t i = 0; i < n; i++) {
+    result[i] = fix_lgamma(op1[i]);
+  }
+}
@@ -87,9 +87,173 @@ void bounds(fixed f) {
   printf("%s (0x"FIX_PRINTF_HEX") | %s (0x"FIX_PRINTF_HEX") | %s (0x"FIX_PRINTF_HEX")\n", buf_less, less, buf, f, buf_more, more);
 }
 
+/* Steps a xorshift generator, for the tests that want arbitrary bit patterns,
+ * and returns the new state. */
+static uint64_t test_next_rand(uint64_t* state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+  return *state;
+}
+
 // Helper macro. Define it to be this for now, for code generation
 #define TEST_HELPER(name, code) static void name(void **state) code
 
+/* Checks that function##_array matches function element by element. The
+ * inputs are an object-like macro so that their commas don't split
+ * TEST_HELPER's arguments. */
+#define ARRAY_TEST_INPUTS { FIX_ZERO, FIXNUM(0,5), FIXNUM(-0,5), FIX_EPSILON, \
+  FIX_EPSILON_NEG, FIX_MAX, FIX_MIN, FIX_INF_POS, FIX_INF_NEG, FIX_NAN, \
+  FIXNUM(1,0), FIXNUM(-1,0) }
+
+#define ARRAY_UNARY(name, function) \
+TEST_HELPER(array_##name, { \
+  fixed in[] = ARRAY_TEST_INPUTS; \
+  size_t n = sizeof(in) / sizeof(in[0]); \
+  fixed out[sizeof(in) / sizeof(in[0])]; \
+  function##_array(out, in, n); \
+  for(size_t i = 0; i < n; i++) { \
+    fixed expected = function(in[i]); \
+    CHECK_EQ_NAN(#name, out[i], expected); \
+  } \
+  function##_array(out, in + 1, n - 1); \
+  for(size_t i = 0; i < n - 1; i++) { \
+    fixed expected = function(in[i + 1]); \
+    CHECK_EQ_NAN(#name " offset", out[i], expected); \
+  } \
+};)
+
+/* Every pair of inputs, which is a few blocks' worth, and once more in place,
+ * one short so that the SIMD kernels' leftover elements are covered too. */
+#define ARRAY_BINARY(name, function) \
+TEST_HELPER(array_##name, { \
+  fixed in[] = ARRAY_TEST_INPUTS; \
+  size_t nin = sizeof(in) / sizeof(in[0]); \
+  size_t n = nin * nin; \
+  fixed op1[sizeof(in) / sizeof(in[0]) * sizeof(in) / sizeof(in[0])]; \
+  fixed op2[sizeof(in) / sizeof(in[0]) * sizeof(in) / sizeof(in[0])]; \
+  fixed out[sizeof(in) / sizeof(in[0]) * sizeof(in) / sizeof(in[0])]; \
+  for(size_t i = 0; i < n; i++) { \
+    op1[i] = in[i / nin]; \
+    op2[i] = in[i % nin]; \
+  } \
+  function##_array(out, op1, op2, n); \
+  for(size_t i = 0; i < n; i++) { \
+    fixed expected = function(op1[i], op2[i]); \
+    CHECK_EQ_NAN(#name, out[i], expected); \
+  } \
+  function##_array(op1, op1, op2, n - 1); \
+  for(size_t i = 0; i < n - 1; i++) { \
+    CHECK_EQ_NAN(#name " in place", op1[i], out[i]); \
+  } \
+};)
+
+#define ARRAY_CMP \
+TEST_HELPER(array_cmp, { \
+  fixed in[] = ARRAY_TEST_INPUTS; \
+  size_t nin = sizeof(in) / sizeof(in[0]); \
+  size_t n = nin * nin; \
+  fixed op1[sizeof(in) / sizeof(in[0]) * sizeof(in) / sizeof(in[0])]; \
+  fixed op2[sizeof(in) / sizeof(in[0]) * sizeof(in) / sizeof(in[0])]; \
+  int8_t out[sizeof(in) / sizeof(in[0]) * sizeof(in) / sizeof(in[0])]; \
+  for(size_t i = 0; i < n; i++) { \
+    op1[i] = in[i / nin]; \
+    op2[i] = in[i % nin]; \
+  } \
+  out[n - 1] = 2; \
+  fix_cmp_array(out, op1, op2, n - 1); \
+  for(size_t i = 0; i < n - 1; i++) { \
+    CHECK_INT_EQUAL("cmp array", out[i], fix_cmp(op1[i], op2[i])); \
+  } \
+  CHECK_INT_EQUAL("cmp array overrun", out[n - 1], 2); \
+};)
+
+#define ARRAY_SCALAR(name, function) \
+TEST_HELPER(array_##name##_scalar, { \
+  fixed in[] = ARRAY_TEST_INPUTS; \
+  size_t n = sizeof(in) / sizeof(in[0]); \
+  fixed out[sizeof(in) / sizeof(in[0])]; \
+  for(size_t k = 0; k < n; k++) { \
+    function##_scalar_array(out, in, in[k], n); \
+    for(size_t i = 0; i < n; i++) { \
+      fixed expected = function(in[i], in[k]); \
+      CHECK_EQ_NAN(#name " scalar", out[i], expected); \
+    } \
+  } \
+};)
+
+/* Runs one of the SIMD kernels directly, since array.c only calls the widest
+ * one the CPU has, on every pair of inputs and then on a few thousand
+ * arbitrary bit patterns. Skipped where the CPU can't run it. */
+#if FIX_X86_SIMD
+#define ARRAY_KERNEL(name, kernel, function, has) \
+TEST_HELPER(array_kernel_##name, { \
+  if(!has()) { \
+    skip(); \
+  } \
+  fixed in[] = ARRAY_TEST_INPUTS; \
+  size_t nin = sizeof(in) / sizeof(in[0]); \
+  fixed op1[4099]; \
+  fixed op2[4099]; \
+  fixed out[4099]; \
+  size_t n = sizeof(op1) / sizeof(op1[0]); \
+  uint64_t x = 0x9e3779b97f4a7c15ull; \
+  for(size_t i = 0; i < n; i++) { \
+    test_next_rand(&x); \
+    op1[i] = i < nin * nin ? in[i / nin] : x >> (x % 64); \
+    op2[i] = i < nin * nin ? in[i % nin] : (x * 0xbf58476d1ce4e5b9ull) >> (x % 61); \
+  } \
+  kernel(out, op1, op2, n); \
+  for(size_t i = 0; i < n; i++) { \
+    fixed expected = function(op1[i], op2[i]); \
+    CHECK_EQ_NAN(#name, out[i], expected); \
+  } \
+};)
+#else
+#define ARRAY_KERNEL(name, kernel, function, has) \
+TEST_HELPER(array_kernel_##name, { \
+  skip(); \
+};)
+#endif
+
+/* Like ARRAY_UNARY, but on enough arbitrary bit patterns to fill several of
+ * the blocks the trig, exp and log arrays work in, with some left over. */
+#define ARRAY_BLOCKS(name, function) \
+TEST_HELPER(array_blocks_##name, { \
+  fixed in[] = ARRAY_TEST_INPUTS; \
+  size_t nin = sizeof(in) / sizeof(in[0]); \
+  fixed op1[1000]; \
+  fixed out[1000]; \
+  size_t n = sizeof(op1) / sizeof(op1[0]); \
+  uint64_t x = 0x9e3779b97f4a7c15ull; \
+  for(size_t i = 0; i < n; i++) { \
+    test_next_rand(&x); \
+    fixed y = x >> (x % 64); \
+    op1[i] = i % 3 == 0 ? in[x % nin] : (i % 3 == 1 ? y : ~y + 1); \
+  } \
+  function##_array(out, op1, n); \
+  for(size_t i = 0; i < n; i++) { \
+    fixed expected = function(op1[i]); \
+    CHECK_EQ_NAN(#name " blocks", out[i], expected); \
+  } \
+};)
+
+#define ARRAY_SINCOS(name, function) \
+TEST_HELPER(array_##name, { \
+  fixed in[] = ARRAY_TEST_INPUTS; \
+  size_t n = sizeof(in) / sizeof(in[0]); \
+  fixed outs[sizeof(in) / sizeof(in[0])]; \
+  fixed outc[sizeof(in) / sizeof(in[0])]; \
+  function##_array(outs, outc, in, n); \
+  for(size_t i = 0; i < n; i++) { \
+    fixed expected_s; \
+    fixed expected_c; \
+    function(in[i], &expected_s, &expected_c); \
+    CHECK_EQ_NAN(#name " sin", outs[i], expected_s); \
+    CHECK_EQ_NAN(#name " cos", outc[i], expected_c); \
+  } \
+};)
+
 //////////////////////////////////////////////////////////////////////////////
 
 #define TEST_ROUND_TO_EVEN(name, value, shift, result) \
@@ -420,6 +584,442 @@ FLOOR_CEIL(inf_neg  , FIX_INF_NEG                  , FIX_INF_NEG             , F
 FLOOR_CEIL(nan      , FIX_NAN                      , FIX_NAN                 , FIX_NAN)
 FLOOR_CEIL_TESTS
 
+/* Specials that carry data bits, as other operations can return; rounding must
+ * keep just the flags. */
+#define ROUND_SPECIAL_INPUTS { FIX_NAN | FIX_DATA_BITS(FIX_MAX), \
+  FIX_INF_NEG | FIX_DATA_BITS(FIX_MAX), FIX_INF_POS | FIX_DATA_BITS(FIX_MIN), \
+  FIX_NAN | FIX_DATA_BITS(FIX_MIN) }
+#define ROUND_SPECIAL_RESULTS { FIX_NAN, FIX_INF_NEG, FIX_INF_POS, FIX_NAN }
+
+#define ROUND_TRUNC(name, cond, value, round_result, trunc_result) \
+TEST_HELPER(round_trunc_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed input = value; \
+  fixed round_expected = round_result; \
+  fixed trunc_expected = trunc_result; \
+  CHECK_EQ_NAN("round "#name, fix_round(input), round_expected); \
+  CHECK_EQ_NAN("trunc "#name, fix_trunc(input), trunc_expected); \
+};)
+
+#define ROUND_TO_BITS(name, cond, value, bits, result) \
+TEST_HELPER(round_to_bits_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed input = value; \
+  fixed expected = result; \
+  CHECK_EQ_NAN("round_to_bits "#name, fix_round_to_bits(input, bits), expected); \
+};)
+
+/* Most decimals aren't exact in binary, and FIXNUM can be a unit off for
+ * them, so build those expectations with fix_div_i64. */
+#define ROUND_DECIMAL(name, cond, value, digits, result) \
+TEST_HELPER(round_decimal_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed input = value; \
+  fixed expected = result; \
+  CHECK_EQ_NAN("round_decimal "#name, fix_round_decimal(input, digits), expected); \
+};)
+
+#define ROUND_TESTS                                                                               \
+ROUND_TRUNC(zero      , 1, FIX_ZERO, FIX_ZERO, FIX_ZERO)                                           \
+ROUND_TRUNC(half      , 1, FIXNUM(0,5), FIX_ZERO, FIX_ZERO)                                        \
+ROUND_TRUNC(one_half  , FIX_INT_BITS >= 3, FIXNUM(1,5), FIXNUM(2,0), FIXNUM(1,0))                  \
+ROUND_TRUNC(two_half  , FIX_INT_BITS >= 3, FIXNUM(2,5), FIXNUM(2,0), FIXNUM(2,0))                  \
+ROUND_TRUNC(neg_half  , 1, FIXNUM(-0,5), FIX_ZERO, FIX_ZERO)                                       \
+ROUND_TRUNC(neg_1_half, FIX_INT_BITS >= 2, FIXNUM(-1,5), FIXNUM(-2,0), FIXNUM(-1,0))               \
+ROUND_TRUNC(neg_2_half, FIX_INT_BITS >= 3, FIXNUM(-2,5), FIXNUM(-2,0), FIXNUM(-2,0))               \
+ROUND_TRUNC(up        , FIX_INT_BITS >= 2 && FIX_FRAC_BITS >= 2, FIXNUM(0,75), FIXNUM(1,0),        \
+            FIX_ZERO)                                                                              \
+ROUND_TRUNC(neg_up    , FIX_INT_BITS >= 2 && FIX_FRAC_BITS >= 2, FIXNUM(-0,75), FIXNUM(-1,0),      \
+            FIX_ZERO)                                                                              \
+ROUND_TRUNC(epsilon   , FIX_FRAC_BITS >= 2, FIX_EPSILON, FIX_ZERO, FIX_ZERO)                       \
+ROUND_TRUNC(eps_neg   , FIX_FRAC_BITS >= 2, FIX_EPSILON_NEG, FIX_ZERO, FIX_ZERO)                   \
+ROUND_TRUNC(max       , 1, FIX_MAX, FIX_INF_POS, fix_floor(FIX_MAX))                               \
+ROUND_TRUNC(min       , 1, FIX_MIN, FIX_MIN, FIX_MIN)                                              \
+ROUND_TRUNC(inf_pos   , 1, FIX_INF_POS, FIX_INF_POS, FIX_INF_POS)                                  \
+ROUND_TRUNC(inf_neg   , 1, FIX_INF_NEG, FIX_INF_NEG, FIX_INF_NEG)                                  \
+ROUND_TRUNC(nan       , 1, FIX_NAN, FIX_NAN, FIX_NAN)                                              \
+ROUND_TRUNC(nan_data  , 1, FIX_NAN | FIX_DATA_BITS(FIX_MAX), FIX_NAN, FIX_NAN)                     \
+ROUND_TRUNC(ninf_data , 1, FIX_INF_NEG | FIX_DATA_BITS(FIX_MAX), FIX_INF_NEG, FIX_INF_NEG)         \
+ROUND_TRUNC(pinf_data , 1, FIX_INF_POS | FIX_DATA_BITS(FIX_MIN), FIX_INF_POS, FIX_INF_POS)         \
+ROUND_TO_BITS(tie_up  , FIX_INT_BITS >= 2 && FIX_FRAC_BITS >= 2, FIXNUM(0,75), 1, FIXNUM(1,0))     \
+ROUND_TO_BITS(tie_down, FIX_FRAC_BITS >= 2, FIXNUM(0,25), 1, FIX_ZERO)                             \
+ROUND_TO_BITS(quarter , FIX_FRAC_BITS >= 3, FIXNUM(0,625), 2, FIXNUM(0,5))                         \
+ROUND_TO_BITS(neg     , FIX_FRAC_BITS >= 3, FIXNUM(-0,375), 2, FIXNUM(-0,5))                       \
+ROUND_TO_BITS(all     , 1, FIX_EPSILON, FIX_FRAC_BITS, FIX_EPSILON)                                \
+ROUND_TO_BITS(more    , 1, FIX_EPSILON, FIX_FRAC_BITS + 5, FIX_EPSILON)                            \
+ROUND_TO_BITS(int_max , 1, FIX_EPSILON, INT32_MAX, FIX_EPSILON)                                    \
+ROUND_TO_BITS(eps_tie , 1, FIX_EPSILON, FIX_FRAC_BITS - 1, FIX_ZERO)                               \
+ROUND_TO_BITS(eps_up  , 1, 3 * FIX_EPSILON, FIX_FRAC_BITS - 1, 4 * FIX_EPSILON)                    \
+ROUND_TO_BITS(twos    , FIX_INT_BITS >= 4, FIXNUM(5,0), -1, FIXNUM(4,0))                           \
+ROUND_TO_BITS(fours   , FIX_INT_BITS >= 5, FIXNUM(6,0), -2, FIXNUM(8,0))                           \
+ROUND_TO_BITS(top     , 1, FIX_MIN, 1 - FIX_INT_BITS, FIX_MIN)                                     \
+ROUND_TO_BITS(top_ovf , 1, FIX_MAX, 1 - FIX_INT_BITS, FIX_INF_POS)                                 \
+ROUND_TO_BITS(past_max, 1, FIX_MAX, INT32_MIN, FIX_ZERO)                                           \
+ROUND_TO_BITS(past_min, 1, FIX_MIN, INT32_MIN, FIX_ZERO)                                           \
+ROUND_TO_BITS(inf_pos , 1, FIX_INF_POS, 3, FIX_INF_POS)                                            \
+ROUND_TO_BITS(inf_neg , 1, FIX_INF_NEG, 3, FIX_INF_NEG)                                            \
+ROUND_TO_BITS(nan     , 1, FIX_NAN, 3, FIX_NAN)                                                    \
+ROUND_TO_BITS(nan_data, 1, FIX_NAN | FIX_DATA_BITS(FIX_MAX), 0, FIX_NAN)                           \
+ROUND_TO_BITS(neg_data, 1, FIX_INF_NEG | FIX_DATA_BITS(FIX_MAX), 0, FIX_INF_NEG)                   \
+ROUND_TO_BITS(nan_all , 1, FIX_NAN | FIX_DATA_BITS(FIX_MAX), INT32_MIN, FIX_NAN)                   \
+ROUND_DECIMAL(tie_down, FIX_INT_BITS >= 3 && FIX_FRAC_BITS >= 3, FIXNUM(0,125), 2,                 \
+              fix_div_i64(FIXNUM(3,0), 25))                                                        \
+ROUND_DECIMAL(tie_up  , FIX_INT_BITS >= 6 && FIX_FRAC_BITS >= 3, FIXNUM(0,375), 2,                 \
+              fix_div_i64(FIXNUM(19,0), 50))                                                       \
+ROUND_DECIMAL(tie_neg , FIX_INT_BITS >= 3 && FIX_FRAC_BITS >= 3, FIXNUM(-0,125), 2,                \
+              fix_div_i64(FIXNUM(-3,0), 25))                                                       \
+ROUND_DECIMAL(tenths  , FIX_INT_BITS >= 3 && FIX_FRAC_BITS >= 3, FIXNUM(0,625), 1,                 \
+              fix_div_i64(FIXNUM(3,0), 5))                                                         \
+ROUND_DECIMAL(thous   , FIX_INT_BITS >= 6 && FIX_FRAC_BITS >= 4, FIXNUM(0,0625), 3,                \
+              fix_div_i64(FIXNUM(31,0), 500))                                                      \
+ROUND_DECIMAL(four    , FIX_INT_BITS >= 14 && FIX_FRAC_BITS >= 20, FIXNUM(1,23456), 4,             \
+              fix_div_i64(FIXNUM(6173,0), 5000))                                                   \
+ROUND_DECIMAL(int_even, FIX_INT_BITS >= 3, FIXNUM(2,5), 0, FIXNUM(2,0))                            \
+ROUND_DECIMAL(int_odd , FIX_INT_BITS >= 4, FIXNUM(3,5), 0, FIXNUM(4,0))                            \
+ROUND_DECIMAL(all     , 1, FIX_EPSILON, FIX_FRAC_BITS, FIX_EPSILON)                                \
+ROUND_DECIMAL(many    , 1, FIX_EPSILON, INT32_MAX, FIX_EPSILON)                                    \
+ROUND_DECIMAL(eps     , FIX_FRAC_BITS >= 8, FIX_EPSILON, 2, FIX_ZERO)                              \
+ROUND_DECIMAL(max     , 1, FIX_MAX, 0, FIX_INF_POS)                                                \
+ROUND_DECIMAL(min     , 1, FIX_MIN, 0, FIX_MIN)                                                    \
+ROUND_DECIMAL(neg_dig , 1, FIXNUM(0,5), -1, FIX_NAN)                                               \
+ROUND_DECIMAL(inf_pos , 1, FIX_INF_POS, 2, FIX_INF_POS)                                            \
+ROUND_DECIMAL(inf_neg , 1, FIX_INF_NEG, 2, FIX_INF_NEG)                                            \
+ROUND_DECIMAL(nan     , 1, FIX_NAN, 2, FIX_NAN)                                                    \
+ARRAY_UNARY(round, fix_round)                                                                      \
+ARRAY_UNARY(trunc, fix_trunc)                                                                      \
+TEST_HELPER(array_round_to_bits, {                                                                 \
+  fixed in[] = ARRAY_TEST_INPUTS;                                                                  \
+  size_t n = sizeof(in) / sizeof(in[0]);                                                           \
+  fixed out[sizeof(in) / sizeof(in[0])];                                                           \
+  fix_round_to_bits_array(out, in, 1, n);                                                          \
+  for(size_t i = 0; i < n; i++) {                                                                  \
+    fixed expected = fix_round_to_bits(in[i], 1);                                                  \
+    CHECK_EQ_NAN("round_to_bits", out[i], expected);                                               \
+  }                                                                                                \
+};)                                                                                                \
+TEST_HELPER(array_round_specials, {                                                                \
+  fixed in[] = ROUND_SPECIAL_INPUTS;                                                               \
+  fixed expected[] = ROUND_SPECIAL_RESULTS;                                                        \
+  size_t n = sizeof(in) / sizeof(in[0]);                                                           \
+  fixed out[sizeof(in) / sizeof(in[0])];                                                           \
+  fix_round_array(out, in, n);                                                                     \
+  for(size_t i = 0; i < n; i++) {                                                                  \
+    CHECK_EQ_NAN("round specials", out[i], expected[i]);                                           \
+  }                                                                                                \
+  fix_round_to_bits_array(out, in, 0, n);                                                          \
+  for(size_t i = 0; i < n; i++) {                                                                  \
+    CHECK_EQ_NAN("round_to_bits specials", out[i], expected[i]);                                   \
+  }                                                                                                \
+};)                                                                                                \
+TEST_HELPER(array_round_decimal, {                                                                 \
+  fixed in[] = ARRAY_TEST_INPUTS;                                                                  \
+  size_t n = sizeof(in) / sizeof(in[0]);                                                           \
+  fixed out[sizeof(in) / sizeof(in[0])];                                                           \
+  fix_round_decimal_array(out, in, 2, n);                                                          \
+  for(size_t i = 0; i < n; i++) {                                                                  \
+    fixed expected = fix_round_decimal(in[i], 2);                                                  \
+    CHECK_EQ_NAN("round_decimal", out[i], expected);                                               \
+  }                                                                                                \
+};)
+ROUND_TESTS
+
+#define MULI(name, cond, op1, k, result) \
+TEST_HELPER(mul_i64_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed o1 = op1; \
+  fixed expected = result; \
+  CHECK_EQ_NAN("mul_i64 "#name, fix_mul_i64(o1, k), expected); \
+};)
+
+#define DIVI(name, cond, op1, k, result) \
+TEST_HELPER(div_i64_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed o1 = op1; \
+  fixed expected = result; \
+  CHECK_EQ_NAN("div_i64 "#name, fix_div_i64(o1, k), expected); \
+};)
+
+#define ARRAY_INT(name, function) \
+TEST_HELPER(array_##name, { \
+  fixed in[] = ARRAY_TEST_INPUTS; \
+  size_t n = sizeof(in) / sizeof(in[0]); \
+  int64_t k[sizeof(in) / sizeof(in[0])]; \
+  fixed out[sizeof(in) / sizeof(in[0])]; \
+  for(size_t i = 0; i < n; i++) { \
+    k[i] = ((int64_t) i) - 3; \
+  } \
+  function##_array(out, in, k, n); \
+  for(size_t i = 0; i < n; i++) { \
+    fixed expected = function(in[i], k[i]); \
+    CHECK_EQ_NAN(#name, out[i], expected); \
+  } \
+};)
+
+#define INT_ARITH_TESTS                                                                           \
+MULI(basic     , FIX_INT_BITS >= 4, FIXNUM(1,5), 3, FIXNUM(4,5))                                   \
+MULI(neg       , FIX_INT_BITS >= 3, FIXNUM(1,5), -2, FIXNUM(-3,0))                                 \
+MULI(big_k     , FIX_INT_BITS >= 2, FIX_EPSILON, ((int64_t) 1) << FIX_FRAC_BITS, FIXNUM(1,0))      \
+MULI(to_min    , 1, FIX_EPSILON_NEG, ((int64_t) 1) << 61, FIX_MIN)                                 \
+MULI(ovf       , 1, FIX_EPSILON, ((int64_t) 1) << 61, FIX_INF_POS)                                 \
+MULI(ovf_neg   , 1, FIX_MAX, -2, FIX_INF_NEG)                                                      \
+MULI(k_min     , 1, FIX_EPSILON, INT64_MIN, FIX_INF_NEG)                                           \
+MULI(zero_k_min, 1, FIX_ZERO, INT64_MIN, FIX_ZERO)                                                 \
+MULI(zero      , 1, FIX_MAX, 0, FIX_ZERO)                                                          \
+MULI(inf_zero  , 1, FIX_INF_POS, 0, FIX_ZERO)                                                      \
+MULI(inf_neg_k , 1, FIX_INF_POS, -3, FIX_INF_NEG)                                                  \
+MULI(neg_inf   , 1, FIX_INF_NEG, -3, FIX_INF_POS)                                                  \
+MULI(nan       , 1, FIX_NAN, 3, FIX_NAN)                                                           \
+DIVI(basic     , FIX_INT_BITS >= 4, FIXNUM(4,5), 3, FIXNUM(1,5))                                   \
+DIVI(neg       , FIX_INT_BITS >= 3, FIXNUM(-3,0), 2, FIXNUM(-1,5))                                 \
+DIVI(big_k     , FIX_INT_BITS >= 2, FIXNUM(1,0), ((int64_t) 1) << FIX_FRAC_BITS, FIX_EPSILON)      \
+DIVI(round_up  , 1, 3 * FIX_EPSILON, 2, 2 * FIX_EPSILON)                                           \
+DIVI(round_dn  , 1, 5 * FIX_EPSILON, 2, 2 * FIX_EPSILON)                                           \
+DIVI(round_neg , 1, fix_neg(3 * FIX_EPSILON), -2, 2 * FIX_EPSILON)                                 \
+DIVI(third     , 1, 2 * FIX_EPSILON, 3, FIX_EPSILON)                                               \
+DIVI(k_max     , 1, FIX_MAX, INT64_MAX, FIX_ZERO)                                                  \
+DIVI(k_min     , 1, FIX_MIN, INT64_MIN, FIX_ZERO)                                                  \
+DIVI(min_one   , 1, FIX_MIN, 1, FIX_MIN)                                                           \
+DIVI(min_two   , 1, FIX_MIN, 2, fix_ldexp(FIX_MIN, -1))                                            \
+DIVI(min_neg   , 1, FIX_MIN, -1, FIX_INF_POS)                                                      \
+DIVI(by_zero   , 1, FIXNUM(0,5), 0, FIX_INF_POS)                                                   \
+DIVI(neg_zero  , 1, FIXNUM(-0,5), 0, FIX_INF_NEG)                                                  \
+DIVI(zero_zero , 1, FIX_ZERO, 0, FIX_NAN)                                                          \
+DIVI(inf_neg_k , 1, FIX_INF_POS, -2, FIX_INF_NEG)                                                  \
+DIVI(inf_zero  , 1, FIX_INF_NEG, 0, FIX_INF_NEG)                                                   \
+DIVI(nan       , 1, FIX_NAN, 3, FIX_NAN)                                                           \
+ARRAY_INT(mul_i64, fix_mul_i64)                                                                    \
+ARRAY_INT(div_i64, fix_div_i64)
+INT_ARITH_TESTS
+
+/* These are all exact, so compare bit for bit. */
+#define FMOD(name, cond, op1, op2, fmod_result, rem_result) \
+TEST_HELPER(fmod_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed o1 = op1; \
+  fixed o2 = op2; \
+  fixed fmod_expected = fmod_result; \
+  fixed rem_expected = rem_result; \
+  CHECK_EQ_NAN("fmod "#name, fix_fmod(o1, o2), fmod_expected); \
+  CHECK_EQ_NAN("remainder "#name, fix_remainder(o1, o2), rem_expected); \
+};)
+
+#define MODF(name, cond, op1, frac_result, int_result) \
+TEST_HELPER(modf_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed o1 = op1; \
+  fixed intpart; \
+  fixed frac = fix_modf(o1, &intpart); \
+  fixed frac_expected = frac_result; \
+  fixed int_expected = int_result; \
+  CHECK_EQ_NAN("modf frac "#name, frac, frac_expected); \
+  CHECK_EQ_NAN("modf int "#name, intpart, int_expected); \
+};)
+
+#define FMOD_TESTS                                                                                \
+FMOD(basic     , FIX_INT_BITS >= 4, FIXNUM(5,5), FIXNUM(2,0), FIXNUM(1,5), FIXNUM(-0,5))            \
+FMOD(neg_x     , FIX_INT_BITS >= 4, FIXNUM(-5,5), FIXNUM(2,0), FIXNUM(-1,5), FIXNUM(0,5))           \
+FMOD(neg_y     , FIX_INT_BITS >= 4, FIXNUM(5,5), FIXNUM(-2,0), FIXNUM(1,5), FIXNUM(-0,5))           \
+FMOD(tie_up    , FIX_FRAC_BITS >= 2, FIXNUM(0,75), FIXNUM(0,5), FIXNUM(0,25), FIXNUM(-0,25))       \
+FMOD(tie_down  , FIX_FRAC_BITS >= 2, FIXNUM(0,25), FIXNUM(0,5), FIXNUM(0,25), FIXNUM(0,25))        \
+FMOD(tie_two   , FIX_INT_BITS >= 2 && FIX_FRAC_BITS >= 2, FIXNUM(1,25), FIXNUM(0,5),                \
+     FIXNUM(0,25), FIXNUM(0,25))                                                                   \
+FMOD(multiple  , FIX_INT_BITS >= 3, FIXNUM(3,0), FIXNUM(1,5), FIX_ZERO, FIX_ZERO)                  \
+FMOD(pi        , FIX_INT_BITS >= 3, FIX_PI, FIXNUM(1,0), fix_sub(FIX_PI, FIXNUM(3,0)),              \
+     fix_sub(FIX_PI, FIXNUM(3,0)))                                                                 \
+FMOD(epsilon   , 1, FIX_MAX, FIX_EPSILON, FIX_ZERO, FIX_ZERO)                                      \
+FMOD(max       , 1, FIX_MAX, FIX_MIN, FIX_MAX, fix_neg(FIX_EPSILON))                               \
+FMOD(min       , FIX_INT_BITS >= 3, FIX_MIN, FIXNUM(2,0), FIX_ZERO, FIX_ZERO)                      \
+FMOD(y_inf     , 1, FIXNUM(0,5), FIX_INF_POS, FIXNUM(0,5), FIXNUM(0,5))                            \
+FMOD(y_inf_neg , 1, FIXNUM(-0,5), FIX_INF_NEG, FIXNUM(-0,5), FIXNUM(-0,5))                         \
+FMOD(y_zero    , 1, FIXNUM(0,5), FIX_ZERO, FIX_NAN, FIX_NAN)                                       \
+FMOD(x_inf     , 1, FIX_INF_POS, FIXNUM(0,5), FIX_NAN, FIX_NAN)                                    \
+FMOD(x_inf_neg , 1, FIX_INF_NEG, FIXNUM(0,5), FIX_NAN, FIX_NAN)                                    \
+FMOD(nan       , 1, FIX_NAN, FIXNUM(0,5), FIX_NAN, FIX_NAN)                                        \
+FMOD(nan_y     , 1, FIXNUM(0,5), FIX_NAN, FIX_NAN, FIX_NAN)                                        \
+MODF(basic     , FIX_INT_BITS >= 3 && FIX_FRAC_BITS >= 2, FIXNUM(2,75), FIXNUM(0,75), FIXNUM(2,0))  \
+MODF(neg       , FIX_INT_BITS >= 3 && FIX_FRAC_BITS >= 2, FIXNUM(-2,75), FIXNUM(-0,75),            \
+     FIXNUM(-2,0))                                                                                 \
+MODF(half      , 1, FIXNUM(0,5), FIXNUM(0,5), FIX_ZERO)                                            \
+MODF(neg_half  , 1, FIXNUM(-0,5), FIXNUM(-0,5), FIX_ZERO)                                          \
+MODF(min       , 1, FIX_MIN, FIX_ZERO, FIX_MIN)                                                    \
+MODF(inf_pos   , 1, FIX_INF_POS, FIX_ZERO, FIX_INF_POS)                                            \
+MODF(inf_neg   , 1, FIX_INF_NEG, FIX_ZERO, FIX_INF_NEG)                                            \
+MODF(nan       , 1, FIX_NAN, FIX_NAN, FIX_NAN)
+FMOD_TESTS
+
+#define LDEXP(name, cond, op1, exp, result) \
+TEST_HELPER(ldexp_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed o1 = op1; \
+  fixed expected = result; \
+  CHECK_EQ_NAN("ldexp "#name, fix_ldexp(o1, exp), expected); \
+};)
+
+#define FREXP(name, cond, op1, m_result, exp_result) \
+TEST_HELPER(frexp_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed o1 = op1; \
+  int32_t e; \
+  fixed m = fix_frexp(o1, &e); \
+  fixed m_expected = m_result; \
+  int32_t e_expected = exp_result; \
+  CHECK_EQ_NAN("frexp mantissa "#name, m, m_expected); \
+  CHECK_INT_EQUAL("frexp exponent "#name, e, e_expected); \
+};)
+
+#define ILOGB(name, cond, op1, result) \
+TEST_HELPER(ilogb_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed o1 = op1; \
+  int32_t expected = result; \
+  CHECK_INT_EQUAL("ilogb "#name, fix_ilogb(o1), expected); \
+};)
+
+#define SCALE_TESTS                                                                               \
+LDEXP(up       , FIX_INT_BITS >= 4, FIXNUM(1,5), 2, FIXNUM(6,0))                                   \
+LDEXP(down     , FIX_INT_BITS >= 2 && FIX_FRAC_BITS >= 2, FIXNUM(1,5), -1, FIXNUM(0,75))           \
+LDEXP(neg      , FIX_INT_BITS >= 3, FIXNUM(-1,5), 1, FIXNUM(-3,0))                                 \
+LDEXP(zero_exp , 1, FIX_MIN, 0, FIX_MIN)                                                           \
+LDEXP(to_min   , 1, FIXNUM(-0,5), FIX_INT_BITS, FIX_MIN)                                           \
+LDEXP(to_max   , 1, FIXNUM(0,5), FIX_INT_BITS - 1, FIX_INT_BITS >= 2 ? FIXNUM(FIX_INT_MAX/2,0) :   \
+                                                  FIXNUM(0,5))                                     \
+LDEXP(round_up , 1, 3 * FIX_EPSILON, -1, 2 * FIX_EPSILON)                                          \
+LDEXP(round_dn , 1, 5 * FIX_EPSILON, -1, 2 * FIX_EPSILON)                                          \
+LDEXP(round_neg, 1, fix_neg(3 * FIX_EPSILON), -1, fix_neg(2 * FIX_EPSILON))                        \
+LDEXP(half_eps , 1, FIX_EPSILON, -1, FIX_ZERO)                                                     \
+LDEXP(ovf      , 1, FIXNUM(0,5), FIX_INT_BITS, FIX_INF_POS)                                        \
+LDEXP(ovf_max  , 1, FIX_MAX, 1, FIX_INF_POS)                                                       \
+LDEXP(ovf_neg  , 1, fix_neg(FIX_MAX), 1, FIX_INF_NEG)                                              \
+LDEXP(huge     , 1, FIX_EPSILON, INT32_MAX, FIX_INF_POS)                                           \
+LDEXP(tiny     , 1, FIX_MAX, INT32_MIN, FIX_ZERO)                                                  \
+LDEXP(zero     , 1, FIX_ZERO, 1000, FIX_ZERO)                                                      \
+LDEXP(inf_pos  , 1, FIX_INF_POS, -1000, FIX_INF_POS)                                               \
+LDEXP(inf_neg  , 1, FIX_INF_NEG, 3, FIX_INF_NEG)                                                   \
+LDEXP(nan      , 1, FIX_NAN, 3, FIX_NAN)                                                           \
+FREXP(one      , FIX_INT_BITS >= 2, FIXNUM(1,0), FIXNUM(0,5), 1)                                   \
+FREXP(half     , 1, FIXNUM(0,5), FIXNUM(0,5), 0)                                                   \
+FREXP(neg      , FIX_INT_BITS >= 3 && FIX_FRAC_BITS >= 2, FIXNUM(-3,0), FIXNUM(-0,75), 2)          \
+FREXP(epsilon  , 1, FIX_EPSILON, FIXNUM(0,5), 1 - FIX_FRAC_BITS)                                   \
+FREXP(max      , 1, FIX_MAX, FIX_INT_BITS == 1 ? FIX_MAX : FIXNUM(0,5),                            \
+                                               FIX_INT_BITS == 1 ? 0 : FIX_INT_BITS)               \
+FREXP(min      , 1, FIX_MIN, FIXNUM(-0,5), FIX_INT_BITS)                                           \
+FREXP(zero     , 1, FIX_ZERO, FIX_ZERO, 0)                                                         \
+FREXP(inf_pos  , 1, FIX_INF_POS, FIX_INF_POS, 0)                                                   \
+FREXP(inf_neg  , 1, FIX_INF_NEG, FIX_INF_NEG, 0)                                                   \
+FREXP(nan      , 1, FIX_NAN, FIX_NAN, 0)                                                           \
+ILOGB(one      , FIX_INT_BITS >= 2, FIXNUM(1,0), 0)                                                \
+ILOGB(half     , 1, FIXNUM(0,5), -1)                                                               \
+ILOGB(neg      , FIX_INT_BITS >= 3, FIXNUM(-3,0), 1)                                               \
+ILOGB(epsilon  , 1, FIX_EPSILON, -FIX_FRAC_BITS)                                                   \
+ILOGB(max      , 1, FIX_MAX, FIX_INT_BITS - 2)                                                     \
+ILOGB(min      , 1, FIX_MIN, FIX_INT_BITS - 1)                                                     \
+ILOGB(zero     , 1, FIX_ZERO, FIX_ILOGB0)                                                          \
+ILOGB(inf_pos  , 1, FIX_INF_POS, INT32_MAX)                                                        \
+ILOGB(inf_neg  , 1, FIX_INF_NEG, INT32_MAX)                                                        \
+ILOGB(nan      , 1, FIX_NAN, FIX_ILOGBNAN)
+SCALE_TESTS
+
+/* str is a string literal; its length comes from sizeof, so it may hold NULs. */
+#define PARSE(name, cond, str, rc, result) \
+TEST_HELPER(parse_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed parsed; \
+  int8_t r = fix_parse(str, sizeof(str) - 1, &parsed); \
+  fixed expected = result; \
+  CHECK_INT_EQUAL("parse return "#name, r, rc); \
+  CHECK_EQ_NAN("parse "#name, parsed, expected); \
+};)
+
+#define PARSE_TESTS                                                                               \
+PARSE(one_half  , FIX_INT_BITS >= 2, "1.5", 0, FIXNUM(1,5))                                       \
+PARSE(neg       , FIX_INT_BITS >= 3, "-2.25", 0, FIXNUM(-2,25))                                   \
+PARSE(plus      , 1, "+0.5", 0, FIXNUM(0,5))                                                      \
+PARSE(lead_dot  , 1, ".25", 0, FIXNUM(0,25))                                                      \
+PARSE(trail_dot , FIX_INT_BITS >= 2, "1.", 0, FIXNUM(1,0))                                        \
+PARSE(zeros     , FIX_INT_BITS >= 2, "0001.0000", 0, FIXNUM(1,0))                                 \
+PARSE(neg_zero  , 1, "-0", 0, FIX_ZERO)                                                           \
+PARSE(spaces    , 1, " \t0.5 \r\n", 0, FIXNUM(0,5))                                               \
+PARSE(tenth     , FIX_INT_BITS >= 2, "0.1", 0, fix_div_i64(FIXNUM(1,0), 10))                      \
+PARSE(long      , 1, "0.500000000000000000000000000000000000000000000000000000000000000000001",   \
+      0, FIXNUM(0,5))                                                                             \
+PARSE(nul       , 1, "0.5\0junk", 0, FIXNUM(0,5))                                                 \
+PARSE(inf       , 1, "inf", 0, FIX_INF_POS)                                                       \
+PARSE(inf_neg   , 1, "-Infinity", 0, FIX_INF_NEG)                                                 \
+PARSE(nan       , 1, "NaN", 0, FIX_NAN)                                                           \
+PARSE(big       , 1, "100000000000000000000000", 0, FIX_INF_POS)                                  \
+PARSE(big_neg   , 1, "-100000000000000000000000.5", 0, FIX_INF_NEG)                               \
+PARSE(empty     , 1, "", -1, FIX_NAN)                                                             \
+PARSE(blank     , 1, "  ", -1, FIX_NAN)                                                           \
+PARSE(sign      , 1, "-", -1, FIX_NAN)                                                            \
+PARSE(dot       , 1, ".", -1, FIX_NAN)                                                            \
+PARSE(two_dots  , 1, "1.2.3", -1, FIX_NAN)                                                        \
+PARSE(exponent  , 1, "1e5", -1, FIX_NAN)                                                          \
+PARSE(space_sign, 1, "- 1", -1, FIX_NAN)                                                          \
+PARSE(inner     , 1, "1 2", -1, FIX_NAN)                                                          \
+PARSE(word      , 1, "infinite", -1, FIX_NAN)                                                     \
+TEST_HELPER(parse_round_trip, {                                                                   \
+  fixed in[] = ARRAY_TEST_INPUTS;                                                                 \
+  for(size_t i = 0; i < sizeof(in) / sizeof(in[0]); i++) {                                        \
+    char buf[FIX_PRINT_BUFFER_SIZE];                                                              \
+    fixed parsed;                                                                                 \
+    fix_sprint(buf, in[i]);                                                                       \
+    CHECK_INT_EQUAL("parse round trip return", fix_parse(buf, sizeof(buf), &parsed), 0);          \
+    CHECK_EQ_NAN("parse round trip", parsed, in[i]);                                              \
+  }                                                                                               \
+};)                                                                                               \
+TEST_HELPER(parse_array, {                                                                        \
+  if(FIX_INT_BITS < 2) {                                                                          \
+    return;                                                                                       \
+  }                                                                                               \
+  const char buf[] = "1.5,-0.5\n0.25\r\nbad,\n";                                                  \
+  fixed out[8];                                                                                   \
+  size_t consumed;                                                                                \
+  size_t n = fix_parse_array(out, 8, buf, sizeof(buf) - 1, &consumed);                            \
+  CHECK_INT_EQUAL("parse_array count", n, 5);                                                     \
+  CHECK_INT_EQUAL("parse_array consumed", consumed, sizeof(buf) - 1);                             \
+  CHECK_EQ_NAN("parse_array 0", out[0], FIXNUM(1,5));                                             \
+  CHECK_EQ_NAN("parse_array 1", out[1], FIXNUM(-0,5));                                            \
+  CHECK_EQ_NAN("parse_array 2", out[2], FIXNUM(0,25));                                            \
+  CHECK_EQ_NAN("parse_array 3", out[3], FIX_NAN);                                                 \
+  CHECK_EQ_NAN("parse_array 4", out[4], FIX_NAN);                                                 \
+  n = fix_parse_array(out, 2, buf, sizeof(buf) - 1, &consumed);                                   \
+  CHECK_INT_EQUAL("parse_array limited count", n, 2);                                             \
+  CHECK_INT_EQUAL("parse_array limited consumed", consumed, 9);                                   \
+  out[2] = FIX_ZERO;                                                                              \
+  n = fix_parse_array(out, 2, buf, sizeof(buf) - 1, &consumed);                                   \
+  CHECK_EQ_NAN("parse_array limited untouched", out[2], FIX_ZERO);                                \
+  n = fix_parse_array(out, 8, "2,1", 3, &consumed);                                               \
+  CHECK_INT_EQUAL("parse_array open count", n, 2);                                                \
+  CHECK_INT_EQUAL("parse_array open consumed", consumed, 3);                                      \
+  CHECK_EQ_NAN("parse_array open 1", out[1], FIXNUM(1,0));                                        \
+  n = fix_parse_array(out, 0, buf, sizeof(buf) - 1, &consumed);                                   \
+  CHECK_INT_EQUAL("parse_array none count", n, 0);                                                \
+  CHECK_INT_EQUAL("parse_array none consumed", consumed, 0);                                      \
+};)
+PARSE_TESTS
+
 //////////////////////////////////////////////////////////////////////////////
 
 static void constants(void **state) {
@@ -497,7 +1097,8 @@ TEST_CMP(inf_neg_inf_pos , FIX_INF_NEG             , FIX_INF_POS         , -1) \
 TEST_CMP(inf_neg_pos     , FIX_INF_NEG             , FIXNUM(0   , 5)    , -1)  \
 TEST_CMP(inf_neg_neg     , FIX_INF_NEG             , FIXNUM(-0  , 5)    , -1)  \
 TEST_CMP(pos_neg         , FIXNUM(17   , 3)        , FIXNUM(-24  , 5)   , 1)  \
-TEST_CMP(neg_pos         , FIXNUM(-16  , 3)        , FIXNUM(24   , 5)   , -1)
+TEST_CMP(neg_pos         , FIXNUM(-16  , 3)        , FIXNUM(24   , 5)   , -1) \
+ARRAY_CMP
 CMP_TESTS
 
 //////////////////////////////////////////////////////////////////////////////
@@ -533,7 +1134,11 @@ ADD(nan_inf           , FIX_NAN                , FIX_INF_POS             , FIX_N
 ADD(nan_frac          , FIX_NAN                , FIXNUM(0,5)             , FIX_NAN)       \
 ADD(inf_nan           , FIX_INF_POS            , FIX_NAN                 , FIX_NAN)       \
 ADD(nan_inf_neg       , FIX_NAN                , FIX_INF_NEG             , FIX_NAN)       \
-ADD(inf_inf_neg       , FIX_INF_POS            , FIX_INF_NEG             , FIX_INF_POS)
+ADD(inf_inf_neg       , FIX_INF_POS            , FIX_INF_NEG             , FIX_INF_POS)   \
+ARRAY_BINARY(add, fix_add)                                                                \
+ARRAY_BINARY(sub, fix_sub)                                                                \
+ARRAY_SCALAR(add, fix_add)                                                                \
+ARRAY_SCALAR(sub, fix_sub)
 ADD_TESTS
 
 //////////////////////////////////////////////////////////////////////////////
@@ -578,7 +1183,11 @@ MUL(underflow_neg        , fix_neg(FIX_EPSILON)    , FIXNUM(0,0555)      , FIX_Z
 MUL(underflow_neg_rte    , fix_neg(FIX_EPSILON)    , FIXNUM(0,4555)      , FIX_ZERO)         \
 MUL(zero_inf             , FIXNUM(0,0)             , FIX_INF_POS         , FIXNUM(0,0))      \
 MUL(zero_ninf            , FIXNUM(0,0)             , FIX_INF_NEG         , FIXNUM(0,0))      \
-MUL(zero_nan             , FIXNUM(0,0)             , FIX_NAN             , FIX_NAN)
+MUL(zero_nan             , FIXNUM(0,0)             , FIX_NAN             , FIX_NAN)          \
+ARRAY_BINARY(mul, fix_mul)                                                                   \
+ARRAY_SCALAR(mul, fix_mul)                                                                   \
+ARRAY_KERNEL(mul_avx2, fix_mul_array_avx2, fix_mul, fix_cpu_has_avx2)                        \
+ARRAY_KERNEL(mul_ifma, fix_mul_array_ifma, fix_mul, fix_cpu_has_ifma)
 MUL_TESTS
 
 //////////////////////////////////////////////////////////////////////////////
@@ -633,7 +1242,9 @@ DIV(ninf_nan         , FIX_INF_NEG            , FIX_NAN                ,FIX_NAN)
 DIV(nan_pos          , FIX_NAN                , FIXNUM(10,0)           ,FIX_NAN)      \
 DIV(nan_neg          , FIX_NAN                , FIXNUM(-10,0)          ,FIX_NAN)      \
 DIV(nan_inf          , FIX_NAN                , FIX_INF_POS            ,FIX_NAN)      \
-DIV(nan_ninf         , FIX_NAN                , FIX_INF_NEG            ,FIX_NAN)
+DIV(nan_ninf         , FIX_NAN                , FIX_INF_NEG            ,FIX_NAN)      \
+ARRAY_BINARY(div, fix_div)                                                            \
+ARRAY_SCALAR(div, fix_div)
 DIV_TESTS
 
 //////////////////////////////////////////////////////////////////////////////
@@ -653,7 +1264,8 @@ NEG(half_neg,FIXNUM(-0,5)          , FIXNUM(0,5))  \
 NEG(min,     FIXNUM(-FIX_INT_MAX,0), FIX_INF_POS)  \
 NEG(inf,     FIX_INF_POS           , FIX_INF_NEG)  \
 NEG(inf_neg, FIX_INF_NEG           , FIX_INF_POS)  \
-NEG(nan,     FIX_NAN               , FIX_NAN)
+NEG(nan,     FIX_NAN               , FIX_NAN)      \
+ARRAY_UNARY(neg, fix_neg)
 NEG_TESTS
 
 //////////////////////////////////////////////////////////////////////////////
@@ -676,7 +1288,8 @@ ABS(two          , FIXNUM(2,0)           , FIXNUM(2,0)) \
 ABS(max_neg      , FIXNUM(-FIX_INT_MAX,0), FIX_INF_POS) \
 ABS(inf          , FIX_INF_POS           , FIX_INF_POS) \
 ABS(inf_neg      , FIX_INF_NEG           , FIX_INF_POS) \
-ABS(nan          , FIX_NAN               , FIX_NAN)
+ABS(nan          , FIX_NAN               , FIX_NAN)     \
+ARRAY_UNARY(abs, fix_abs)
 ABS_TESTS
 
 //////////////////////////////////////////////////////////////////////////////
@@ -709,7 +1322,9 @@ LN(big    , FIXNUM(536870911,0), FIXNUM(20,1012682343757688221340510129061971982
 LN(max    , FIX_MAX           , FIX_TEST_LN_max)                         \
 LN(inf    , FIX_INF_POS       , FIX_INF_POS)                             \
 LN(neg    , FIXNUM(-1,0)      , FIX_NAN)                                 \
-LN(nan    , FIX_NAN           , FIX_NAN)
+LN(nan    , FIX_NAN           , FIX_NAN)                                 \
+ARRAY_UNARY(ln, fix_ln)                                                  \
+ARRAY_BLOCKS(ln, fix_ln)
 
 LN_TESTS
 
@@ -740,7 +1355,9 @@ LOG2(max    , FIX_MAX           , FIX_TEST_LOG2_max )          \
 LOG2(min    , FIX_MIN           , FIX_NAN )                    \
 LOG2(inf    , FIX_INF_POS       , FIX_INF_POS)                 \
 LOG2(neg    , FIXNUM(-1,0)      , FIX_NAN)                     \
-LOG2(nan    , FIX_NAN           , FIX_NAN)
+LOG2(nan    , FIX_NAN           , FIX_NAN)                     \
+ARRAY_UNARY(log2, fix_log2)                                    \
+ARRAY_BLOCKS(log2, fix_log2)
 
 LOG2_TESTS
 
@@ -772,7 +1389,9 @@ LOG10(epsilon, FIX_EPSILON       , FIX_TEST_LOG10_epsilon)                  \
 LOG10(max    , FIX_MAX           , FIX_TEST_LOG10_max )                     \
 LOG10(inf    , FIX_INF_POS       , FIX_INF_POS)                             \
 LOG10(neg    , FIXNUM(-1,0)      , FIX_NAN)                                 \
-LOG10(nan    , FIX_NAN           , FIX_NAN)
+LOG10(nan    , FIX_NAN           , FIX_NAN)                                 \
+ARRAY_UNARY(log10, fix_log10)                                               \
+ARRAY_BLOCKS(log10, fix_log10)
 
 LOG10_TESTS
 
@@ -792,6 +1411,79 @@ TEST_HELPER(exp_##name, { \
 };)
 /* Make sure we get the top 54 bits of expected right */
 
+/* Inputs near -2 still need the last terms of the Taylor series, out to 1/25!.
+ * Compare those to within a couple of epsilon. */
+#define EXP_TAIL(name, cond, op1, result) \
+TEST_HELPER(exp_tail_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed exp = fix_exp(op1); \
+  CHECK_DIFFERENCE(#name, exp, result, 2 * FIX_EPSILON); \
+};)
+
+/* Runs the stages that fix_exp_array and the log arrays hand to AVX2 directly,
+ * on arbitrary operands, against the scalar helpers in internal.h. Rounding
+ * the result to a fixed hides most slips in them, so checking the whole
+ * functions isn't enough. Skipped where the CPU can't run them. */
+#if FIX_X86_SIMD
+#define EXP_LOG_KERNELS \
+TEST_HELPER(exp_log_kernels, { \
+  if(!fix_cpu_has_avx2()) { \
+    skip(); \
+  } \
+  fix_internal coefs[26]; \
+  fix_internal x[1003]; \
+  fix_internal out[1003]; \
+  uint64_t overflow[1003]; \
+  uint64_t rshift[1003]; \
+  int64_t rint_bits[1003]; \
+  uint64_t squarings[1003]; \
+  size_t n = sizeof(x) / sizeof(x[0]); \
+  uint64_t r = 0x9e3779b97f4a7c15ull; \
+  for(size_t k = 0; k < 26; k++) { \
+    test_next_rand(&r); \
+    coefs[k] = ((int64_t) r) >> (4 + r % 8); \
+  } \
+  for(size_t i = 0; i < n; i++) { \
+    test_next_rand(&r); \
+    x[i] = i % 7 == 0 ? r : ((int64_t) r) >> 2; \
+    rshift[i] = r | FIX_TOP_BIT_MASK; \
+    rint_bits[i] = ((int64_t) (r % 9)) - 4; \
+    squarings[i] = (r >> 8) % 8; \
+  } \
+  for(int degree = 1; degree <= 25; degree += 24) { \
+    fix_intern_poly_array_avx2(out, overflow, x, coefs, degree, n); \
+    for(size_t i = 0; i < n; i++) { \
+      uint8_t ovf = 0; \
+      CHECK_INT_EQUAL("poly", out[i], fix_intern_poly(x[i], coefs, degree, &ovf)); \
+      CHECK_INT_EQUAL("poly overflow", overflow[i], ovf); \
+    } \
+  } \
+  fix_exp_series_array_avx2(out, overflow, x, coefs, 26, n); \
+  for(size_t i = 0; i < n; i++) { \
+    uint8_t ovf = 0; \
+    CHECK_INT_EQUAL("series", out[i], fix_exp_series(x[i], coefs, 26, &ovf)); \
+    CHECK_INT_EQUAL("series overflow", overflow[i], ovf); \
+  } \
+  uint64_t rshift2[1003]; \
+  int64_t rint_bits2[1003]; \
+  memcpy(rshift2, rshift, sizeof(rshift)); \
+  memcpy(rint_bits2, rint_bits, sizeof(rint_bits)); \
+  fix_exp_square_array_avx2(rshift2, rint_bits2, squarings, 6, n); \
+  for(size_t i = 0; i < n; i++) { \
+    fix_exp_square(&rshift[i], &rint_bits[i], squarings[i], 6); \
+    CHECK_INT_EQUAL("square", rshift2[i], rshift[i]); \
+    CHECK_INT_EQUAL("square bits", rint_bits2[i], rint_bits[i]); \
+  } \
+};)
+#else
+#define EXP_LOG_KERNELS \
+TEST_HELPER(exp_log_kernels, { \
+  skip(); \
+};)
+#endif
+
 #define EXP_TESTS                                                                                         \
 EXP(zero      , FIX_ZERO        , FIXNUM(1,0))                                                            \
 EXP(half      , FIXNUM(0,5)     , FIXNUM(1,648721270700128146848650787814163571653776100710148011575079)) \
@@ -813,12 +1505,101 @@ EXP(forty     , FIXNUM(40,0)    , FIXNUM(235385266837019985,40789991074903480450
 EXP(max       , FIX_MAX         , FIX_INF_POS)                                                            \
 EXP(nan       , FIX_NAN         , FIX_NAN)                                                                \
 EXP(inf       , FIX_INF_POS     , FIX_INF_POS)                                                            \
-EXP(inf_neg   , FIX_INF_NEG     , FIX_ZERO)
+EXP(inf_neg   , FIX_INF_NEG     , FIX_ZERO)                                                               \
+EXP_TAIL(two_neg, FIX_INT_BITS >= 2, FIXNUM(-1,984375), FIXNUM(0,137466503838519445278224834719156))      \
+ARRAY_UNARY(exp, fix_exp)                                                                                 \
+ARRAY_BLOCKS(exp, fix_exp)                                                                                \
+EXP_LOG_KERNELS
 
 EXP_TESTS
 
 //////////////////////////////////////////////////////////////////////////////
 
+/* Small arguments should come back with full relative accuracy, so compare
+ * those to within a few epsilon. */
+#define EXPM1(name, op1, result, bound) \
+TEST_HELPER(expm1_##name, { \
+  fixed o1 = op1; \
+  fixed fexpm1 = fix_expm1(o1); \
+  fixed expected = result; \
+  CHECK_DIFFERENCE(#name, fexpm1, expected, (FIX_DATA_BITS(fix_abs(expected) >> 54) | (bound))); \
+};)
+
+/* e^x doesn't fit here, but e^x - 1 does. */
+#define EXPM1_EDGE fix_convert_from_double(log(fix_convert_to_double(FIX_MAX) + 0.75))
+#define EXPM1_DBL(x) fix_convert_from_double(expm1(fix_convert_to_double(x)))
+
+#define EXPM1_TESTS                                                                                   \
+EXPM1(zero     , FIX_ZERO          , FIX_ZERO                                           , FIX_EPSILON) \
+EXPM1(tiny     , FIXNUM(0,000001)  , FIXNUM(0,000001000000500000166666708333341666)     , FIX_EPSILON) \
+EXPM1(tiny_neg , FIXNUM(-0,000001) , FIXNUM(-0,000000999999500000166666625000008333)    , FIX_EPSILON) \
+EXPM1(epsilon  , FIX_EPSILON       , FIX_EPSILON                                        , FIX_EPSILON) \
+EXPM1(half     , FIXNUM(0,5)       , FIXNUM(0,648721270700128146848650787814163571)     , FIX_EPSILON) \
+EXPM1(half_neg , FIXNUM(-0,5)      , FIXNUM(-0,393469340287366576396200465008819546)    , FIX_EPSILON) \
+EXPM1(one      , FIXNUM(1,0)       , FIX_INT_BITS >= 2 ?                                               \
+                                       FIXNUM(1,718281828459045235360287471352662497) :                \
+                                       FIX_INF_POS                                      , FIX_EPSILON) \
+EXPM1(two      , FIXNUM(2,0)       , FIX_INT_BITS >= 4 ?                                               \
+                                       FIXNUM(6,389056098930650227230427460575007813) :                \
+                                       FIX_INF_POS                                      , FIX_EPSILON) \
+EXPM1(two_neg  , FIXNUM(-2,0)      , FIX_INT_BITS >= 2 ?                                               \
+                                       FIXNUM(-0,864664716763387308106000505027515596) :               \
+                                       FIXNUM(-1,0)                                     , FIX_EPSILON) \
+EXPM1(ten      , FIXNUM(10,0)      , FIX_INT_BITS >= 16 ?                                              \
+                                       FIXNUM(22025,46579480671651695790064528424436) :                \
+                                       FIX_INF_POS                                      , FIX_EPSILON) \
+EXPM1(edge     , EXPM1_EDGE        , EXPM1_DBL(EXPM1_EDGE)                              ,              \
+        FIX_DATA_BITS(EXPM1_DBL(EXPM1_EDGE) >> 50))                                                   \
+EXPM1(neg_many , FIXNUM(-128,0)    , FIXNUM(-1,0)                                       , FIX_EPSILON) \
+EXPM1(max      , FIX_MAX           , FIX_INF_POS                                        , FIX_EPSILON) \
+EXPM1(nan      , FIX_NAN           , FIX_NAN                                            , FIX_EPSILON) \
+EXPM1(inf      , FIX_INF_POS       , FIX_INF_POS                                        , FIX_EPSILON) \
+EXPM1(inf_neg  , FIX_INF_NEG       , FIXNUM(-1,0)                                       , FIX_EPSILON) \
+ARRAY_UNARY(expm1, fix_expm1)
+
+EXPM1_TESTS
+
+//////////////////////////////////////////////////////////////////////////////
+
+#define LOG1P(name, op1, result, bound) \
+TEST_HELPER(log1p_##name, { \
+  fixed o1 = op1; \
+  fixed flog1p = fix_log1p(o1); \
+  fixed expected = result; \
+  CHECK_DIFFERENCE(#name, flog1p, expected, bound); \
+};)
+
+#define LOG1P_BOUND (FIXNUM(0,000000000000004) | FIX_EPSILON)
+
+#define LOG1P_TESTS                                                                                  \
+LOG1P(zero     , FIX_ZERO          , FIX_ZERO                                          , FIX_EPSILON) \
+LOG1P(tiny     , FIXNUM(0,000001)  , FIXNUM(0,000000999999500000333333083333533333)    , FIX_EPSILON) \
+LOG1P(tiny_neg , FIXNUM(-0,000001) , FIXNUM(-0,000001000000500000333333583333533333)   , FIX_EPSILON) \
+LOG1P(epsilon  , FIX_EPSILON       , FIX_EPSILON                                       , FIX_EPSILON) \
+LOG1P(half     , FIXNUM(0,5)       , FIXNUM(0,405465108108164381978013115464349136)    , LOG1P_BOUND) \
+LOG1P(half_neg , FIXNUM(-0,5)      , FIXNUM(-0,693147180559945309417232121458176568)   , LOG1P_BOUND) \
+LOG1P(quarter_neg, FIXNUM(-0,25)   , FIXNUM(-0,287682072451780927439219005993827431)   , LOG1P_BOUND) \
+LOG1P(one      , FIXNUM(1,0)       , FIX_INT_BITS >= 2 ?                                              \
+                                       FIXNUM(0,693147180559945309417232121458176568) :               \
+                                       FIX_INF_POS                                     , LOG1P_BOUND) \
+LOG1P(ten      , FIXNUM(10,0)      , FIX_INT_BITS >= 5 ?                                              \
+                                       FIXNUM(2,397895272798370544061943577965129299) :               \
+                                       FIX_INF_POS                                     , LOG1P_BOUND) \
+LOG1P(max      , FIX_MAX           ,                                                                  \
+        fix_convert_from_double(log1p(fix_convert_to_double(FIX_MAX)))                 ,              \
+        FIX_DATA_BITS(fix_abs(fix_convert_from_double(log1p(fix_convert_to_double(FIX_MAX)))) >> 50) \
+          | LOG1P_BOUND)                                                                             \
+LOG1P(neg_one  , FIXNUM(-1,0)      , FIX_INF_NEG                                       , FIX_EPSILON) \
+LOG1P(neg_two  , FIXNUM(-2,0)      , FIX_NAN                                           , FIX_EPSILON) \
+LOG1P(nan      , FIX_NAN           , FIX_NAN                                           , FIX_EPSILON) \
+LOG1P(inf      , FIX_INF_POS       , FIX_INF_POS                                       , FIX_EPSILON) \
+LOG1P(inf_neg  , FIX_INF_NEG       , FIX_NAN                                           , FIX_EPSILON) \
+ARRAY_UNARY(log1p, fix_log1p)
+
+LOG1P_TESTS
+
+//////////////////////////////////////////////////////////////////////////////
+
 // Sometimes we compute results with doubles, and those results can be wrong due
 // to double's 53-bit precision. Set a pretty high difference when comparing the
 // sqrt results, but re-check by computing the square of the sqrt.
@@ -868,6 +1649,77 @@ SQRT_TESTS
 
 //////////////////////////////////////////////////////////////////////////////
 
+/* Make sure we get the top 56 bits of expected right. Expected values computed
+ * with doubles only have 53 bits to begin with, so check fewer there. */
+#define CBRT(name, op1, result, bits) \
+TEST_HELPER(cbrt_##name, { \
+  fixed o1 = op1; \
+  fixed fcbrt = fix_cbrt(o1); \
+  fixed expected = result; \
+  CHECK_DIFFERENCE(#name, fcbrt, expected, FIX_DATA_BITS(fix_abs(expected) >> (bits)) | FIX_EPSILON); \
+};)
+
+#define CBRT_DBL(x) fix_convert_from_double(cbrt(fix_convert_to_double(x)))
+
+#define CBRT_TESTS                                                                                       \
+CBRT(zero     , FIX_ZERO     , FIX_ZERO                                                         , 56)    \
+CBRT(half     , FIXNUM(0,5)  , FIXNUM(0,7937005259840997373758528196361541301957466639499)      , 56)    \
+CBRT(half_neg , FIXNUM(-0,5) , FIXNUM(-0,7937005259840997373758528196361541301957466639499)     , 56)    \
+CBRT(one      , FIXNUM(1,0)  , FIXNUM(1,0)                                                      , 56)    \
+CBRT(one_neg  , FIXNUM(-1,0) , FIXNUM(-1,0)                                                     , 56)    \
+CBRT(two      , FIXNUM(2,0)  , FIX_INT_BITS >= 3 ? FIXNUM(1,2599210498948731647672106072782) :         \
+                                                   FIX_INF_POS                                  , 56)    \
+CBRT(eight_neg, FIXNUM(-8,0) , FIX_INT_BITS >= 4 ? FIXNUM(-2,0) : FIX_INF_NEG                   , 56)    \
+CBRT(ten      , FIXNUM(10,0) , FIX_INT_BITS >= 5 ? FIXNUM(2,1544346900318837217592935665194) :         \
+                                                   FIX_INF_POS                                  , 56)    \
+CBRT(thousand , FIXNUM(1000,0), FIX_INT_BITS >= 11 ? FIXNUM(10,0) : FIX_INF_POS                 , 56)    \
+CBRT(epsilon  , FIX_EPSILON  , CBRT_DBL(FIX_EPSILON)                                            , 50)    \
+CBRT(max      , FIX_MAX      , FIX_INT_BITS == 1 ? FIX_MAX : CBRT_DBL(FIX_MAX)                  , 50)    \
+CBRT(min      , FIX_MIN      , CBRT_DBL(FIX_MIN)                                                , 50)    \
+CBRT(inf      , FIX_INF_POS  , FIX_INF_POS                                                      , 56)    \
+CBRT(inf_neg  , FIX_INF_NEG  , FIX_INF_NEG                                                      , 56)    \
+CBRT(nan      , FIX_NAN      , FIX_NAN                                                          , 56)
+CBRT_TESTS
+
+//////////////////////////////////////////////////////////////////////////////
+
+/* hypot is correctly rounded, so most of these are exact to within FIX_EPSILON. */
+#define HYPOT(name, op1, op2, result, bound) \
+TEST_HELPER(hypot_##name, { \
+  fixed o1 = op1; \
+  fixed o2 = op2; \
+  fixed fhypot = fix_hypot(o1, o2); \
+  fixed expected = result; \
+  CHECK_DIFFERENCE(#name, fhypot, expected, bound); \
+};)
+
+#define HALF_MAX FIX_DATA_BITS(FIX_MAX >> 1)
+
+#define HYPOT_TESTS                                                                                 \
+HYPOT(zero    , FIX_ZERO    , FIX_ZERO    , FIX_ZERO                                  , FIX_EPSILON) \
+HYPOT(half    , FIXNUM(0,5) , FIX_ZERO    , FIXNUM(0,5)                               , FIX_EPSILON) \
+HYPOT(half_neg, FIX_ZERO    , FIXNUM(-0,5), FIXNUM(0,5)                               , FIX_EPSILON) \
+HYPOT(halves  , FIXNUM(0,5) , FIXNUM(-0,5), FIXNUM(0,70710678118654752440084436210485), FIX_EPSILON) \
+HYPOT(ones    , FIXNUM(1,0) , FIXNUM(1,0) , FIX_INT_BITS >= 2 ?                                      \
+                                              FIXNUM(1,41421356237309504880168872420970) :           \
+                                              FIX_INF_POS                             , FIX_EPSILON) \
+HYPOT(three4  , FIXNUM(3,0) , FIXNUM(-4,0), FIX_INT_BITS >= 4 ? FIXNUM(5,0) :                        \
+                                              FIX_INF_POS                             , FIX_EPSILON) \
+HYPOT(epsilon , FIX_EPSILON , FIX_EPSILON , FIX_EPSILON                               , FIX_EPSILON) \
+HYPOT(max     , FIX_MAX     , FIX_ZERO    , FIX_MAX                                   , FIX_EPSILON) \
+HYPOT(max_max , FIX_MAX     , FIX_MAX     , FIX_INF_POS                               , FIX_EPSILON) \
+HYPOT(min     , FIX_MIN     , FIX_ZERO    , FIX_INF_POS                               , FIX_EPSILON) \
+HYPOT(half_max, HALF_MAX    , HALF_MAX    ,                                                          \
+        fix_convert_from_double(fix_convert_to_double(HALF_MAX) * sqrt(2.)),                         \
+        FIX_DATA_BITS(HALF_MAX >> 50) | FIX_EPSILON)                                                 \
+HYPOT(inf     , FIX_INF_POS , FIXNUM(0,5) , FIX_INF_POS                               , FIX_EPSILON) \
+HYPOT(inf_neg , FIXNUM(0,5) , FIX_INF_NEG , FIX_INF_POS                               , FIX_EPSILON) \
+HYPOT(nan     , FIX_NAN     , FIX_INF_POS , FIX_NAN                                   , FIX_EPSILON) \
+HYPOT(nan2    , FIXNUM(0,5) , FIX_NAN     , FIX_NAN                                   , FIX_EPSILON)
+HYPOT_TESTS
+
+//////////////////////////////////////////////////////////////////////////////
+
 #define POW(name, op1, op2, result, bitaccuracy) \
 TEST_HELPER(pow_##name, { \
   fixed o1 = op1; \
@@ -1004,19 +1856,24 @@ POW_TESTS
 #define TRIG(name, op1, sinx, cosx, tanx, bounds) \
 TEST_HELPER(trig_##name, { \
   fixed o1 = op1; \
-  fixed sin = fix_sin(o1); \
+  fixed sinval = fix_sin(o1); \
   fixed sinresult = sinx; \
   fixed cosresult = cosx; \
   fixed tanresult = tanx; \
   if(FIX_IS_INF_POS(op1) | FIX_IS_INF_NEG(op1)) { \
     sinresult = cosresult = tanresult = FIX_NAN; \
   } \
-  CHECK_DIFFERENCE(#name " sin", sin, sinresult, bounds); \
-  fixed cos = fix_cos(o1); \
-  CHECK_DIFFERENCE(#name " cos", cos, cosresult, bounds); \
+  CHECK_DIFFERENCE(#name " sin", sinval, sinresult, bounds); \
+  fixed cosval = fix_cos(o1); \
+  CHECK_DIFFERENCE(#name " cos", cosval, cosresult, bounds); \
+  fixed sc_sin; \
+  fixed sc_cos; \
+  fix_sincos(o1, &sc_sin, &sc_cos); \
+  CHECK_DIFFERENCE(#name " sincos sin", sc_sin, sinresult, bounds); \
+  CHECK_DIFFERENCE(#name " sincos cos", sc_cos, cosresult, bounds); \
   if(!FIX_IS_NAN(tanx)) { \
-    fixed tan = fix_tan(o1); \
-    CHECK_DIFFERENCE(#name " tan", tan, tanresult, bounds); \
+    fixed tanval = fix_tan(o1); \
+    CHECK_DIFFERENCE(#name " tan", tanval, tanresult, bounds); \
   }\
 };)
 
@@ -1025,6 +1882,11 @@ TEST_HELPER(trig_##name, { \
 
 #define err2_57 (FIXNUM(0,000000000000000006938893903907228377647697925567626953125) | FIX_EPSILON)
 
+// An angle whose tan is just under FIX_MAX. It's capped at 16, since near the
+// pole tan magnifies the error in the angle by tan^2.
+#define TAN_EDGE fix_convert_from_double(atan(0.99 * fmin(fix_convert_to_double(FIX_MAX), 16)))
+#define TRIG_DBL(f, x) fix_convert_from_double(f(fix_convert_to_double(x)))
+
 #define TRIG_TESTS                                                                                             \
 TRIG(zero      , FIX_ZERO                             , FIX_ZERO     ,                                         \
                    FIX_INT_BITS!=1? FIXNUM(1,0) : FIXNUM( 0,999999999999999999132638262), FIX_NAN , err2_57)   \
@@ -1063,13 +1925,264 @@ TRIG(q4        , FIXNUM(-0,5),
                              FIXNUM(-0,546302489843790513255179465780285383297551720179791246164),             \
                              2*err2_57)                                                                        \
                                                                                                                \
+TRIG(near_max  , TAN_EDGE, TRIG_DBL(sin, TAN_EDGE), TRIG_DBL(cos, TAN_EDGE), TRIG_DBL(tan, TAN_EDGE),        \
+                 FIX_DATA_BITS(TRIG_DBL(tan, TAN_EDGE) >> 24) + (FIX_EPSILON << 8))                                                 \
+                                                                                                               \
 TRIG(inf_pos   , FIX_INF_POS, FIX_NAN, FIX_NAN, FIX_NAN, FIX_ZERO)                                             \
 TRIG(inf_neg   , FIX_INF_NEG, FIX_NAN, FIX_NAN, FIX_NAN, FIX_ZERO)                                             \
-TRIG(nan       , FIX_NAN,     FIX_NAN, FIX_NAN, FIX_NAN, FIX_ZERO)
+TRIG(nan       , FIX_NAN,     FIX_NAN, FIX_NAN, FIX_NAN, FIX_ZERO)             \
+ARRAY_UNARY(sin, fix_sin)                                                                                      \
+ARRAY_UNARY(cos, fix_cos)                                                                                      \
+ARRAY_BLOCKS(sin, fix_sin)                                                                                     \
+ARRAY_BLOCKS(cos, fix_cos)                                                                                     \
+ARRAY_SINCOS(sincos, fix_sincos)
 TRIG_TESTS
 
 //////////////////////////////////////////////////////////////////////////////
 
+/* Checks the turns versions on turns, and the pi versions on halfturns (which
+ * should be the same angle). Skipped unless cond holds, since not every build
+ * can represent every angle. */
+#define TRIG_TURNS(name, cond, turns, halfturns, sinx, cosx, tanx, bounds) \
+TEST_HELPER(trig_turns_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed t = turns; \
+  fixed h = halfturns; \
+  fixed sinresult = sinx; \
+  fixed cosresult = cosx; \
+  fixed tanresult = tanx; \
+  fixed sin = fix_sin_turns(t); \
+  CHECK_DIFFERENCE(#name " sin_turns", sin, sinresult, bounds); \
+  fixed cos = fix_cos_turns(t); \
+  CHECK_DIFFERENCE(#name " cos_turns", cos, cosresult, bounds); \
+  fixed sc_sin; \
+  fixed sc_cos; \
+  fix_sincos_turns(t, &sc_sin, &sc_cos); \
+  CHECK_DIFFERENCE(#name " sincos_turns sin", sc_sin, sinresult, bounds); \
+  CHECK_DIFFERENCE(#name " sincos_turns cos", sc_cos, cosresult, bounds); \
+  sin = fix_sinpi(h); \
+  CHECK_DIFFERENCE(#name " sinpi", sin, sinresult, bounds); \
+  cos = fix_cospi(h); \
+  CHECK_DIFFERENCE(#name " cospi", cos, cosresult, bounds); \
+  fix_sincospi(h, &sc_sin, &sc_cos); \
+  CHECK_DIFFERENCE(#name " sincospi sin", sc_sin, sinresult, bounds); \
+  CHECK_DIFFERENCE(#name " sincospi cos", sc_cos, cosresult, bounds); \
+  if(!FIX_IS_NAN(tanx)) { \
+    fixed tan = fix_tan_turns(t); \
+    CHECK_DIFFERENCE(#name " tan_turns", tan, tanresult, bounds); \
+    tan = fix_tanpi(h); \
+    CHECK_DIFFERENCE(#name " tanpi", tan, tanresult, bounds); \
+  }\
+};)
+
+#define ONE_OR_MAX (FIX_INT_BITS != 1 ? FIXNUM(1,0) : FIX_MAX)
+#define SQRT1_2 FIXNUM(0,70710678118654752440084436210484903928483593768847)
+
+#define TRIG_TURNS_TESTS                                                                          \
+TRIG_TURNS(zero      , 1, FIX_ZERO, FIX_ZERO, FIX_ZERO, ONE_OR_MAX, FIX_ZERO, err2_57)             \
+TRIG_TURNS(sixteenth , FIX_FRAC_BITS >= 4, FIXNUM(0,0625), FIXNUM(0,125),                         \
+    FIXNUM(0,38268343236508977172845998403039886676134456248563),                                 \
+    FIXNUM(0,92387953251128675612818318939678828682241662586364),                                 \
+    FIXNUM(0,41421356237309504880168872420969807856967187537694), 2*err2_57)                      \
+TRIG_TURNS(eighth    , FIX_FRAC_BITS >= 3, FIXNUM(0,125), FIXNUM(0,25), SQRT1_2, SQRT1_2,         \
+    FIX_INT_BITS != 1 ? FIXNUM(1,0) : FIX_NAN, 2*err2_57)                                         \
+TRIG_TURNS(quarter   , FIX_FRAC_BITS >= 2, FIXNUM(0,25), FIXNUM(0,5), ONE_OR_MAX, FIX_ZERO,       \
+    FIX_INF_POS, err2_57)                                                                         \
+TRIG_TURNS(half      , FIX_INT_BITS >= 2, FIXNUM(0,5), FIXNUM(1,0), FIX_ZERO, FIXNUM(-1,0),      \
+    FIX_ZERO, err2_57)                                                                            \
+TRIG_TURNS(three_q   , FIX_INT_BITS >= 2 && FIX_FRAC_BITS >= 2, FIXNUM(0,75), FIXNUM(1,5),       \
+    FIXNUM(-1,0), FIX_ZERO, FIX_INF_NEG, err2_57)                                                 \
+TRIG_TURNS(neg_q     , FIX_FRAC_BITS >= 2, FIXNUM(-0,25), FIXNUM(-0,5), FIXNUM(-1,0), FIX_ZERO,  \
+    FIX_INF_NEG, err2_57)                                                                         \
+TRIG_TURNS(full      , FIX_INT_BITS >= 3, FIXNUM(1,0), FIXNUM(2,0), FIX_ZERO, FIXNUM(1,0),       \
+    FIX_ZERO, err2_57)                                                                            \
+TRIG_TURNS(many      , FIX_INT_BITS >= 13 && FIX_FRAC_BITS >= 3, FIXNUM(1000,125),               \
+    FIXNUM(2000,25), SQRT1_2, SQRT1_2, FIXNUM(1,0), 2*err2_57)                                   \
+TRIG_TURNS(neg_many  , FIX_INT_BITS >= 13 && FIX_FRAC_BITS >= 3, FIXNUM(-1000,125),              \
+    FIXNUM(-2000,25), FIXNUM(-0,70710678118654752440084436210484903928483593768847), SQRT1_2,    \
+    FIXNUM(-1,0), 2*err2_57)                                                                      \
+TRIG_TURNS(inf_pos   , 1, FIX_INF_POS, FIX_INF_POS, FIX_NAN, FIX_NAN, FIX_NAN, FIX_ZERO)          \
+TRIG_TURNS(inf_neg   , 1, FIX_INF_NEG, FIX_INF_NEG, FIX_NAN, FIX_NAN, FIX_NAN, FIX_ZERO)          \
+TRIG_TURNS(nan       , 1, FIX_NAN, FIX_NAN, FIX_NAN, FIX_NAN, FIX_NAN, FIX_ZERO)                  \
+ARRAY_UNARY(sin_turns, fix_sin_turns)                                                             \
+ARRAY_BLOCKS(sin_turns, fix_sin_turns)                                                            \
+ARRAY_UNARY(cos_turns, fix_cos_turns)                                                             \
+ARRAY_UNARY(tan_turns, fix_tan_turns)                                                             \
+ARRAY_SINCOS(sincos_turns, fix_sincos_turns)                                                      \
+ARRAY_UNARY(sinpi, fix_sinpi)                                                                     \
+ARRAY_UNARY(cospi, fix_cospi)                                                                     \
+ARRAY_BLOCKS(cospi, fix_cospi)                                                                    \
+ARRAY_UNARY(tanpi, fix_tanpi)                                                                     \
+ARRAY_SINCOS(sincospi, fix_sincospi)
+TRIG_TURNS_TESTS
+
+//////////////////////////////////////////////////////////////////////////////
+
+/* Checks erf, erfc and the normal CDF together. Skipped unless cond holds,
+ * since not every build can represent every input. */
+#define ERF(name, cond, op1, erfx, erfcx, cdfx, bounds) \
+TEST_HELPER(erf_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed o1 = op1; \
+  fixed erfresult = erfx; \
+  fixed erfcresult = erfcx; \
+  fixed cdfresult = cdfx; \
+  CHECK_DIFFERENCE(#name " erf", fix_erf(o1), erfresult, bounds); \
+  CHECK_DIFFERENCE(#name " erfc", fix_erfc(o1), erfcresult, bounds); \
+  CHECK_DIFFERENCE(#name " norm_cdf", fix_norm_cdf(o1), cdfresult, bounds); \
+};)
+
+#define TWO_OR_MAX (FIX_INT_BITS >= 3 ? FIXNUM(2,0) : FIX_MAX)
+
+#define ERF_TESTS                                                                                 \
+ERF(zero     , 1, FIX_ZERO, FIX_ZERO, ONE_OR_MAX, FIXNUM(0,5), err2_57)                         \
+ERF(half     , 1, FIXNUM(0,5),                                                                   \
+    FIXNUM(0,5204998778130465376827466538919645287365),                                         \
+    FIXNUM(0,4795001221869534623172533461080354712635),                                         \
+    FIXNUM(0,6914624612740131036377046106083377398836), err2_57)                                \
+ERF(neg_half , 1, FIXNUM(-0,5),                                                                  \
+    FIXNUM(-0,5204998778130465376827466538919645287365),                                        \
+    FIX_INT_BITS >= 2 ? FIXNUM(1,520499877813046537682746653891964528736) : FIX_MAX,            \
+    FIXNUM(0,3085375387259868963622953893916622601164), err2_57)                                \
+ERF(one_half , FIX_INT_BITS >= 2, FIXNUM(1,5),                                                   \
+    FIXNUM(0,9661051464753107270669762616459478586814),                                         \
+    FIXNUM(0,03389485352468927293302373835405214131859),                                        \
+    FIXNUM(0,9331927987311419339955059590201139204771), err2_57)                                \
+ERF(neg_two  , FIX_INT_BITS >= 2, FIXNUM(-2,0),                                                  \
+    FIXNUM(-0,9953222650189527341620692563672529286109),                                        \
+    FIXNUM(1,995322265018952734162069256367252928611),                                          \
+    FIXNUM(0,02275013194817920720028263716653343747178), err2_57)                               \
+ERF(three    , FIX_INT_BITS >= 3, FIXNUM(3,0),                                                   \
+    FIXNUM(0,9999779095030014145586272238704176796202),                                         \
+    FIXNUM(0,00002209049699858544137277612958232037984771),                                     \
+    FIXNUM(0,9986501019683699054733481852324050226222), err2_57)                                \
+ERF(six_half , FIX_INT_BITS >= 4, FIXNUM(6,5), FIXNUM(1,0), FIX_ZERO,                            \
+    FIXNUM(0,999999999959839994161408821916538545776), err2_57)                                 \
+ERF(neg_eight, FIX_INT_BITS == 4, FIX_MIN, FIXNUM(-1,0), FIXNUM(2,0),                            \
+    FIXNUM(0,0000000000000006220960574271784123515995172588188422489), err2_57)                 \
+ERF(nine     , FIX_INT_BITS >= 5, FIXNUM(9,0), FIXNUM(1,0), FIX_ZERO, FIXNUM(1,0), err2_57)     \
+ERF(big      , FIX_INT_BITS >= 6, FIXNUM(20,0), FIXNUM(1,0), FIX_ZERO, FIXNUM(1,0), err2_57)    \
+ERF(min      , FIX_INT_BITS >= 5, FIX_MIN, FIXNUM(-1,0), FIXNUM(2,0), FIX_ZERO, err2_57)        \
+ERF(inf_pos  , 1, FIX_INF_POS, ONE_OR_MAX, FIX_ZERO, ONE_OR_MAX, FIX_ZERO)                       \
+ERF(inf_neg  , 1, FIX_INF_NEG, FIXNUM(-1,0), TWO_OR_MAX, FIX_ZERO, FIX_ZERO)                     \
+ERF(nan      , 1, FIX_NAN, FIX_NAN, FIX_NAN, FIX_NAN, FIX_ZERO)                                  \
+ARRAY_UNARY(erf, fix_erf)                                                                         \
+ARRAY_UNARY(erfc, fix_erfc)                                                                       \
+ARRAY_UNARY(norm_cdf, fix_norm_cdf)
+ERF_TESTS
+
+#define err2_48 (FIXNUM(0,000000000000003552713678800500929355621337890625) | FIX_EPSILON)
+
+#define PPF(name, cond, op1, result, bounds) \
+TEST_HELPER(norm_ppf_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed o1 = op1; \
+  fixed expected = result; \
+  CHECK_DIFFERENCE(#name " norm_ppf", fix_norm_ppf(o1), expected, bounds); \
+};)
+
+#define PPF_TESTS                                                                                 \
+PPF(half     , 1, FIXNUM(0,5), FIX_ZERO, FIX_ZERO)                                               \
+PPF(central  , FIX_FRAC_BITS >= 2, FIXNUM(0,75),                                                 \
+    FIXNUM(0,6744897501960817432022270145413071853869), err2_48)                                 \
+PPF(neg_cent , FIX_FRAC_BITS >= 2, FIXNUM(0,25),                                                 \
+    FIXNUM(-0,6744897501960817432022270145413071853869), err2_48)                                \
+PPF(tail     , FIX_INT_BITS >= 2 && FIX_FRAC_BITS >= 5, FIXNUM(0,96875),                         \
+    FIXNUM(1,862731867421651455487680978558201086103), err2_48)                                  \
+PPF(neg_tail , FIX_INT_BITS >= 3 && FIX_FRAC_BITS >= 10, FIXNUM(0,0009765625),                   \
+    FIXNUM(-3,097269078198784462364830497055253410762), err2_48)                                 \
+PPF(far      , FIX_INT_BITS >= 4 && FIX_FRAC_BITS >= 40,                                         \
+    FIXNUM(0,0000000000009094947017729282379150390625),                                          \
+    FIXNUM(-7,047700256664408725350992306698602584707), err2_48)                                 \
+PPF(past_8   , FIX_INT_BITS >= 5 && FIX_FRAC_BITS >= 55,                                         \
+    FIXNUM(0,0000000000000000277555756156289135105907917022705078125),                           \
+    FIXNUM(-8,374388923067456451026748923630998487032), err2_48)                                 \
+PPF(ovf_neg  , FIX_INT_BITS == 4,                                                                \
+    FIXNUM(0,0000000000000000277555756156289135105907917022705078125), FIX_INF_NEG, FIX_ZERO)    \
+PPF(ovf_pos  , FIX_INT_BITS == 1, FIXNUM(0,9), FIX_INF_POS, FIX_ZERO)                            \
+PPF(zero     , 1, FIX_ZERO, FIX_INF_NEG, FIX_ZERO)                                               \
+PPF(one      , FIX_INT_BITS >= 2, FIXNUM(1,0), FIX_INF_POS, FIX_ZERO)                            \
+PPF(above_one, FIX_INT_BITS >= 2, FIXNUM(1,5), FIX_NAN, FIX_ZERO)                                \
+PPF(neg      , 1, FIXNUM(-0,5), FIX_NAN, FIX_ZERO)                                               \
+PPF(inf_pos  , 1, FIX_INF_POS, FIX_NAN, FIX_ZERO)                                                \
+PPF(inf_neg  , 1, FIX_INF_NEG, FIX_NAN, FIX_ZERO)                                                \
+PPF(nan      , 1, FIX_NAN, FIX_NAN, FIX_ZERO)                                                    \
+ARRAY_UNARY(norm_ppf, fix_norm_ppf)
+PPF_TESTS
+
+#define err2_43 (FIXNUM(0,0000000000001136868377216160297393798828125) | FIX_EPSILON)
+
+#define LGAMMA(name, cond, op1, result, bounds) \
+TEST_HELPER(lgamma_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed o1 = op1; \
+  fixed expected = result; \
+  CHECK_DIFFERENCE(#name " lgamma", fix_lgamma(o1), expected, bounds); \
+};)
+
+#define LBETA(name, cond, op1, op2, result, bounds) \
+TEST_HELPER(lbeta_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed o1 = op1; \
+  fixed o2 = op2; \
+  fixed expected = result; \
+  CHECK_DIFFERENCE(#name " lbeta", fix_lbeta(o1, o2), expected, bounds); \
+};)
+
+#define LGAMMA_TESTS                                                                              \
+LGAMMA(half     , 1, FIXNUM(0,5), FIXNUM(0,5723649429247000870717136756765293558236), err2_43)    \
+LGAMMA(quarter  , FIX_INT_BITS >= 2 && FIX_FRAC_BITS >= 2, FIXNUM(0,25),                          \
+       FIXNUM(1,288022524698077457370610440219717295925), err2_43)                                \
+LGAMMA(one      , FIX_INT_BITS >= 2, FIXNUM(1,0), FIX_ZERO, err2_43)                              \
+LGAMMA(two      , FIX_INT_BITS >= 3, FIXNUM(2,0), FIX_ZERO, err2_43)                              \
+LGAMMA(tiny     , FIX_INT_BITS >= 5 && FIX_FRAC_BITS >= 20, FIXNUM(0,00000095367431640625),       \
+       FIXNUM(13,8629430607238995734579633369200890124), err2_43)                                 \
+LGAMMA(ten      , FIX_INT_BITS >= 5, FIXNUM(10,0),                                                \
+       FIXNUM(12,80182748008146961120771787456670616428), err2_43)                                \
+LGAMMA(below_16 , FIX_INT_BITS >= 6, FIXNUM(15,5),                                                \
+       FIXNUM(26,53691449111561362395295450243873219064), err2_43)                                \
+LGAMMA(sixteen  , FIX_INT_BITS >= 6, FIXNUM(16,0),                                                \
+       FIXNUM(27,89927138384089156608943926367046675919), err2_43)                                \
+LGAMMA(thousand , FIX_INT_BITS >= 14, FIXNUM(1000,0),                                             \
+       FIXNUM(5905,220423209181211826076912361440789849), FIXNUM(0,000000001) | FIX_EPSILON)      \
+LGAMMA(huge     , FIX_INT_BITS >= 47, FIXNUM(1099511627776,0),                                    \
+       FIXNUM(29385423763643,47400703708071470119911783), FIXNUM(1,0))                            \
+LGAMMA(overflow , FIX_INT_BITS == 5, FIXNUM(12,0), FIX_INF_POS, FIX_ZERO)                         \
+LGAMMA(zero     , 1, FIX_ZERO, FIX_INF_POS, FIX_ZERO)                                             \
+LGAMMA(neg      , 1, FIXNUM(-0,5), FIX_NAN, FIX_ZERO)                                             \
+LGAMMA(inf_pos  , 1, FIX_INF_POS, FIX_INF_POS, FIX_ZERO)                                          \
+LGAMMA(inf_neg  , 1, FIX_INF_NEG, FIX_NAN, FIX_ZERO)                                              \
+LGAMMA(nan      , 1, FIX_NAN, FIX_NAN, FIX_ZERO)                                                  \
+ARRAY_UNARY(lgamma, fix_lgamma)                                                                   \
+LBETA(halves    , FIX_INT_BITS >= 2, FIXNUM(0,5), FIXNUM(0,5),                                    \
+      FIXNUM(1,144729885849400174143427351353058711647), err2_43)                                 \
+LBETA(two_three , FIX_INT_BITS >= 3, FIXNUM(2,0), FIXNUM(3,0),                                    \
+      FIXNUM(-2,484906649788000310229709479838878840798), err2_43)                                \
+LBETA(quarters  , FIX_INT_BITS >= 2 && FIX_FRAC_BITS >= 2, FIXNUM(0,25), FIXNUM(0,75),            \
+      FIXNUM(1,491303476129372828852043412082146995685), err2_43)                                 \
+LBETA(small     , FIX_INT_BITS >= 4 && FIX_FRAC_BITS >= 10, FIXNUM(0,0009765625), FIXNUM(3,0),    \
+      FIXNUM(6,930007557546896284087823339981103084232), err2_43)                                 \
+LBETA(thousands , FIX_INT_BITS >= 12, FIXNUM(1000,0), FIXNUM(1000,0),                             \
+      FIXNUM(-1388,482601635902250295773118820402520875), FIXNUM(0,000000001) | FIX_EPSILON)      \
+LBETA(zero      , 1, FIX_ZERO, FIXNUM(0,5), FIX_INF_POS, FIX_ZERO)                                \
+LBETA(inf       , 1, FIXNUM(0,5), FIX_INF_POS, FIX_INF_NEG, FIX_ZERO)                             \
+LBETA(zero_inf  , 1, FIX_ZERO, FIX_INF_POS, FIX_NAN, FIX_ZERO)                                    \
+LBETA(neg       , 1, FIXNUM(-0,5), FIXNUM(0,5), FIX_NAN, FIX_ZERO)                                \
+LBETA(nan       , 1, FIXNUM(0,5), FIX_NAN, FIX_NAN, FIX_ZERO)
+LGAMMA_TESTS
+
+//////////////////////////////////////////////////////////////////////////////
+
 #define PRINT(name, op1, result) \
 TEST_HELPER(print_##name, { \
   fixed o1 = op1; \
@@ -1111,6 +2224,233 @@ PRINT(nan         , FIX_NAN                   , PRINT_TEST_nan        )
 
 PRINT_TESTS
 
+/* Values that are exact as doubles print the same as printf's %f, which is
+ * exact in glibc. Unlike PRINT, these check every character in every build. */
+#define PRINT_EXACT(name, cond, op1) \
+TEST_HELPER(print_exact_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed o1 = op1; \
+  double d = fix_convert_to_double(o1); \
+  char buf[FIX_PRINT_BUFFER_SIZE]; \
+  char expected[FIX_PRINT_BUFFER_SIZE + 64]; \
+  expected[0] = d < 0 ? '-' : ' '; \
+  snprintf(expected + 1, sizeof(expected) - 1, "%0*.*f", FIX_PRINT_BUFFER_SIZE - 2, FIX_FRAC_BITS, fabs(d)); \
+  fix_sprint(buf, o1); \
+  if(strcmp(buf, expected)) { \
+    fail_msg("Strings not equal: '%s' != '%s'", buf, expected); \
+  } \
+};)
+
+#define PRINT_SPECIAL(name, op1, word) \
+TEST_HELPER(print_exact_##name, { \
+  char buf[FIX_PRINT_BUFFER_SIZE]; \
+  char expected[FIX_PRINT_BUFFER_SIZE]; \
+  memset(expected, ' ', FIX_PRINT_BUFFER_SIZE - 1); \
+  memcpy(expected, word, strlen(word)); \
+  expected[FIX_PRINT_BUFFER_SIZE - 1] = '\0'; \
+  fix_sprint(buf, op1); \
+  if(strcmp(buf, expected)) { \
+    fail_msg("Strings not equal: '%s' != '%s'", buf, expected); \
+  } \
+};)
+
+#define PRINT_EXACT_TESTS                                                 \
+PRINT_EXACT(zero       , 1                , FIX_ZERO               ) \
+PRINT_EXACT(half       , 1                , FIXNUM(0,5)            ) \
+PRINT_EXACT(half_neg   , 1                , FIXNUM(-0,5)           ) \
+PRINT_EXACT(one_quarter, FIX_INT_BITS >= 2, FIXNUM(1,25)           ) \
+PRINT_EXACT(epsilon    , 1                , FIX_EPSILON            ) \
+PRINT_EXACT(epsilon_neg, 1                , FIX_EPSILON_NEG        ) \
+PRINT_EXACT(min        , 1                , FIX_MIN                ) \
+PRINT_EXACT(max_int    , FIX_INT_BITS < 54, fix_floor(FIX_MAX)     ) \
+PRINT_SPECIAL(nan      , FIX_NAN          , " NaN"                 ) \
+PRINT_SPECIAL(inf      , FIX_INF_POS      , " Inf"                 ) \
+PRINT_SPECIAL(inf_neg  , FIX_INF_NEG      , "-Inf"                 )
+
+PRINT_EXACT_TESTS
+
+/* As PRINT_EXACT, with ndigits digits. printf rounds exactly, ties to even. */
+#define PRINT_DIGITS(name, cond, op1) \
+TEST_HELPER(print_digits_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed o1 = op1; \
+  double d = fix_convert_to_double(o1); \
+  for(int32_t ndigits = -1; ndigits <= FIX_FRAC_BITS + 2; ndigits++) { \
+    char buf[FIX_PRINT_DIGITS_BUFFER_SIZE(FIX_FRAC_BITS + 2)]; \
+    char expected[FIX_PRINT_DIGITS_BUFFER_SIZE(FIX_FRAC_BITS + 2) + 64]; \
+    int32_t n = ndigits > 0 ? ndigits : 0; \
+    expected[0] = d < 0 ? '-' : ' '; \
+    snprintf(expected + 1, sizeof(expected) - 1, "%0*.*f", FIX_PRINT_DIGITS_LENGTH(n) - 1, n, fabs(d)); \
+    fix_sprint_digits(buf, o1, ndigits); \
+    if(strcmp(buf, expected)) { \
+      fail_msg("%d digits: strings not equal: '%s' != '%s'", ndigits, buf, expected); \
+    } \
+  } \
+};)
+
+#define PRINT_DIGITS_SPECIAL(name, op1, word) \
+TEST_HELPER(print_digits_##name, { \
+  for(int32_t ndigits = 0; ndigits <= 4; ndigits++) { \
+    char buf[FIX_PRINT_DIGITS_BUFFER_SIZE(4)]; \
+    char expected[FIX_PRINT_DIGITS_BUFFER_SIZE(4)]; \
+    int length = FIX_PRINT_DIGITS_BUFFER_SIZE(ndigits) - 1; \
+    memset(expected, ' ', length); \
+    memcpy(expected, word, strlen(word)); \
+    expected[length] = '\0'; \
+    fix_sprint_digits(buf, op1, ndigits); \
+    if(strcmp(buf, expected)) { \
+      fail_msg("%d digits: strings not equal: '%s' != '%s'", ndigits, buf, expected); \
+    } \
+  } \
+};)
+
+#define PRINT_DIGITS_TESTS                                                      \
+PRINT_DIGITS(zero         , 1                 , FIX_ZERO                   ) \
+PRINT_DIGITS(half         , 1                 , FIXNUM(0,5)                ) \
+PRINT_DIGITS(half_neg     , 1                 , FIXNUM(-0,5)               ) \
+PRINT_DIGITS(eighth       , 1                 , FIXNUM(0,125)              ) \
+PRINT_DIGITS(three_eighths, 1                 , FIXNUM(-0,375)             ) \
+PRINT_DIGITS(one_half     , FIX_INT_BITS >= 2 , FIXNUM(1,5)                ) \
+PRINT_DIGITS(two_half     , FIX_INT_BITS >= 3 , FIXNUM(2,5)                ) \
+PRINT_DIGITS(nines        , FIX_INT_BITS >= 13, FIXNUM(9,9990234375)       ) \
+PRINT_DIGITS(epsilon      , 1                 , FIX_EPSILON                ) \
+PRINT_DIGITS(epsilon_neg  , 1                 , FIX_EPSILON_NEG            ) \
+PRINT_DIGITS(min          , 1                 , FIX_MIN                    ) \
+PRINT_DIGITS(max_int      , FIX_INT_BITS < 54 , fix_floor(FIX_MAX)         ) \
+PRINT_DIGITS_SPECIAL(nan    , FIX_NAN    , " NaN"                          ) \
+PRINT_DIGITS_SPECIAL(inf    , FIX_INF_POS, " Inf"                          ) \
+PRINT_DIGITS_SPECIAL(inf_neg, FIX_INF_NEG, "-Inf"                          )
+
+PRINT_DIGITS_TESTS
+
+#define PRINT_SHORTEST(name, cond, op1, result) \
+TEST_HELPER(print_shortest_##name, { \
+  if(!(cond)) { \
+    return; \
+  } \
+  fixed o1 = op1; \
+  char buf[FIX_PRINT_BUFFER_SIZE]; \
+  char fast[FIX_PRINT_BUFFER_SIZE]; \
+  fix_sprint_shortest(buf, o1); \
+  fix_sprint_shortest_fast(fast, o1); \
+  if(strcmp(buf, result)) { \
+    fail_msg("Strings not equal: '%s' != '%s'", buf, result); \
+  } \
+  if(strcmp(fast, result)) { \
+    fail_msg("Fast strings not equal: '%s' != '%s'", fast, result); \
+  } \
+};)
+
+#define PRINT_SHORTEST_TESTS                                                                      \
+PRINT_SHORTEST(zero     , 1                                      , FIX_ZERO    , "0")             \
+PRINT_SHORTEST(half     , 1                                      , FIXNUM(0,5) , "0.5")           \
+PRINT_SHORTEST(half_neg , 1                                      , FIXNUM(-0,5), "-0.5")          \
+PRINT_SHORTEST(tenth    , FIX_FRAC_BITS >= 4                                                      \
+                        , fix_div_i64(FIXNUM(0,5), 5)            , "0.1")                         \
+PRINT_SHORTEST(decimal  , FIX_INT_BITS >= 15 && FIX_FRAC_BITS >= 10                               \
+                        , fix_div_i64(fix_convert_from_int64(-12345), 1000), "-12.345")           \
+PRINT_SHORTEST(hundred  , FIX_INT_BITS >= 8, fix_convert_from_int64(100), "100")                  \
+PRINT_SHORTEST(nan      , 1, FIX_NAN    , "NaN")                                                  \
+PRINT_SHORTEST(inf      , 1, FIX_INF_POS, "Inf")                                                  \
+PRINT_SHORTEST(inf_neg  , 1, FIX_INF_NEG, "-Inf")                                                 \
+TEST_HELPER(print_shortest_round_trip, {                                                          \
+  fixed in[] = ARRAY_TEST_INPUTS;                                                                 \
+  for(size_t i = 0; i < sizeof(in) / sizeof(in[0]); i++) {                                        \
+    char buf[FIX_PRINT_BUFFER_SIZE];                                                              \
+    char fast[FIX_PRINT_BUFFER_SIZE];                                                             \
+    fixed parsed;                                                                                 \
+    fix_sprint_shortest(buf, in[i]);                                                              \
+    fix_sprint_shortest_fast(fast, in[i]);                                                        \
+    if(strcmp(buf, fast)) {                                                                       \
+      fail_msg("Fast strings not equal: '%s' != '%s'", fast, buf);                                \
+    }                                                                                             \
+    CHECK_INT_EQUAL("shortest parse return", fix_parse(buf, strlen(buf), &parsed), 0);            \
+    CHECK_EQ_NAN("shortest round trip", parsed, in[i]);                                           \
+    /* One digit fewer must not round trip. */                                                    \
+    char* point = strchr(buf, '.');                                                               \
+    if(point != NULL) {                                                                           \
+      char shorter[FIX_PRINT_BUFFER_SIZE];                                                        \
+      fix_sprint_digits(shorter, in[i], strlen(point + 1) - 1);                                   \
+      fix_parse(shorter, strlen(shorter), &parsed);                                               \
+      if(fix_eq_nan(parsed, in[i])) {                                                             \
+        fail_msg("'%s' is shorter than '%s'", shorter, buf);                                      \
+      }                                                                                           \
+    }                                                                                             \
+  }                                                                                               \
+};)
+
+PRINT_SHORTEST_TESTS
+
+/* Prints 40 elements (more than a block) with sep, and checks against the
+ * single element printer. */
+#define PRINT_ARRAY_MATCHES(array_fn, single_fn, sep) {                                           \
+  fixed in[] = ARRAY_TEST_INPUTS;                                                                 \
+  size_t nin = sizeof(in) / sizeof(in[0]);                                                        \
+  fixed xs[40];                                                                                   \
+  char out[40 * FIX_PRINT_BUFFER_SIZE];                                                           \
+  char expected[40 * FIX_PRINT_BUFFER_SIZE];                                                      \
+  size_t used = 0;                                                                                \
+  for(size_t i = 0; i < 40; i++) {                                                                \
+    char buf[FIX_PRINT_BUFFER_SIZE];                                                              \
+    xs[i] = in[i % nin];                                                                          \
+    single_fn(buf, xs[i]);                                                                        \
+    if(i > 0 && sep != 0) {                                                                       \
+      expected[used++] = sep;                                                                     \
+    }                                                                                             \
+    memcpy(expected + used, buf, strlen(buf));                                                    \
+    used += strlen(buf);                                                                          \
+  }                                                                                               \
+  expected[used] = 0;                                                                             \
+  CHECK_INT_EQUAL(#array_fn " count", array_fn(out, sizeof(out), xs, 40, sep), 40);               \
+  if(strcmp(out, expected)) {                                                                     \
+    fail_msg(#array_fn " strings not equal: '%s' != '%s'", out, expected);                        \
+  }                                                                                               \
+}
+
+#define PRINT_ARRAY_TESTS                                                                         \
+TEST_HELPER(print_array_comma, {                                                                  \
+  PRINT_ARRAY_MATCHES(fix_sprint_array, fix_sprint, ',');                                         \
+  PRINT_ARRAY_MATCHES(fix_sprint_shortest_array, fix_sprint_shortest, ',');                       \
+};)                                                                                               \
+TEST_HELPER(print_array_no_sep, {                                                                 \
+  PRINT_ARRAY_MATCHES(fix_sprint_array, fix_sprint, 0);                                           \
+  PRINT_ARRAY_MATCHES(fix_sprint_shortest_array, fix_sprint_shortest, 0);                         \
+};)                                                                                               \
+TEST_HELPER(print_array_cap, {                                                                    \
+  fixed xs[3];                                                                                    \
+  xs[0] = FIX_NAN;                                                                                \
+  xs[1] = FIX_INF_NEG;                                                                            \
+  xs[2] = FIX_ZERO;                                                                               \
+  char out[3 * FIX_PRINT_BUFFER_SIZE];                                                            \
+  char expected[3 * FIX_PRINT_BUFFER_SIZE];                                                       \
+  char buf[FIX_PRINT_BUFFER_SIZE];                                                                \
+  size_t width = FIX_PRINT_BUFFER_SIZE - 1;                                                       \
+  /* Room for two elements and a separator, but not the third. */                                 \
+  size_t cap = 2 * width + 1 + 1 + width;                                                         \
+  fix_sprint(buf, FIX_NAN);                                                                       \
+  strcpy(expected, buf);                                                                          \
+  strcat(expected, "\n");                                                                         \
+  fix_sprint(buf, FIX_INF_NEG);                                                                   \
+  strcat(expected, buf);                                                                          \
+  CHECK_INT_EQUAL("array count", fix_sprint_array(out, cap, xs, 3, '\n'), 2);                     \
+  if(strcmp(out, expected)) {                                                                     \
+    fail_msg("Strings not equal: '%s' != '%s'", out, expected);                                   \
+  }                                                                                               \
+  CHECK_INT_EQUAL("shortest count", fix_sprint_shortest_array(out, 9, xs, 3, ','), 2);            \
+  if(strcmp(out, "NaN,-Inf")) {                                                                   \
+    fail_msg("Strings not equal: '%s' != '%s'", out, "NaN,-Inf");                                 \
+  }                                                                                               \
+  CHECK_INT_EQUAL("empty count", fix_sprint_array(out, 1, xs, 3, ','), 0);                        \
+  CHECK_INT_EQUAL("empty string", out[0], 0);                                                     \
+  CHECK_INT_EQUAL("no room count", fix_sprint_shortest_array(out, 0, xs, 3, ','), 0);             \
+};)
+
+PRINT_ARRAY_TESTS
+
 //////////////////////////////////////////////////////////////////////////////
 
 
@@ -1130,6 +2470,11 @@ int main(int argc, char** argv) {
     EQ_TESTS
     ROUNDING_TESTS
     FLOOR_CEIL_TESTS
+    ROUND_TESTS
+    INT_ARITH_TESTS
+    FMOD_TESTS
+    SCALE_TESTS
+    PARSE_TESTS
     CONSTANT_TESTS
     CMP_TESTS
     ADD_TESTS
@@ -1144,14 +2489,27 @@ int main(int argc, char** argv) {
     LOG10_TESTS
 
     EXP_TESTS
+    EXPM1_TESTS
+    LOG1P_TESTS
     SQRT_TESTS
+    CBRT_TESTS
+    HYPOT_TESTS
 
     POW_TESTS
 
     //SIN_TESTS
     TRIG_TESTS
+    TRIG_TURNS_TESTS
+
+    ERF_TESTS
+    PPF_TESTS
+    LGAMMA_TESTS
 
     PRINT_TESTS
+    PRINT_EXACT_TESTS
+    PRINT_DIGITS_TESTS
+    PRINT_SHORTEST_TESTS
+    PRINT_ARRAY_TESTS
   };
 
   int i = cmocka_run_group_tests(tests, NULL, NULL);